@@ -19,7 +19,10 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/color.cpp -o sfw/core/color.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/face3.cpp -o sfw/core/face3.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/logger.cpp -o sfw/core/logger.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/math_funcs.cpp -o sfw/core/math_funcs.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/hashfuncs.cpp -o sfw/core/hashfuncs.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/memory.cpp -o sfw/core/memory.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/memory_arena.cpp -o sfw/core/memory_arena.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/memory_profiler.cpp -o sfw/core/memory_profiler.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/pcg.cpp -o sfw/core/pcg.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/plane.cpp -o sfw/core/plane.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/projection.cpp -o sfw/core/projection.o
@@ -31,6 +34,7 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/safe_refcount.cpp -o sfw/core/sa
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/transform_2d.cpp -o sfw/core/transform_2d.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/transform.cpp -o sfw/core/transform.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/ustring.cpp -o sfw/core/ustring.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/utf8_string.cpp -o sfw/core/utf8_string.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/string_name.cpp -o sfw/core/string_name.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/vector2.cpp -o sfw/core/vector2.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/vector2i.cpp -o sfw/core/vector2i.o
@@ -40,6 +44,7 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/vector4.cpp -o sfw/core/vector4.
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/vector4i.cpp -o sfw/core/vector4i.o
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/file_access.cpp -o sfw/core/file_access.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/file_access_mapped.cpp -o sfw/core/file_access_mapped.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/dir_access.cpp -o sfw/core/dir_access.o
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/pool_vector.cpp -o sfw/core/pool_vector.o
@@ -52,9 +57,11 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/string_builder.cpp -o sfw/core/s
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/thread.cpp -o sfw/core/thread.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/socket.cpp -o sfw/core/socket.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/socket_event_loop.cpp -o sfw/core/socket_event_loop.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/inet_address.cpp -o sfw/core/inet_address.o
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/sub_process.cpp -o sfw/core/sub_process.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/worker_pool.cpp -o sfw/core/worker_pool.o
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/core/sfw_core.cpp -o sfw/core/sfw_core.o
 
@@ -64,6 +71,8 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/object.cpp -o sfw/object/objec
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/reference.cpp -o sfw/object/reference.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/core_string_names.cpp -o sfw/object/core_string_names.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/variant.cpp -o sfw/object/variant.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/variant_marshalls.cpp -o sfw/object/variant_marshalls.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/json.cpp -o sfw/object/json.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/variant_op.cpp -o sfw/object/variant_op.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/psignal.cpp -o sfw/object/psignal.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/object/array.cpp -o sfw/object/array.o
@@ -80,6 +89,7 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/material.cpp -o sfw/rende
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/mesh.cpp -o sfw/render_core/mesh.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/mesh_utils.cpp -o sfw/render_core/mesh_utils.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/texture.cpp -o sfw/render_core/texture.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/texture_streamer.cpp -o sfw/render_core/texture_streamer.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/frame_buffer.cpp -o sfw/render_core/frame_buffer.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/image.cpp -o sfw/render_core/image.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/render_state.cpp -o sfw/render_core/render_state.o
@@ -89,6 +99,7 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/input_map.cpp -o sfw/rend
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/input.cpp -o sfw/render_core/input.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/shortcut.cpp -o sfw/render_core/shortcut.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/font.cpp -o sfw/render_core/font.o
+clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/text_layout.cpp -o sfw/render_core/text_layout.o
 
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/color_material_2d.cpp -o sfw/render_core/color_material_2d.o
 clang++ $args -D_REENTRANT -g -Isfw -c sfw/render_core/color_material.cpp -o sfw/render_core/color_material.o
@@ -118,31 +129,42 @@ clang++ $args -D_REENTRANT -g -Isfw -c sfw/main.cpp -o sfw/main.o
 
 clang++ $args -D_REENTRANT -g sfw/core/aabb.o sfw/core/basis.o sfw/core/color.o \
                         sfw/core/face3.o sfw/core/logger.o sfw/core/math_funcs.o \
+                        sfw/core/hashfuncs.o \
                         sfw/core/memory.o sfw/core/pcg.o sfw/core/plane.o sfw/core/projection.o sfw/core/quaternion.o sfw/core/random_pcg.o \
+                        sfw/core/memory_arena.o \
+                        sfw/core/memory_profiler.o \
                         sfw/core/rect2.o sfw/core/rect2i.o sfw/core/safe_refcount.o sfw/core/transform_2d.o sfw/core/transform.o \
                         sfw/core/ustring.o sfw/core/string_name.o \
+                        sfw/core/utf8_string.o \
                         sfw/core/rw_lock.o sfw/core/semaphore.o \
                         sfw/core/vector2.o sfw/core/vector2i.o sfw/core/vector3.o \
                         sfw/core/vector3i.o sfw/core/vector4.o sfw/core/vector4i.o \
                         sfw/core/pool_vector.o sfw/core/pool_allocator.o sfw/core/mutex.o sfw/core/sfw_time.o \
 												sfw/core/string_builder.o \
                         sfw/core/dir_access.o sfw/core/file_access.o sfw/core/thread.o \
+                        sfw/core/file_access_mapped.o \
                         sfw/core/socket.o sfw/core/inet_address.o \
+                        sfw/core/socket_event_loop.o \
                         sfw/core/sub_process.o \
+                        sfw/core/worker_pool.o \
                         sfw/core/sfw_core.o \
                         sfw/core/os.o \
                         sfw/object/object.o sfw/object/reference.o sfw/object/core_string_names.o \
                         sfw/object/variant.o sfw/object/variant_op.o sfw/object/psignal.o \
+                        sfw/object/variant_marshalls.o \
+                        sfw/object/json.o \
                         sfw/object/array.o sfw/object/dictionary.o sfw/object/ref_ptr.o \
                         sfw/object/resource.o \
                         sfw/render_core/image.o sfw/render_core/render_state.o \
                         sfw/render_core/application.o sfw/render_core/scene.o sfw/render_core/app_window.o \
                         sfw/render_core/shader.o sfw/render_core/material.o sfw/render_core/mesh.o \
                         sfw/render_core/mesh_utils.o sfw/render_core/texture.o \
+                        sfw/render_core/texture_streamer.o \
                         sfw/render_core/frame_buffer.o \
                         sfw/render_core/input_event.o sfw/render_core/input_map.o \
                         sfw/render_core/input.o sfw/render_core/shortcut.o \
                         sfw/render_core/keyboard.o sfw/render_core/font.o \
+                        sfw/render_core/text_layout.o \
                         sfw/render_core/color_material_2d.o sfw/render_core/color_material.o \
                         sfw/render_core/colored_material.o sfw/render_core/font_material.o \
                         sfw/render_core/texture_material_2d.o sfw/render_core/texture_material.o \
@@ -2,16 +2,21 @@
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/color.cpp -o sfwl/core/color.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/logger.cpp -o sfwl/core/logger.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/math_funcs.cpp -o sfwl/core/math_funcs.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/hashfuncs.cpp -o sfwl/core/hashfuncs.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/memory.cpp -o sfwl/core/memory.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/memory_arena.cpp -o sfwl/core/memory_arena.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/memory_profiler.cpp -o sfwl/core/memory_profiler.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/pcg.cpp -o sfwl/core/pcg.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/random_pcg.cpp -o sfwl/core/random_pcg.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/rect2i.cpp -o sfwl/core/rect2i.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/safe_refcount.cpp -o sfwl/core/safe_refcount.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/ustring.cpp -o sfwl/core/ustring.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/utf8_string.cpp -o sfwl/core/utf8_string.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/string_name.cpp -o sfwl/core/string_name.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/vector2i.cpp -o sfwl/core/vector2i.o
 
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/file_access.cpp -o sfwl/core/file_access.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/file_access_mapped.cpp -o sfwl/core/file_access_mapped.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/dir_access.cpp -o sfwl/core/dir_access.o
 
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/pool_vector.cpp -o sfwl/core/pool_vector.o
@@ -24,9 +29,11 @@ clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/string_builder.cpp -o sfw
 
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/thread.cpp -o sfwl/core/thread.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/socket.cpp -o sfwl/core/socket.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/socket_event_loop.cpp -o sfwl/core/socket_event_loop.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/inet_address.cpp -o sfwl/core/inet_address.o
 
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/sub_process.cpp -o sfwl/core/sub_process.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/worker_pool.cpp -o sfwl/core/worker_pool.o
 
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/core/sfw_core.cpp -o sfwl/core/sfw_core.o
 
@@ -36,6 +43,8 @@ clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/object.cpp -o sfwl/obje
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/reference.cpp -o sfwl/object/reference.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/core_string_names.cpp -o sfwl/object/core_string_names.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/variant.cpp -o sfwl/object/variant.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/variant_marshalls.cpp -o sfwl/object/variant_marshalls.o
+clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/json.cpp -o sfwl/object/json.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/variant_op.cpp -o sfwl/object/variant_op.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/psignal.cpp -o sfwl/object/psignal.o
 clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/object/array.cpp -o sfwl/object/array.o
@@ -49,20 +58,29 @@ clang++ -std=c++14 -D_REENTRANT -g -Isfwl -c sfwl/main.cpp -o sfwl/main.o
 
 clang++ -std=c++14 -D_REENTRANT -g sfwl/core/color.o \
                         sfwl/core/logger.o sfwl/core/math_funcs.o \
+                        sfwl/core/hashfuncs.o \
                         sfwl/core/memory.o sfwl/core/pcg.o sfwl/core/random_pcg.o \
+                        sfwl/core/memory_arena.o \
+                        sfwl/core/memory_profiler.o \
                         sfwl/core/rect2i.o sfwl/core/safe_refcount.o \
                         sfwl/core/ustring.o sfwl/core/string_name.o \
+                        sfwl/core/utf8_string.o \
                         sfwl/core/vector2i.o \
                         sfwl/core/pool_vector.o sfwl/core/pool_allocator.o sfwl/core/mutex.o sfwl/core/sfw_time.o \
 												sfwl/core/rw_lock.o sfwl/core/semaphore.o \
 												sfwl/core/string_builder.o \
                         sfwl/core/dir_access.o sfwl/core/file_access.o sfwl/core/thread.o \
+                        sfwl/core/file_access_mapped.o \
                         sfwl/core/socket.o sfwl/core/inet_address.o \
+                        sfwl/core/socket_event_loop.o \
                         sfwl/core/sub_process.o \
+                        sfwl/core/worker_pool.o \
                         sfwl/core/sfw_core.o \
                         sfwl/core/os.o \
                         sfwl/object/object.o sfwl/object/reference.o sfwl/object/core_string_names.o \
                         sfwl/object/variant.o sfwl/object/variant_op.o sfwl/object/psignal.o \
+                        sfwl/object/variant_marshalls.o \
+                        sfwl/object/json.o \
                         sfwl/object/array.o sfwl/object/dictionary.o sfwl/object/ref_ptr.o \
                         sfwl/object/resource.o \
                         sfwl/main.o \
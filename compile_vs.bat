@@ -14,7 +14,10 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/color.cpp /Fo:sfw/core/color.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/face3.cpp /Fo:sfw/core/face3.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/logger.cpp /Fo:sfw/core/logger.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/math_funcs.cpp /Fo:sfw/core/math_funcs.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/hashfuncs.cpp /Fo:sfw/core/hashfuncs.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/memory.cpp /Fo:sfw/core/memory.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/memory_arena.cpp /Fo:sfw/core/memory_arena.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/memory_profiler.cpp /Fo:sfw/core/memory_profiler.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/pcg.cpp /Fo:sfw/core/pcg.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/plane.cpp /Fo:sfw/core/plane.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/projection.cpp /Fo:sfw/core/projection.obj
@@ -26,6 +29,7 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/safe_refcount.cpp /Fo:sfw/core/safe_
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/transform_2d.cpp /Fo:sfw/core/transform_2d.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/transform.cpp /Fo:sfw/core/transform.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/ustring.cpp /Fo:sfw/core/ustring.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/utf8_string.cpp /Fo:sfw/core/utf8_string.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/string_name.cpp /Fo:sfw/core/string_name.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/vector2.cpp /Fo:sfw/core/vector2.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/vector2i.cpp /Fo:sfw/core/vector2i.obj
@@ -35,6 +39,7 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/vector4.cpp /Fo:sfw/core/vector4.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/vector4i.cpp /Fo:sfw/core/vector4i.obj
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/file_access.cpp /Fo:sfw/core/file_access.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/file_access_mapped.cpp /Fo:sfw/core/file_access_mapped.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/dir_access.cpp /Fo:sfw/core/dir_access.obj
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/pool_vector.cpp /Fo:sfw/core/pool_vector.obj
@@ -47,9 +52,11 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/string_builder.cpp /Fo:sfw/core/stri
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/thread.cpp /Fo:sfw/core/thread.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/socket.cpp /Fo:sfw/core/socket.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/socket_event_loop.cpp /Fo:sfw/core/socket_event_loop.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/inet_address.cpp /Fo:sfw/core/inet_address.obj
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/sub_process.cpp /Fo:sfw/core/sub_process.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/worker_pool.cpp /Fo:sfw/core/worker_pool.obj
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/core/sfw_core.cpp /Fo:sfw/core/sfw_core.obj
 
@@ -59,6 +66,8 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/object.cpp /Fo:sfw/object/object.o
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/reference.cpp /Fo:sfw/object/reference.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/core_string_names.cpp /Fo:sfw/object/core_string_names.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/variant.cpp /Fo:sfw/object/variant.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/variant_marshalls.cpp /Fo:sfw/object/variant_marshalls.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/json.cpp /Fo:sfw/object/json.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/variant_op.cpp /Fo:sfw/object/variant_op.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/psignal.cpp /Fo:sfw/object/psignal.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/object/array.cpp /Fo:sfw/object/array.obj
@@ -77,6 +86,7 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/material.cpp /Fo:sfw/render_c
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/mesh.cpp /Fo:sfw/render_core/mesh.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/mesh_utils.cpp /Fo:sfw/render_core/mesh_utils.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/texture.cpp /Fo:sfw/render_core/texture.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/texture_streamer.cpp /Fo:sfw/render_core/texture_streamer.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/frame_buffer.cpp /Fo:sfw/render_core/frame_buffer.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/image.cpp /Fo:sfw/render_core/image.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/render_state.cpp /Fo:sfw/render_core/render_state.obj
@@ -86,6 +96,7 @@ cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/input_map.cpp /Fo:sfw/render_
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/input.cpp /Fo:sfw/render_core/input.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/shortcut.cpp /Fo:sfw/render_core/shortcut.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/font.cpp /Fo:sfw/render_core/font.obj
+cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/text_layout.cpp /Fo:sfw/render_core/text_layout.obj
 
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/color_material_2d.cpp /Fo:sfw/render_core/color_material_2d.obj
 cl /D_REENTRANT /EHsc /Zi /Isfw /c sfw/render_core/color_material.cpp /Fo:sfw/render_core/color_material.obj
@@ -115,31 +126,42 @@ cl /D_REENTRANT /Zi ^
 		/Fegame-vc.exe ^
 		sfw/core/aabb.obj sfw/core/basis.obj sfw/core/color.obj ^
 		sfw/core/face3.obj sfw/core/logger.obj sfw/core/math_funcs.obj ^
+		sfw/core/hashfuncs.obj ^
 		sfw/core/memory.obj sfw/core/pcg.obj sfw/core/plane.obj sfw/core/projection.obj sfw/core/quaternion.obj sfw/core/random_pcg.obj ^
+		sfw/core/memory_arena.obj ^
+		sfw/core/memory_profiler.obj ^
 		sfw/core/rect2.obj sfw/core/rect2i.obj sfw/core/safe_refcount.obj sfw/core/transform_2d.obj sfw/core/transform.obj ^
 		sfw/core/ustring.obj sfw/core/string_name.obj ^
+		sfw/core/utf8_string.obj ^
 		sfw/core/vector2.obj sfw/core/vector2i.obj sfw/core/vector3.obj ^
 		sfw/core/vector3i.obj sfw/core/vector4.obj sfw/core/vector4i.obj ^
 		sfw/core/pool_vector.obj sfw/core/pool_allocator.obj sfw/core/mutex.obj sfw/core/sfw_time.obj ^
 		sfw/core/string_builder.obj ^
 		sfw/core/rw_lock.obj sfw/core/semaphore.obj ^
 		sfw/core/dir_access.obj sfw/core/file_access.obj sfw/core/thread.obj ^
+		sfw/core/file_access_mapped.obj ^
 		sfw/core/socket.obj sfw/core/inet_address.obj ^
+		sfw/core/socket_event_loop.obj ^
 		sfw/core/sub_process.obj ^
+		sfw/core/worker_pool.obj ^
 		sfw/core/sfw_core.obj ^
 		sfw/core/os.obj ^
 		sfw/object/object.obj sfw/object/reference.obj sfw/object/core_string_names.obj ^
 		sfw/object/variant.obj sfw/object/variant_op.obj sfw/object/psignal.obj ^
+		sfw/object/variant_marshalls.obj ^
+		sfw/object/json.obj ^
 		sfw/object/array.obj sfw/object/dictionary.obj sfw/object/ref_ptr.obj ^
 		sfw/object/resource.obj ^
 		sfw/render_core/image.obj sfw/render_core/render_state.obj ^
 		sfw/render_core/application.obj sfw/render_core/scene.obj sfw/render_core/app_window.obj ^
 		sfw/render_core/shader.obj sfw/render_core/material.obj sfw/render_core/mesh.obj ^
 		sfw/render_core/mesh_utils.obj sfw/render_core/texture.obj ^
+		sfw/render_core/texture_streamer.obj ^
 		sfw/render_core/frame_buffer.obj ^
 		sfw/render_core/input_event.obj sfw/render_core/input_map.obj ^
 		sfw/render_core/input.obj sfw/render_core/shortcut.obj ^
 		sfw/render_core/keyboard.obj sfw/render_core/font.obj ^
+		sfw/render_core/text_layout.obj ^
 		sfw/render_core/color_material_2d.obj sfw/render_core/color_material.obj ^
 		sfw/render_core/colored_material.obj sfw/render_core/font_material.obj ^
 		sfw/render_core/texture_material_2d.obj sfw/render_core/texture_material.obj ^
@@ -0,0 +1,44 @@
+#include "sfwl.h"
+
+// StringNames are interned in a global table that outlives any MemoryArenaScope.
+// A name made from a String that was built inside a redirecting scope has to stay valid
+// after the scope ended, and after the arena got reused by another one.
+
+int main(int argc, char **argv) {
+	SFWCore::setup();
+
+	StringName *sn = memnew(StringName);
+
+	{
+		MemoryArenaScope scope(true);
+
+		String s = "arena_string_name_";
+		s += itos(12345);
+
+		*sn = StringName(s);
+	}
+
+	{
+		// Overwrites what the first scope used
+		MemoryArenaScope scope(true);
+
+		for (int i = 0; i < 1000; ++i) {
+			String junk = String("ZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ") + itos(i);
+		}
+	}
+
+	String name = *sn;
+	bool interned = StringName("arena_string_name_12345") == *sn;
+
+	if (name == "arena_string_name_12345" && interned) {
+		ERR_PRINT("OK: " + name);
+	} else {
+		ERR_PRINT("StringName got corrupted by the arena! Read back: " + name);
+	}
+
+	memdelete(sn);
+
+	SFWCore::cleanup();
+
+	return 0;
+}
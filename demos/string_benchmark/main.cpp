@@ -0,0 +1,102 @@
+
+#include "sfwl.h"
+
+// Throughput of the UTF-8 conversions of String, on large mostly-ASCII inputs (source code, logs, json)
+// and on inputs that are mostly not ASCII, where the block fast paths can't help.
+// x86 builds use the SSE2 paths, add -mavx2 to the compile flags to measure the AVX2 ones.
+
+static CharString make_text(int p_size, int p_non_ascii_every) {
+	// 2 byte (é), 3 byte (€) and 4 byte (𝄞) sequences
+	static const char *non_ascii[3] = { "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9D\x84\x9E" };
+	static const char *words[8] = { "return ", "value", " = ", "index", "(data);", "\n", "\t", "// comment " };
+
+	CharString text;
+	text.resize(p_size + 1);
+	char *w = text.ptrw();
+
+	int pos = 0;
+	uint32_t seed = 12345;
+
+	while (pos < p_size - 4) {
+		seed = seed * 1664525u + 1013904223u;
+
+		const char *piece;
+
+		if (p_non_ascii_every > 0 && (seed >> 8) % p_non_ascii_every == 0) {
+			piece = non_ascii[(seed >> 4) % 3];
+		} else {
+			piece = words[(seed >> 4) % 8];
+		}
+
+		int len = strlen(piece);
+
+		if (pos + len > p_size) {
+			break;
+		}
+
+		memcpy(w + pos, piece, len);
+		pos += len;
+	}
+
+	text.resize(pos + 1);
+	text.ptrw()[pos] = 0;
+
+	return text;
+}
+
+static void benchmark(const char *p_name, const CharString &p_text, int p_rounds) {
+	int size = p_text.length();
+	double mb = (double)size * p_rounds / (1024.0 * 1024.0);
+
+	String s;
+
+	uint64_t start = SFWTime::time_us();
+
+	for (int i = 0; i < p_rounds; ++i) {
+		s.parse_utf8(p_text.get_data(), size);
+	}
+
+	double parse_secs = (SFWTime::time_us() - start) / 1000000.0;
+
+	start = SFWTime::time_us();
+
+	int length = 0;
+	for (int i = 0; i < p_rounds; ++i) {
+		length += s.utf8().length();
+	}
+
+	double utf8_secs = (SFWTime::time_us() - start) / 1000000.0;
+
+	start = SFWTime::time_us();
+
+	for (int i = 0; i < p_rounds; ++i) {
+		length += s.utf8_byte_length();
+	}
+
+	double byte_length_secs = (SFWTime::time_us() - start) / 1000000.0;
+
+	ERR_PRINT(String(p_name) + " (" + itos(size / 1024) + " KB)");
+	ERR_PRINT("  parse_utf8:       " + String::num(mb / parse_secs, 1) + " MB/s");
+	ERR_PRINT("  utf8:             " + String::num(mb / utf8_secs, 1) + " MB/s");
+	ERR_PRINT("  utf8_byte_length: " + String::num(mb / byte_length_secs, 1) + " MB/s");
+
+	// Round trip check, and keeps the results used
+	if (length != size * p_rounds * 2 || strcmp(s.utf8().get_data(), p_text.get_data()) != 0) {
+		ERR_PRINT("  Round trip mismatch!");
+	}
+}
+
+int main(int argc, char **argv) {
+	SFWCore::setup();
+
+	const int size = 8 * 1024 * 1024;
+
+	benchmark("ASCII only", make_text(size, 0), 16);
+	benchmark("1 in 200 non ASCII", make_text(size, 200), 16);
+	benchmark("1 in 20 non ASCII", make_text(size, 20), 16);
+	benchmark("1 in 2 non ASCII", make_text(size, 2), 16);
+
+	SFWCore::cleanup();
+
+	return 0;
+}
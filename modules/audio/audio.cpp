@@ -82,7 +82,8 @@ struct AudioServerStream : public AudioServerSample {
 	bool rewind;
 	bool loop;
 
-	Vector<uint8_t> vdata;
+	// The decoders read from the mapping while playing
+	FileAccessMapped *file;
 
 	void reset() {
 		memset(data, 0, sizeof(data));
@@ -97,6 +98,8 @@ struct AudioServerStream : public AudioServerSample {
 		rewind = false;
 		loop = false;
 
+		file = NULL;
+
 		// Make sure the pointer types are NULL
 		ogg = NULL;
 		memset(&stream, 0, sizeof(sts_mixer_stream_t));
@@ -110,6 +113,10 @@ struct AudioServerStream : public AudioServerSample {
 		} else if (type == MP3) {
 			ma_dr_mp3_uninit(&mp3_);
 		}
+
+		if (file) {
+			memdelete(file);
+		}
 	}
 };
 
@@ -186,23 +193,16 @@ static void reset_stream(AudioServerStream *stream) {
 
 // load a (stereo) stream
 static bool load_audio_stream(AudioServerStream *stream, const String &filename) {
-	FileAccess *fa = FileAccess::create_and_open(filename, FileAccess::READ);
+	stream->file = FileAccess::create_mapped(filename);
 
-	if (!fa) {
+	if (!stream->file) {
 		return false;
 	}
 
-	stream->vdata.resize(fa->get_len());
-
-	uint64_t read_len = fa->get_buffer(stream->vdata.ptrw(), stream->vdata.size());
-
-	if (read_len != fa->get_len()) {
-		ERR_PRINT("read_len != fa->get_len()?");
-		return false;
-	}
+	ERR_FAIL_COND_V_MSG(stream->file->get_size() > INT32_MAX, false, "Audio file is too big! " + filename);
 
-	int datalen = stream->vdata.size();
-	const char *data = (const char *)stream->vdata.ptr();
+	int datalen = stream->file->get_size();
+	const char *data = (const char *)stream->file->get_data();
 
 	if (!data) {
 		return false;
@@ -259,17 +259,7 @@ end:;
 }
 
 // load a (mono) sample
-static bool load_sample(sts_mixer_sample_t *sample, const String &filename) {
-	Error err;
-	Vector<uint8_t> vdata = FileAccess::get_file_as_array(filename, &err);
-
-	if (err != OK) {
-		return false;
-	}
-
-	int datalen = vdata.size();
-	const char *data = (const char *)vdata.ptr();
-
+static bool load_sample_from_memory(sts_mixer_sample_t *sample, const char *data, int datalen) {
 	if (!data) {
 		return false;
 	}
@@ -345,6 +335,26 @@ static bool load_sample(sts_mixer_sample_t *sample, const String &filename) {
 	return true;
 }
 
+static bool load_sample(sts_mixer_sample_t *sample, const String &filename) {
+	// The samples are decoded directly from the mapping, the file is not needed afterwards.
+	FileAccessMapped *f = FileAccess::create_mapped(filename);
+
+	if (!f) {
+		return false;
+	}
+
+	if (f->get_size() > INT32_MAX) {
+		memdelete(f);
+		ERR_FAIL_V_MSG(false, "Audio file is too big! " + filename);
+	}
+
+	bool ret = load_sample_from_memory(sample, (const char *)f->get_data(), f->get_size());
+
+	memdelete(f);
+
+	return ret;
+}
+
 // -----------------------------------------------------------------------------
 
 static ma_device device;
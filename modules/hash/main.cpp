@@ -3,6 +3,24 @@
 
 #include "sfw_hash.h"
 
+static void benchmark(const char *p_name, SFWHash::HashFunc p_func, const uint8_t *p_data, int p_size, int p_rounds) {
+	SFWHash h;
+	h.init(p_func);
+
+	uint64_t start = SFWTime::time_us();
+
+	for (int i = 0; i < p_rounds; ++i) {
+		h.reset();
+		h.hash_buffer(p_data, p_size);
+		h.finalize();
+	}
+
+	double secs = (SFWTime::time_us() - start) / 1000000.0;
+	double mbs = (double)p_size * p_rounds / (1024.0 * 1024.0) / secs;
+
+	ERR_PRINT(String(p_name) + ": " + String::num(mbs, 1) + " MB/s  " + h.get_hash());
+}
+
 int main(int argc, char **argv) {
 	SFWCore::setup();
 
@@ -70,6 +88,52 @@ int main(int argc, char **argv) {
 	h.hash_string(test);
 	ERR_PRINT(h.get_hash());
 
+	ERR_PRINT("Batch SHA3_256");
+	Vector<String> strings;
+	strings.push_back(test);
+	strings.push_back(test + test);
+
+	Vector<String> hashes = SFWHash::hash_strings(SFWHash::HASH_SHA3_256, strings);
+
+	for (int i = 0; i < hashes.size(); ++i) {
+		ERR_PRINT(hashes[i]);
+	}
+
+	ERR_PRINT("XXH3_64");
+	h.init(SFWHash::HASH_XXH3_64);
+	h.hash_string(test);
+	ERR_PRINT(h.get_hash());
+
+	ERR_PRINT("XXH3_128");
+	h.init(SFWHash::HASH_XXH3_128);
+	h.hash_string(test);
+	ERR_PRINT(h.get_hash());
+
+	// Throughput
+	const int size = 16 * 1024 * 1024;
+	Vector<uint8_t> data;
+	data.resize(size);
+
+	uint8_t *w = data.ptrw();
+	for (int i = 0; i < size; ++i) {
+		w[i] = (uint8_t)((i * 2654435761u) >> 13);
+	}
+
+	ERR_PRINT("Throughput, 16 MB buffer");
+	benchmark("MD5", SFWHash::HASH_MD5, data.ptr(), size, 4);
+	benchmark("SHA1", SFWHash::HASH_SHA1, data.ptr(), size, 4);
+	benchmark("SHA3_256", SFWHash::HASH_SHA3_256, data.ptr(), size, 4);
+	benchmark("SHA3_512", SFWHash::HASH_SHA3_512, data.ptr(), size, 4);
+
+	hash_xxh3_set_implementation(HASH_XXH3_IMPLEMENTATION_SCALAR);
+	benchmark("XXH3_64 scalar", SFWHash::HASH_XXH3_64, data.ptr(), size, 32);
+	hash_xxh3_set_implementation(HASH_XXH3_IMPLEMENTATION_SSE2);
+	benchmark("XXH3_64 sse2", SFWHash::HASH_XXH3_64, data.ptr(), size, 32);
+	hash_xxh3_set_implementation(HASH_XXH3_IMPLEMENTATION_AVX2);
+	benchmark("XXH3_64 avx2", SFWHash::HASH_XXH3_64, data.ptr(), size, 32);
+	hash_xxh3_set_implementation(HASH_XXH3_IMPLEMENTATION_AUTO);
+	benchmark("XXH3_128", SFWHash::HASH_XXH3_128, data.ptr(), size, 32);
+
 	SFWCore::cleanup();
 
 	return 0;
@@ -23,9 +23,31 @@ int SFWHash::get_hash_length() {
 void SFWHash::hash_string(const String &p_str) {
 	ERR_FAIL_COND(!is_initialized());
 
-	Vector<uint8_t> buf = p_str.to_utf8_buffer();
+	int l = p_str.length();
 
-	hash_buffer(buf.ptr(), buf.size());
+	if (l == 0) {
+		return;
+	}
+
+	// Same bytes as String::utf8(), without the temporary CharString.
+	uint8_t buf[HASH_STRING_CHUNK_SIZE];
+	uint8_t *dst = buf;
+	uint8_t *const dst_end = buf + HASH_STRING_CHUNK_SIZE - 6;
+
+	const CharType *d = p_str.ptr();
+
+	for (int i = 0; i < l; ++i) {
+		if (dst > dst_end) {
+			hash_buffer(buf, dst - buf);
+			dst = buf;
+		}
+
+		dst += String::utf8_encode_char(d[i], (char *)dst);
+	}
+
+	if (dst != buf) {
+		hash_buffer(buf, dst - buf);
+	}
 }
 void SFWHash::hash_buffer(const uint8_t *p_buffer, const int p_length) {
 	ERR_FAIL_COND(!is_initialized());
@@ -43,7 +65,64 @@ void SFWHash::hash_buffer(const uint8_t *p_buffer, const int p_length) {
 		case HASH_MD5:
 			md5_write(&_md5_context, p_buffer, p_length);
 			break;
+		case HASH_XXH3_64:
+		case HASH_XXH3_128:
+			hash_xxh3_update(&_xxh3_context, p_buffer, p_length);
+			break;
+	}
+}
+
+Error SFWHash::hash_file(const String &p_path) {
+	ERR_FAIL_COND_V(!is_initialized(), ERR_UNCONFIGURED);
+
+	Error err;
+	FileAccess *f = FileAccess::create_and_open(p_path, FileAccess::READ, &err);
+
+	if (!f) {
+		return err != OK ? err : ERR_CANT_OPEN;
+	}
+
+	err = hash_file(f);
+
+	memdelete(f);
+
+	return err;
+}
+
+Error SFWHash::hash_file(FileAccess *p_file) {
+	ERR_FAIL_COND_V(!is_initialized(), ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+
+	uint8_t *buf = (uint8_t *)memalloc(HASH_FILE_BUFFER_SIZE);
+	ERR_FAIL_COND_V(!buf, ERR_OUT_OF_MEMORY);
+
+	// Every read is at least as big as the buffer, so the FileAccess's own read buffer is not needed while hashing.
+	uint32_t read_buffer_size = p_file->get_read_buffer_size();
+	p_file->set_read_buffer_size(0);
+
+	while (true) {
+		uint64_t r = p_file->get_buffer(buf, HASH_FILE_BUFFER_SIZE);
+
+		if (r > 0) {
+			hash_buffer(buf, r);
+		}
+
+		if (r < HASH_FILE_BUFFER_SIZE) {
+			break;
+		}
+	}
+
+	memfree(buf);
+
+	Error err = p_file->get_error();
+
+	p_file->set_read_buffer_size(read_buffer_size);
+
+	if (err == ERR_FILE_EOF) {
+		return OK;
 	}
+
+	return err;
 }
 
 void SFWHash::finalize() {
@@ -66,7 +145,18 @@ void SFWHash::finalize() {
 		case HASH_MD5:
 			md5_finish(&_md5_context, _out);
 			break;
+		case HASH_XXH3_64:
+			// Canonical form, big endian like the reference implementation prints it.
+			encode_uint64(BSWAP64(hash_xxh3_digest_64(&_xxh3_context)), _out);
+			break;
+		case HASH_XXH3_128: {
+			HashXXH3_128 h = hash_xxh3_digest_128(&_xxh3_context);
+			encode_uint64(BSWAP64(h.high64), _out);
+			encode_uint64(BSWAP64(h.low64), _out + 8);
+		} break;
 	}
+
+	_finalized = true;
 }
 
 void SFWHash::reset() {
@@ -99,6 +189,10 @@ void SFWHash::reset() {
 		case HASH_MD5:
 			md5_init(&_md5_context);
 			break;
+		case HASH_XXH3_64:
+		case HASH_XXH3_128:
+			hash_xxh3_reset(&_xxh3_context);
+			break;
 		default:
 			memdelete_arr(_out);
 			_out = NULL;
@@ -114,12 +208,132 @@ String SFWHash::get_hash() {
 	return String::hex_encode_buffer(_out, get_hash_length());
 }
 
+Vector<String> SFWHash::hash_buffers(HashFunc p_func, const uint8_t *const *p_buffers, const int *p_lengths, int p_count) {
+	Vector<String> ret;
+
+	ERR_FAIL_COND_V(p_count < 0, ret);
+
+	if (p_count == 0) {
+		return ret;
+	}
+
+	ERR_FAIL_COND_V(!p_buffers, ret);
+	ERR_FAIL_COND_V(!p_lengths, ret);
+
+	ret.resize(p_count);
+
+	BatchData data;
+	data.func = p_func;
+	data.buffers = p_buffers;
+	data.lengths = p_lengths;
+	data.strings = NULL;
+	data.results = ret.ptrw();
+
+	WorkerPool::get_singleton()->parallel_for(0, p_count, _hash_buffers_range, &data, 1);
+
+	return ret;
+}
+
+Vector<String> SFWHash::hash_strings(HashFunc p_func, const Vector<String> &p_strings) {
+	Vector<String> ret;
+
+	if (p_strings.size() == 0) {
+		return ret;
+	}
+
+	ret.resize(p_strings.size());
+
+	BatchData data;
+	data.func = p_func;
+	data.buffers = NULL;
+	data.lengths = NULL;
+	data.strings = p_strings.ptr();
+	data.results = ret.ptrw();
+
+	WorkerPool::get_singleton()->parallel_for(0, p_strings.size(), _hash_strings_range, &data, 1);
+
+	return ret;
+}
+
+Vector<String> SFWHash::hash_files(HashFunc p_func, const Vector<String> &p_paths) {
+	Vector<String> ret;
+
+	if (p_paths.size() == 0) {
+		return ret;
+	}
+
+	ret.resize(p_paths.size());
+
+	BatchData data;
+	data.func = p_func;
+	data.buffers = NULL;
+	data.lengths = NULL;
+	data.strings = p_paths.ptr();
+	data.results = ret.ptrw();
+
+	WorkerPool::get_singleton()->parallel_for(0, p_paths.size(), _hash_files_range, &data, 1);
+
+	return ret;
+}
+
 SFWHash::SFWHash() {
 	_out = NULL;
 	_finalized = true;
 	_hash_func = HASH_MD5;
 }
 SFWHash::~SFWHash() {
+	if (_out) {
+		memdelete_arr(_out);
+	}
+}
+
+void SFWHash::_hash_buffers_range(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	BatchData *data = (BatchData *)p_userdata;
+
+	SFWHash h;
+	h.init(data->func);
+
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		if (i != p_from) {
+			h.reset();
+		}
+
+		h.hash_buffer(data->buffers[i], data->lengths[i]);
+		data->results[i] = h.get_hash();
+	}
+}
+
+void SFWHash::_hash_strings_range(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	BatchData *data = (BatchData *)p_userdata;
+
+	SFWHash h;
+	h.init(data->func);
+
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		if (i != p_from) {
+			h.reset();
+		}
+
+		h.hash_string(data->strings[i]);
+		data->results[i] = h.get_hash();
+	}
+}
+
+void SFWHash::_hash_files_range(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	BatchData *data = (BatchData *)p_userdata;
+
+	SFWHash h;
+	h.init(data->func);
+
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		if (i != p_from) {
+			h.reset();
+		}
+
+		if (h.hash_file(data->strings[i]) == OK) {
+			data->results[i] = h.get_hash();
+		}
+	}
 }
 
 // ########
@@ -138,6 +352,10 @@ int SFWHash::_hash_length(HashFunc alg) {
 			return 512 / 8;
 		case HASH_MD5:
 			return 16;
+		case HASH_XXH3_64:
+			return 8;
+		case HASH_XXH3_128:
+			return 16;
 		default:
 			return 0;
 	}
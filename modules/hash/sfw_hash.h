@@ -29,6 +29,9 @@ public:
 		HASH_SHA3_256 = 0x16,
 		HASH_SHA3_224 = 0x17,
 		HASH_MD5 = 0xD5,
+		// Non-cryptographic, much faster. Don't use them where collisions can be forced on purpose.
+		HASH_XXH3_64 = 0xE3,
+		HASH_XXH3_128 = 0xE4,
 	};
 
 	void init(HashFunc p_func);
@@ -38,18 +41,47 @@ public:
 
 	int get_hash_length();
 
+	// The String is encoded to UTF-8 in small chunks on the stack, so no temporary buffer is allocated.
 	void hash_string(const String &p_str);
 	void hash_buffer(const uint8_t *p_buffer, const int p_length);
 
+	// Streams the file's contents through a fixed size buffer, big files are never loaded at once.
+	Error hash_file(const String &p_path);
+	Error hash_file(FileAccess *p_file);
+
 	void finalize();
 	void reset();
 
 	String get_hash();
 
+	// Batch hashing. Every input gets its own context, and the inputs are hashed in parallel
+	// on the WorkerPool. The hex digests are returned in the same order as the inputs.
+	static Vector<String> hash_buffers(HashFunc p_func, const uint8_t *const *p_buffers, const int *p_lengths, int p_count);
+	static Vector<String> hash_strings(HashFunc p_func, const Vector<String> &p_strings);
+	// Files that couldn't be read get an empty String.
+	static Vector<String> hash_files(HashFunc p_func, const Vector<String> &p_paths);
+
 	SFWHash();
 	~SFWHash();
 
 protected:
+	enum {
+		HASH_STRING_CHUNK_SIZE = 1024,
+		HASH_FILE_BUFFER_SIZE = 65536,
+	};
+
+	struct BatchData {
+		HashFunc func;
+		const uint8_t *const *buffers;
+		const int *lengths;
+		const String *strings;
+		String *results;
+	};
+
+	static void _hash_buffers_range(void *p_userdata, uint32_t p_from, uint32_t p_to);
+	static void _hash_strings_range(void *p_userdata, uint32_t p_from, uint32_t p_to);
+	static void _hash_files_range(void *p_userdata, uint32_t p_from, uint32_t p_to);
+
 	// Tell the length (in bytes) of the hash of the specified algorithm. If
 	// it is not implemented, then the result is zero.
 	static int _hash_length(HashFunc alg);
@@ -117,6 +149,7 @@ protected:
 		SHA1Context _sha1_context;
 		SHA3Context _sha3_context;
 		MD5Context _md5_context;
+		HashXXH3State _xxh3_context;
 	};
 
 	bool _finalized;
@@ -240,9 +240,9 @@ public:
 		for (int x = 0; x < tile_map->size_x; ++x) {
 			for (int y = 0; y < tile_map->size_y; ++y) {
 				if (x == 0 || y == 0 || x == tile_map->size_x - 1 || y == tile_map->size_y - 1) {
-					tile_map->set_data(x, y, 2);
+					tile_map->set_data(x, y, 3);
 				} else {
-					tile_map->set_data(x, y, 1);
+					tile_map->set_data(x, y, 2);
 				}
 			}
 		}
@@ -36,6 +36,7 @@
 //#include "render_core/font.h"
 //#include "render_core/font_material.h"
 //#include "render_core/mesh.h"
+//#include "render_core/text_layout.h"
 //#include "render_objects/camera_2d.h"
 //--STRIP
 {{FILE:modules/render_objects/text_2d.cpp}}
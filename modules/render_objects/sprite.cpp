@@ -62,6 +62,7 @@ void Sprite::update_mesh() {
 Sprite::Sprite() {
 	mesh_instance = memnew(MeshInstance2D());
 	mesh_instance->mesh = Ref<Mesh>(memnew(Mesh(2)));
+	mesh_instance->mesh->set_buffer_usage(Mesh::BUFFER_USAGE_DYNAMIC);
 
 	width = 1;
 	height = 1;
@@ -4,6 +4,7 @@
 #include "render_core/font.h"
 #include "render_core/font_material.h"
 #include "render_core/mesh.h"
+#include "render_core/text_layout.h"
 #include "render_objects/camera_2d.h"
 //--STRIP
 
@@ -11,14 +12,19 @@ Color Text2D::get_text_color() const {
 	return _text_color;
 }
 void Text2D::set_text_color(const Color &p_color) {
+	if (_text_color == p_color) {
+		return;
+	}
+
 	_text_color = p_color;
+	_mesh_dirty = true;
 }
 
 String Text2D::get_text() const {
-	return _text;
+	return _layout->get_text();
 }
 void Text2D::set_text(const String &p_text) {
-	_text = p_text;
+	_layout->set_text(p_text);
 }
 
 Ref<Font> Text2D::get_font() const {
@@ -26,29 +32,54 @@ Ref<Font> Text2D::get_font() const {
 }
 void Text2D::set_font(const Ref<Font> &p_font) {
 	_font = p_font;
+	_layout->set_font(p_font);
 
 	if (_font.is_valid()) {
+		bool sdf_material = Object::cast_to<SDFFontMaterial>(_material.ptr()) != NULL;
+
+		if (_font->is_sdf() != sdf_material) {
+			if (_font->is_sdf()) {
+				_material = Ref<FontMaterial>(memnew(SDFFontMaterial));
+			} else {
+				_material.instance();
+			}
+		}
+
 		_material->texture = _font->get_texture();
 	}
 }
 
 Vector2 Text2D::get_text_size() {
-	return _text_size;
+	return _layout->get_size();
 }
 
 void Text2D::update() {
+	// Something else (get_text_size()) might have updated the layout already, so the version is checked instead of the return value.
+	_layout->update();
+
+	if (_layout->get_version() == _mesh_version && !_mesh_dirty) {
+		return;
+	}
+
+	_mesh_dirty = false;
+	_mesh_version = _layout->get_version();
 	_mesh->clear();
 
 	if (!_font.is_valid()) {
 		return;
 	}
 
-	_text_size = _font->generate_mesh(_text, _mesh, _text_color);
+	// Dynamic fonts get a new texture when their atlas grows.
+	_material->texture = _font->get_texture();
+
+	_layout->add_to_mesh(_mesh, _text_color);
 
 	_mesh->upload();
 }
 
 void Text2D::render() {
+	update();
+
 	Transform2D mat_orig = Camera2D::current_camera->get_model_view_matrix();
 
 	Camera2D::current_camera->set_model_view_matrix(mat_orig * transform);
@@ -62,7 +93,14 @@ void Text2D::render() {
 Text2D::Text2D() {
 	_material.instance();
 	_mesh.instance();
+	_layout.instance();
+	_mesh_dirty = true;
+	_mesh_version = 0;
 	_mesh->vertex_dimesions = 2;
+	_mesh->set_buffer_usage(Mesh::BUFFER_USAGE_DYNAMIC);
+	_mesh->set_vertex_layout(Mesh::VERTEX_LAYOUT_INTERLEAVED);
+	// Glyph uvs are always inside the atlas. The color is the user's, so it stays a float.
+	_mesh->set_uv_format(Mesh::UV_FORMAT_UNORM16);
 }
 Text2D::~Text2D() {
 }
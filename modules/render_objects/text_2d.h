@@ -16,6 +16,7 @@
 class Font;
 class FontMaterial;
 class Mesh;
+class TextLayout;
 
 class Text2D : public Object2D {
 	SFW_OBJECT(Text2D, Object2D);
@@ -32,6 +33,7 @@ public:
 
 	Vector2 get_text_size();
 
+	// Only rebuilds the mesh if the layout or the color changed. render() calls it too.
 	void update();
 	void render();
 
@@ -42,9 +44,11 @@ protected:
 	Ref<Font> _font;
 	Ref<FontMaterial> _material;
 	Ref<Mesh> _mesh;
-	String _text;
+	Ref<TextLayout> _layout;
 	Color _text_color;
-	Vector2 _text_size;
+	bool _mesh_dirty;
+	// The layout version the mesh was made from
+	uint32_t _mesh_version;
 };
 
 //--STRIP
@@ -2,110 +2,161 @@
 #include "render_objects/tile_map.h"
 
 #include "render_objects/camera_2d.h"
+
+#include <string.h>
 //--STRIP
 
 void TileMap::build_mesh() {
-	if (!mesh.is_valid()) {
-		mesh = Ref<Mesh>(memnew(Mesh(2)));
-	} else {
-		mesh->clear();
-	}
+	for (uint32_t i = 0; i < _layers.size(); ++i) {
+		Layer &layer = _layers[i];
 
-	if (!data) {
-		//mesh->upload();
+		if (!layer.chunks) {
+			continue;
+		}
 
+		for (int cy = 0; cy < _chunk_count_y; ++cy) {
+			for (int cx = 0; cx < _chunk_count_x; ++cx) {
+				Chunk &chunk = layer.chunks[cy * _chunk_count_x + cx];
+
+				if (chunk.dirty) {
+					_build_chunk(chunk, cx, cy);
+				}
+			}
+		}
+	}
+}
+
+void TileMap::allocate_data() {
+	if (size_x <= 0 || size_y <= 0) {
 		return;
 	}
 
-	float asx = 1.0 / atlas_size_x;
-	float asy = 1.0 / atlas_size_y;
+	for (uint32_t i = 0; i < _layers.size(); ++i) {
+		_free_layer(_layers[i]);
+	}
 
-	for (int x = 0; x < size_x; ++x) {
-		int x_offset = x * size_x;
+	_chunk_count_x = (size_x + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	_chunk_count_y = (size_y + CHUNK_SIZE - 1) / CHUNK_SIZE;
 
-		for (int y = 0; y < size_y; ++y) {
-			uint8_t d = data[x_offset + y];
+	for (uint32_t i = 0; i < _layers.size(); ++i) {
+		_allocate_layer(_layers[i]);
+	}
+}
 
-			if (d == 0) {
-				continue;
-			}
+uint8_t TileMap::get_data(const int x, const int y, const int layer) const {
+	ERR_FAIL_INDEX_V(layer, (int)_layers.size(), 0);
+	ERR_FAIL_INDEX_V(x, size_x, 0);
+	ERR_FAIL_INDEX_V(y, size_y, 0);
 
-			float px;
-			float py;
-
-			switch (d) {
-				case 1:
-					px = 1;
-					py = 0;
-					break;
-				case 2:
-					px = 0;
-					py = 1;
-					break;
-			}
+	const Chunk *chunks = _layers[layer].chunks;
 
-			px /= atlas_size_x;
-			py /= atlas_size_y;
+	ERR_FAIL_COND_V(!chunks, 0);
 
-			add_rect(x, y, px, py, asx, asy);
-		}
+	const Chunk &chunk = chunks[(y / CHUNK_SIZE) * _chunk_count_x + (x / CHUNK_SIZE)];
+
+	if (!chunk.data) {
+		return 0;
 	}
 
-	mesh->upload();
+	return chunk.data[(y % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
 }
 
-void TileMap::allocate_data() {
-	if (size_x <= 0 || size_y <= 0) {
-		return;
-	}
+void TileMap::set_data(const int x, const int y, const uint8_t value, const int layer) {
+	ERR_FAIL_INDEX(layer, (int)_layers.size());
+	ERR_FAIL_INDEX(x, size_x);
+	ERR_FAIL_INDEX(y, size_y);
+	ERR_FAIL_COND_MSG(value > atlas_size_x * atlas_size_y, "Tile value is outside of the atlas!");
 
-	if (data) {
-		memdelete_arr(data);
-	}
+	Chunk *chunks = _layers[layer].chunks;
 
-	int size = size_x * size_y;
+	ERR_FAIL_COND(!chunks);
 
-	data = memnew_arr(uint8_t, size);
+	Chunk &chunk = chunks[(y / CHUNK_SIZE) * _chunk_count_x + (x / CHUNK_SIZE)];
+
+	if (!chunk.data) {
+		if (value == 0) {
+			return;
+		}
 
-	for (int i = 0; i < size; ++i) {
-		data[i] = 0;
+		chunk.data = memnew_arr(uint8_t, CHUNK_SIZE * CHUNK_SIZE);
+		memset(chunk.data, 0, CHUNK_SIZE * CHUNK_SIZE);
 	}
-}
 
-void TileMap::add_rect(const int x, const int y, const float uv_x, const float uv_y, const float uv_size_x, const float uv_size_y) {
-	int vc = static_cast<int>(mesh->vertices.size() / mesh->vertex_dimesions);
+	uint8_t &d = chunk.data[(y % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
 
-	mesh->add_vertex2(x, y + 1);
-	mesh->add_uv(uv_x, uv_y + uv_size_y);
+	if (d == value) {
+		return;
+	}
 
-	mesh->add_vertex2(x + 1, y);
-	mesh->add_uv(uv_x + uv_size_x, uv_y);
+	d = value;
+	chunk.dirty = true;
+}
+
+int TileMap::get_layer_count() const {
+	return _layers.size();
+}
+void TileMap::set_layer_count(const int p_count) {
+	ERR_FAIL_COND(p_count < 1);
 
-	mesh->add_vertex2(x, y);
-	mesh->add_uv(uv_x, uv_y);
+	int old_count = _layers.size();
 
-	mesh->add_vertex2(x + 1, y + 1);
-	mesh->add_uv(uv_x + uv_size_x, uv_y + uv_size_y);
+	for (int i = p_count; i < old_count; ++i) {
+		_free_layer(_layers[i]);
+	}
+
+	_layers.resize(p_count);
 
-	mesh->add_triangle(vc + 1, vc + 0, vc + 2);
-	mesh->add_triangle(vc + 0, vc + 1, vc + 3);
+	// New layers only get their chunks if the map is already allocated.
+	if (_chunk_count_x > 0) {
+		for (int i = old_count; i < p_count; ++i) {
+			_allocate_layer(_layers[i]);
+		}
+	}
 }
 
-uint8_t TileMap::get_data(const int x, const int y) const {
-	//3d-ben: data[(x * size_x * size_x) + (y * size_y) + size_z] etc
+bool TileMap::get_layer_visible(const int p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)_layers.size(), false);
 
-	return data[x * size_x + y];
+	return _layers[p_layer].visible;
 }
+void TileMap::set_layer_visible(const int p_layer, const bool p_visible) {
+	ERR_FAIL_INDEX(p_layer, (int)_layers.size());
 
-void TileMap::set_data(const int x, const int y, const uint8_t value) {
-	data[x * size_x + y] = value;
+	_layers[p_layer].visible = p_visible;
+}
+
+Rect2 TileMap::get_visible_rect() const {
+	Rect2 map_rect = Rect2(0, 0, size_x, size_y);
+
+	Camera2D *camera = Camera2D::current_camera;
+
+	if (!camera || camera->size.x <= 0 || camera->size.y <= 0) {
+		return map_rect;
+	}
+
+	// The camera's projection maps [0, size] to the screen.
+	Transform2D mat = camera->get_model_view_matrix() * transform;
+	Rect2 visible = mat.affine_inverse().xform(Rect2(Vector2(), camera->size));
+
+	return map_rect.intersection(visible);
 }
 
 void TileMap::render() {
-	if (!mesh.is_valid()) {
+	if (_chunk_count_x == 0) {
+		return;
+	}
+
+	Rect2 visible = get_visible_rect();
+
+	if (visible.size.x <= 0 || visible.size.y <= 0) {
 		return;
 	}
 
+	int cx_from = CLAMP(Math::floor(visible.position.x / CHUNK_SIZE), 0, _chunk_count_x - 1);
+	int cy_from = CLAMP(Math::floor(visible.position.y / CHUNK_SIZE), 0, _chunk_count_y - 1);
+	int cx_to = CLAMP(Math::ceil((visible.position.x + visible.size.x) / CHUNK_SIZE), 1, _chunk_count_x);
+	int cy_to = CLAMP(Math::ceil((visible.position.y + visible.size.y) / CHUNK_SIZE), 1, _chunk_count_y);
+
 	Transform2D mat_orig = Camera2D::current_camera->get_model_view_matrix();
 
 	Camera2D::current_camera->set_model_view_matrix(mat_orig * transform);
@@ -114,21 +165,130 @@ void TileMap::render() {
 		material->bind();
 	}
 
-	mesh->render();
+	for (uint32_t i = 0; i < _layers.size(); ++i) {
+		Layer &layer = _layers[i];
+
+		if (!layer.visible || !layer.chunks) {
+			continue;
+		}
+
+		for (int cy = cy_from; cy < cy_to; ++cy) {
+			for (int cx = cx_from; cx < cx_to; ++cx) {
+				Chunk &chunk = layer.chunks[cy * _chunk_count_x + cx];
+
+				if (chunk.dirty) {
+					_build_chunk(chunk, cx, cy);
+				}
+
+				if (chunk.mesh.is_valid() && chunk.mesh->indices.size() > 0) {
+					chunk.mesh->render();
+				}
+			}
+		}
+	}
 
 	Camera2D::current_camera->set_model_view_matrix(mat_orig);
 }
 
 TileMap::TileMap() {
-	data = NULL;
 	size_x = 16;
 	size_y = 16;
 
 	atlas_size_x = 1;
 	atlas_size_y = 1;
+
+	_chunk_count_x = 0;
+	_chunk_count_y = 0;
+
+	_layers.resize(1);
 }
 TileMap::~TileMap() {
-	if (data) {
-		memdelete_arr(data);
+	for (uint32_t i = 0; i < _layers.size(); ++i) {
+		_free_layer(_layers[i]);
+	}
+}
+
+void TileMap::_allocate_layer(Layer &r_layer) {
+	r_layer.chunks = memnew_arr(Chunk, _chunk_count_x * _chunk_count_y);
+}
+
+void TileMap::_free_layer(Layer &r_layer) {
+	if (!r_layer.chunks) {
+		return;
+	}
+
+	for (int i = 0; i < _chunk_count_x * _chunk_count_y; ++i) {
+		if (r_layer.chunks[i].data) {
+			memdelete_arr(r_layer.chunks[i].data);
+		}
+	}
+
+	memdelete_arr(r_layer.chunks);
+	r_layer.chunks = NULL;
+}
+
+void TileMap::_build_chunk(Chunk &r_chunk, const int p_chunk_x, const int p_chunk_y) {
+	r_chunk.dirty = false;
+
+	if (!r_chunk.mesh.is_valid()) {
+		r_chunk.mesh = Ref<Mesh>(memnew(Mesh(2)));
+		// Rebuilt every time a tile in the chunk changes
+		r_chunk.mesh->set_buffer_usage(Mesh::BUFFER_USAGE_DYNAMIC);
+	} else {
+		r_chunk.mesh->clear();
+	}
+
+	if (!r_chunk.data) {
+		return;
+	}
+
+	float asx = 1.0 / atlas_size_x;
+	float asy = 1.0 / atlas_size_y;
+
+	int x_ofs = p_chunk_x * CHUNK_SIZE;
+	int y_ofs = p_chunk_y * CHUNK_SIZE;
+
+	// The last chunks can be partial
+	int x_end = MIN(CHUNK_SIZE, size_x - x_ofs);
+	int y_end = MIN(CHUNK_SIZE, size_y - y_ofs);
+
+	for (int y = 0; y < y_end; ++y) {
+		const uint8_t *row = r_chunk.data + y * CHUNK_SIZE;
+
+		for (int x = 0; x < x_end; ++x) {
+			uint8_t d = row[x];
+
+			if (d == 0) {
+				continue;
+			}
+
+			int cell = d - 1;
+
+			float px = (cell % atlas_size_x) * asx;
+			float py = (cell / atlas_size_x) * asy;
+
+			_add_rect(r_chunk.mesh, x_ofs + x, y_ofs + y, px, py, asx, asy);
+		}
 	}
+
+	r_chunk.mesh->upload();
+}
+
+void TileMap::_add_rect(Ref<Mesh> &p_mesh, const int x, const int y, const float uv_x, const float uv_y, const float uv_size_x, const float uv_size_y) {
+	int vc = static_cast<int>(p_mesh->vertices.size() / p_mesh->vertex_dimesions);
+
+	p_mesh->add_vertex2(x, y + 1);
+	p_mesh->add_uv(uv_x, uv_y + uv_size_y);
+
+	p_mesh->add_vertex2(x + 1, y);
+	p_mesh->add_uv(uv_x + uv_size_x, uv_y);
+
+	p_mesh->add_vertex2(x, y);
+	p_mesh->add_uv(uv_x, uv_y);
+
+	p_mesh->add_vertex2(x + 1, y + 1);
+	p_mesh->add_uv(uv_x + uv_size_x, uv_y + uv_size_y);
+
+	p_mesh->add_triangle(vc + 1, vc + 0, vc + 2);
+	p_mesh->add_triangle(vc + 0, vc + 1, vc + 3);
 }
@@ -6,36 +6,95 @@
 //--STRIP
 #include "render_objects/object_2d.h"
 
+#include "core/local_vector.h"
+#include "core/rect2.h"
+
 #include "render_core/mesh.h"
 
 #include "render_core/material.h"
 //--STRIP
 
+// Tile value 0 is empty, value n uses atlas cell n - 1, so (0, 0) is 1, (1, 0) is 2, and so on, row by row.
+// set_data() rejects values above atlas_size_x * atlas_size_y.
+//
+// The map is stored in CHUNK_SIZE x CHUNK_SIZE chunks, every chunk of every layer has its own mesh.
+// set_data() only marks the chunk dirty, and render() only rebuilds and draws the chunks that are
+// on screen, so both editing and drawing cost depend on what changed and what's visible, not on the map size.
+// Chunks that never had a tile in them don't allocate anything.
+//
+// Layers share the material, and are drawn in order.
+
 class TileMap : public Object2D {
 	SFW_OBJECT(TileMap, Object2D);
 
 public:
+	enum {
+		CHUNK_SIZE = 32,
+	};
+
+	// Rebuilds every dirty chunk, render() only rebuilds the visible ones.
 	void build_mesh();
+	// Uses size_x, size_y, and the layer count. Clears the map.
 	void allocate_data();
-	void add_rect(const int x, const int y, const float uv_x, const float uv_y, const float uv_size_x, const float uv_size_y);
 
-	uint8_t get_data(const int x, const int y) const;
-	void set_data(const int x, const int y, const uint8_t value);
+	uint8_t get_data(const int x, const int y, const int layer = 0) const;
+	void set_data(const int x, const int y, const uint8_t value, const int layer = 0);
+
+	int get_layer_count() const;
+	void set_layer_count(const int p_count);
+
+	bool get_layer_visible(const int p_layer) const;
+	void set_layer_visible(const int p_layer, const bool p_visible);
+
+	// The tile rect that is visible with the current camera.
+	Rect2 get_visible_rect() const;
 
 	void render();
 
 	TileMap();
 	~TileMap();
 
-	uint8_t *data;
 	int size_x;
 	int size_y;
 
 	int atlas_size_x;
 	int atlas_size_y;
 
-	Ref<Mesh> mesh;
 	Ref<Material> material;
+
+protected:
+	struct Chunk {
+		// CHUNK_SIZE * CHUNK_SIZE, NULL until the first non empty tile is set.
+		uint8_t *data;
+		Ref<Mesh> mesh;
+		bool dirty;
+
+		Chunk() {
+			data = NULL;
+			dirty = false;
+		}
+	};
+
+	struct Layer {
+		// _chunk_count_x * _chunk_count_y
+		Chunk *chunks;
+		bool visible;
+
+		Layer() {
+			chunks = NULL;
+			visible = true;
+		}
+	};
+
+	void _allocate_layer(Layer &r_layer);
+	void _free_layer(Layer &r_layer);
+	void _build_chunk(Chunk &r_chunk, const int p_chunk_x, const int p_chunk_y);
+	void _add_rect(Ref<Mesh> &p_mesh, const int x, const int y, const float uv_x, const float uv_y, const float uv_size_x, const float uv_size_y);
+
+	LocalVector<Layer> _layers;
+
+	int _chunk_count_x;
+	int _chunk_count_y;
 };
 
 //--STRIP
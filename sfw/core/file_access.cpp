@@ -7,6 +7,7 @@
 //--STRIP
 #include "file_access.h"
 
+#include "core/file_access_mapped.h"
 #include "core/marshalls.h"
 
 #include <cstdio>
@@ -77,6 +78,8 @@ Error FileAccess::_open(const String &p_path, int p_mode_flags) {
 		close();
 	}
 
+	_reset_read_buffer(0);
+
 	const WCHAR *mode_string;
 
 	if (p_mode_flags == READ) {
@@ -157,6 +160,8 @@ void FileAccess::close() {
 	fclose(f);
 	f = NULL;
 
+	_reset_read_buffer(0);
+
 	if (save_path != "") {
 		bool rename_error = true;
 		int attempts = 4;
@@ -210,15 +215,30 @@ bool FileAccess::is_open() const {
 	return (f != NULL);
 }
 
+int FileAccess::get_fd() const {
+	if (!f) {
+		return -1;
+	}
+
+	return _fileno(f);
+}
+
 void FileAccess::seek(uint64_t p_position) {
 	ERR_FAIL_COND(!f);
 
 	last_error = OK;
 
+	if (_read_buffer_len > 0 && p_position >= _read_buffer_offset && p_position <= _read_buffer_offset + _read_buffer_len) {
+		_read_buffer_pos = p_position - _read_buffer_offset;
+		return;
+	}
+
 	if (_fseeki64(f, p_position, SEEK_SET)) {
 		check_errors();
 	}
 
+	_reset_read_buffer(p_position);
+
 	prev_op = 0;
 }
 
@@ -229,10 +249,18 @@ void FileAccess::seek_end(int64_t p_position) {
 		check_errors();
 	}
 
+	if (_is_read_buffered()) {
+		_reset_read_buffer(_ftelli64(f));
+	}
+
 	prev_op = 0;
 }
 
 uint64_t FileAccess::get_position() const {
+	if (_is_read_buffered()) {
+		return _read_buffer_offset + _read_buffer_pos;
+	}
+
 	int64_t aux_position = _ftelli64(f);
 
 	if (aux_position < 0) {
@@ -254,12 +282,29 @@ uint64_t FileAccess::get_len() const {
 }
 
 bool FileAccess::eof_reached() const {
-	check_errors();
+	// The buffer can reach the end of the file before the reader does, reads set the error themselves.
+	if (!_is_read_buffered()) {
+		check_errors();
+	}
+
 	return last_error == ERR_FILE_EOF;
 }
 
 uint8_t FileAccess::get_8() const {
+	if (_read_buffer_pos < _read_buffer_len) {
+		return _read_buffer[_read_buffer_pos++];
+	}
+
 	ERR_FAIL_COND_V(!f, 0);
+
+	if (_is_read_buffered()) {
+		if (!_fill_read_buffer()) {
+			return '\0';
+		}
+
+		return _read_buffer[_read_buffer_pos++];
+	}
+
 	if (flags == READ_WRITE || flags == WRITE_READ) {
 		if (prev_op == WRITE) {
 			fflush(f);
@@ -279,6 +324,10 @@ uint64_t FileAccess::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 	ERR_FAIL_COND_V(!f, -1);
 
+	if (_is_read_buffered()) {
+		return _get_buffer_buffered(p_dst, p_length);
+	}
+
 	if (flags == READ_WRITE || flags == WRITE_READ) {
 		if (prev_op == WRITE) {
 			fflush(f);
@@ -373,9 +422,18 @@ FileAccess::FileAccess() :
 		flags(0),
 		prev_op(0),
 		last_error(OK) {
+	_read_buffer = NULL;
+	_read_buffer_size = _default_read_buffer_size;
+	_read_buffer_pos = 0;
+	_read_buffer_len = 0;
+	_read_buffer_offset = 0;
 }
 FileAccess::~FileAccess() {
 	close();
+
+	if (_read_buffer) {
+		memfree(_read_buffer);
+	}
 }
 
 #else
@@ -394,6 +452,8 @@ Error FileAccess::_open(const String &p_path, int p_mode_flags) {
 	}
 	f = nullptr;
 
+	_reset_read_buffer(0);
+
 	path_src = p_path;
 	path = fix_path(p_path);
 	//printf("opening %s, %i\n", path.utf8().get_data(), Memory::get_static_mem_usage());
@@ -474,6 +534,8 @@ void FileAccess::close() {
 	fclose(f);
 	f = nullptr;
 
+	_reset_read_buffer(0);
+
 	if (close_notification_func) {
 		close_notification_func(path, flags);
 	}
@@ -494,6 +556,14 @@ bool FileAccess::is_open() const {
 	return (f != nullptr);
 }
 
+int FileAccess::get_fd() const {
+	if (!f) {
+		return -1;
+	}
+
+	return fileno(f);
+}
+
 String FileAccess::get_path() const {
 	return path_src;
 }
@@ -506,9 +576,17 @@ void FileAccess::seek(uint64_t p_position) {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
 	last_error = OK;
+
+	if (_read_buffer_len > 0 && p_position >= _read_buffer_offset && p_position <= _read_buffer_offset + _read_buffer_len) {
+		_read_buffer_pos = p_position - _read_buffer_offset;
+		return;
+	}
+
 	if (fseeko(f, p_position, SEEK_SET)) {
 		check_errors();
 	}
+
+	_reset_read_buffer(p_position);
 }
 
 void FileAccess::seek_end(int64_t p_position) {
@@ -517,11 +595,19 @@ void FileAccess::seek_end(int64_t p_position) {
 	if (fseeko(f, p_position, SEEK_END)) {
 		check_errors();
 	}
+
+	if (_is_read_buffered()) {
+		_reset_read_buffer(ftello(f));
+	}
 }
 
 uint64_t FileAccess::get_position() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 
+	if (_is_read_buffered()) {
+		return _read_buffer_offset + _read_buffer_pos;
+	}
+
 	int64_t pos = ftello(f);
 	if (pos < 0) {
 		check_errors();
@@ -548,7 +634,20 @@ bool FileAccess::eof_reached() const {
 }
 
 uint8_t FileAccess::get_8() const {
+	if (_read_buffer_pos < _read_buffer_len) {
+		return _read_buffer[_read_buffer_pos++];
+	}
+
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
+
+	if (_is_read_buffered()) {
+		if (!_fill_read_buffer()) {
+			return '\0';
+		}
+
+		return _read_buffer[_read_buffer_pos++];
+	}
+
 	uint8_t b;
 	if (fread(&b, 1, 1, f) == 0) {
 		check_errors();
@@ -561,6 +660,10 @@ uint64_t FileAccess::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 	ERR_FAIL_COND_V_MSG(!f, -1, "File must be opened before use.");
 
+	if (_is_read_buffered()) {
+		return _get_buffer_buffered(p_dst, p_length);
+	}
+
 	uint64_t read = fread(p_dst, 1, p_length, f);
 	check_errors();
 	return read;
@@ -662,10 +765,20 @@ FileAccess::FileAccess() :
 		last_error(OK) {
 	endian_swap = false;
 	real_is_double = false;
+
+	_read_buffer = nullptr;
+	_read_buffer_size = _default_read_buffer_size;
+	_read_buffer_pos = 0;
+	_read_buffer_len = 0;
+	_read_buffer_offset = 0;
 }
 
 FileAccess::~FileAccess() {
 	close();
+
+	if (_read_buffer) {
+		memfree(_read_buffer);
+	}
 }
 
 #endif
@@ -674,6 +787,97 @@ FileAccess::FileCloseFailNotify FileAccess::close_fail_notify = nullptr;
 
 bool FileAccess::backup_save = false;
 
+uint32_t FileAccess::_default_read_buffer_size = 64 * 1024;
+
+void FileAccess::set_read_buffer_size(uint32_t p_size) {
+	if (p_size == _read_buffer_size) {
+		return;
+	}
+
+	uint64_t pos = f ? get_position() : 0;
+
+	if (f && _is_read_buffered() && _read_buffer_pos < _read_buffer_len) {
+		// The real file position is ahead of the reader, move it back.
+		_read_buffer_len = 0;
+		seek(pos);
+	}
+
+	if (_read_buffer) {
+		memfree(_read_buffer);
+		_read_buffer = nullptr;
+	}
+
+	_read_buffer_size = p_size;
+	_reset_read_buffer(pos);
+}
+
+uint32_t FileAccess::get_read_buffer_size() const {
+	return _read_buffer_size;
+}
+
+bool FileAccess::_fill_read_buffer() const {
+	if (!_read_buffer) {
+		_read_buffer = (uint8_t *)memalloc(_read_buffer_size);
+		ERR_FAIL_COND_V(!_read_buffer, false);
+	}
+
+	_read_buffer_offset += _read_buffer_len;
+	_read_buffer_pos = 0;
+	_read_buffer_len = fread(_read_buffer, 1, _read_buffer_size, f);
+
+	if (_read_buffer_len == 0) {
+		check_errors();
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t FileAccess::_get_buffer_buffered(uint8_t *p_dst, uint64_t p_length) const {
+	uint64_t read = MIN((uint64_t)(_read_buffer_len - _read_buffer_pos), p_length);
+
+	if (read > 0) {
+		memcpy(p_dst, _read_buffer + _read_buffer_pos, read);
+		_read_buffer_pos += read;
+	}
+
+	uint64_t remaining = p_length - read;
+
+	if (remaining == 0) {
+		return read;
+	}
+
+	if (remaining >= _read_buffer_size) {
+		// Big reads go directly into the destination.
+		uint64_t offset = _read_buffer_offset + _read_buffer_len;
+		uint64_t r = fread(p_dst + read, 1, remaining, f);
+
+		_reset_read_buffer(offset + r);
+
+		if (r < remaining) {
+			check_errors();
+		}
+
+		return read + r;
+	}
+
+	while (remaining > 0 && _fill_read_buffer()) {
+		uint32_t n = MIN((uint64_t)_read_buffer_len, remaining);
+		memcpy(p_dst + read, _read_buffer, n);
+		_read_buffer_pos = n;
+		read += n;
+		remaining -= n;
+	}
+
+	return read;
+}
+
+void FileAccess::_reset_read_buffer(uint64_t p_offset) const {
+	_read_buffer_pos = 0;
+	_read_buffer_len = 0;
+	_read_buffer_offset = p_offset;
+}
+
 FileAccess *FileAccess::create() {
 	return memnew(FileAccess());
 }
@@ -714,6 +918,21 @@ FileAccess *FileAccess::create_and_open(const String &p_path, int p_mode_flags,
 	return ret;
 }
 
+FileAccessMapped *FileAccess::create_mapped(const String &p_path, Error *r_error) {
+	FileAccessMapped *ret = memnew(FileAccessMapped);
+	Error err = ret->open(p_path, READ);
+
+	if (r_error) {
+		*r_error = err;
+	}
+	if (err != OK) {
+		memdelete(ret);
+		ret = nullptr;
+	}
+
+	return ret;
+}
+
 String FileAccess::fix_path(const String &p_path) const {
 	//helper used by file accesses that use a single filesystem
 
@@ -725,6 +944,12 @@ String FileAccess::fix_path(const String &p_path) const {
 /* these are all implemented for ease of porting, then can later be optimized */
 
 uint16_t FileAccess::get_16() const {
+	if (_read_buffer_len - _read_buffer_pos >= 2) {
+		uint16_t res = decode_uint16(_read_buffer + _read_buffer_pos);
+		_read_buffer_pos += 2;
+		return endian_swap ? BSWAP16(res) : res;
+	}
+
 	uint16_t res;
 	uint8_t a, b;
 
@@ -742,6 +967,12 @@ uint16_t FileAccess::get_16() const {
 	return res;
 }
 uint32_t FileAccess::get_32() const {
+	if (_read_buffer_len - _read_buffer_pos >= 4) {
+		uint32_t res = decode_uint32(_read_buffer + _read_buffer_pos);
+		_read_buffer_pos += 4;
+		return endian_swap ? BSWAP32(res) : res;
+	}
+
 	uint32_t res;
 	uint16_t a, b;
 
@@ -759,6 +990,12 @@ uint32_t FileAccess::get_32() const {
 	return res;
 }
 uint64_t FileAccess::get_64() const {
+	if (_read_buffer_len - _read_buffer_pos >= 8) {
+		uint64_t res = decode_uint64(_read_buffer + _read_buffer_pos);
+		_read_buffer_pos += 8;
+		return endian_swap ? BSWAP64(res) : res;
+	}
+
 	uint64_t res;
 	uint32_t a, b;
 
@@ -796,25 +1033,6 @@ double FileAccess::get_double() const {
 	return m.d;
 };
 
-String FileAccess::get_token() const {
-	CharString token;
-
-	CharType c = get_8();
-
-	while (!eof_reached()) {
-		if (c <= ' ') {
-			if (token.length()) {
-				break;
-			}
-		} else {
-			token += c;
-		}
-		c = get_8();
-	}
-
-	return String::utf8(token.get_data());
-}
-
 class CharBuffer {
 	Vector<char> vector;
 	char stack_buffer[256];
@@ -823,8 +1041,8 @@ class CharBuffer {
 	int capacity;
 	int written;
 
-	bool grow() {
-		if (vector.resize(next_power_of_2(1 + written)) != OK) {
+	bool grow(int p_min_capacity) {
+		if (vector.resize(next_power_of_2(p_min_capacity)) != OK) {
 			return false;
 		}
 
@@ -851,20 +1069,116 @@ public:
 
 	_FORCE_INLINE_ void push_back(char c) {
 		if (written >= capacity) {
-			ERR_FAIL_COND(!grow());
+			ERR_FAIL_COND(!grow(written + 1));
 		}
 
 		buffer[written++] = c;
 	}
 
+	_FORCE_INLINE_ void append(const char *p_data, int p_length) {
+		if (written + p_length > capacity) {
+			ERR_FAIL_COND(!grow(written + p_length));
+		}
+
+		memcpy(buffer + written, p_data, p_length);
+		written += p_length;
+	}
+
+	_FORCE_INLINE_ int get_length() const {
+		return written;
+	}
+
 	_FORCE_INLINE_ const char *get_data() const {
 		return buffer;
 	}
 };
 
+String FileAccess::get_token() const {
+	if (_is_read_buffered()) {
+		CharBuffer token;
+
+		while (_read_buffer_pos < _read_buffer_len || _fill_read_buffer()) {
+			const uint8_t *buf = _read_buffer;
+			uint32_t end = _read_buffer_len;
+			uint32_t i = _read_buffer_pos;
+
+			if (token.get_length() == 0) {
+				while (i < end && buf[i] <= ' ') {
+					++i;
+				}
+			}
+
+			uint32_t from = i;
+
+			while (i < end && buf[i] > ' ') {
+				++i;
+			}
+
+			token.append((const char *)buf + from, i - from);
+
+			if (i < end && token.get_length() > 0) {
+				// Consume the separator, same as the unbuffered version
+				_read_buffer_pos = i + 1;
+				break;
+			}
+
+			_read_buffer_pos = i;
+		}
+
+		token.push_back(0);
+		return String::utf8(token.get_data());
+	}
+
+	CharString token;
+
+	CharType c = get_8();
+
+	while (!eof_reached()) {
+		if (c <= ' ') {
+			if (token.length()) {
+				break;
+			}
+		} else {
+			token += c;
+		}
+		c = get_8();
+	}
+
+	return String::utf8(token.get_data());
+}
+
 String FileAccess::get_line() const {
 	CharBuffer line;
 
+	if (_is_read_buffered()) {
+		while (_read_buffer_pos < _read_buffer_len || _fill_read_buffer()) {
+			const uint8_t *buf = _read_buffer;
+			uint32_t end = _read_buffer_len;
+			uint32_t from = _read_buffer_pos;
+			uint32_t i = from;
+
+			while (i < end && buf[i] != '\n' && buf[i] != '\r' && buf[i] != '\0') {
+				++i;
+			}
+
+			line.append((const char *)buf + from, i - from);
+
+			if (i == end) {
+				_read_buffer_pos = end;
+				continue;
+			}
+
+			_read_buffer_pos = i + 1;
+
+			if (buf[i] != '\r') {
+				break;
+			}
+		}
+
+		line.push_back(0);
+		return String::utf8(line.get_data());
+	}
+
 	CharType c = get_8();
 
 	while (!eof_reached()) {
@@ -891,44 +1205,61 @@ Vector<String> FileAccess::get_csv_line(const String &p_delim) const {
 	// in double quotes. So our "line" might be more than a single line in the
 	// text file.
 	int qc = 0;
+	bool first = true;
 	do {
 		if (eof_reached()) {
 			break;
 		}
-		line += get_line() + "\n";
-		qc = 0;
-		for (int i = 0; i < line.length(); i++) {
-			if (line[i] == '"') {
+
+		String l = get_line();
+
+		const CharType *lp = l.ptr();
+		int l_length = l.length();
+		for (int i = 0; i < l_length; i++) {
+			if (lp[i] == '"') {
 				qc++;
 			}
 		}
-	} while (qc % 2);
 
-	// Remove the extraneous newline we've added above.
-	line = line.substr(0, line.length() - 1);
+		if (first) {
+			line = l;
+			first = false;
+		} else {
+			line += "\n";
+			line += l;
+		}
+	} while (qc % 2);
 
 	Vector<String> strings;
 
 	bool in_quote = false;
 	String current;
-	for (int i = 0; i < line.length(); i++) {
-		CharType c = line[i];
+	const CharType *lp = line.ptr();
+	const CharType delim = p_delim[0];
+	int line_length = line.length();
+	// Characters are copied in runs instead of one by one.
+	int run_start = 0;
+	for (int i = 0; i < line_length; i++) {
+		CharType c = lp[i];
 		// A delimiter ends the current entry, unless it's in a quoted string.
-		if (!in_quote && c == p_delim[0]) {
+		if (!in_quote && c == delim) {
+			current += line.substr(run_start, i - run_start);
 			strings.push_back(current);
 			current = String();
+			run_start = i + 1;
 		} else if (c == '"') {
+			current += line.substr(run_start, i - run_start);
 			// Doubled quotes are escapes for intentional quotes in the string.
-			if (line[i + 1] == '"' && in_quote) {
+			if (lp[i + 1] == '"' && in_quote) {
 				current += '"';
 				i++;
 			} else {
 				in_quote = !in_quote;
 			}
-		} else {
-			current += c;
+			run_start = i + 1;
 		}
 	}
+	current += line.substr(run_start, line_length - run_start);
 	strings.push_back(current);
 
 	return strings;
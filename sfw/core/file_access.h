@@ -34,6 +34,8 @@ typedef struct _IO_FILE FILE;
 typedef void (*FileCloseNotificationFunc)(const String &p_file, int p_flags);
 #endif
 
+class FileAccessMapped;
+
 class FileAccess {
 public:
 	typedef void (*FileCloseFailNotify)(const String &);
@@ -66,6 +68,9 @@ public:
 
 	virtual void close(); ///< close a file
 	virtual bool is_open() const; ///< true when file is open
+	// Native descriptor of the open file, or -1 if there is none (e.g. FileAccessMapped).
+	// Pending writes are not flushed.
+	virtual int get_fd() const;
 
 	virtual String get_path() const; /// returns the path for the current open file
 	virtual String get_path_absolute() const; /// returns the absolute path for the current open file
@@ -92,6 +97,15 @@ public:
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
 	virtual String get_as_utf8_string(bool p_skip_cr = true) const; // Skip CR by default for compat.
 
+	// Files opened with READ are read through an internal buffer of this size, so small reads
+	// (get_8(), get_line(), get_csv_line() etc.) don't need to call into the C library every time.
+	// Reads bigger than the buffer go directly into the destination. 0 disables buffering.
+	virtual void set_read_buffer_size(uint32_t p_size);
+	uint32_t get_read_buffer_size() const;
+
+	static void set_default_read_buffer_size(uint32_t p_size) { _default_read_buffer_size = p_size; }
+	static uint32_t get_default_read_buffer_size() { return _default_read_buffer_size; }
+
 	/**< use this for files WRITTEN in _big_ endian machines (ie, amiga/mac)
 	 * It's not about the current CPU type but file formats.
 	 * this flags get reset to false (little endian) on each open
@@ -130,6 +144,8 @@ public:
 
 	static FileAccess *create(); /// Helper that Creates a file access
 	static FileAccess *create_and_open(const String &p_path, int p_mode_flags, Error *r_error = nullptr);
+	// Read only, the whole file is accessible through FileAccessMapped::get_data() without copying.
+	static FileAccessMapped *create_mapped(const String &p_path, Error *r_error = nullptr);
 	static bool exists(const String &p_name); ///< return true if a file exists
 	static uint64_t get_modified_time(const String &p_file);
 	static uint32_t get_unix_permissions(const String &p_file);
@@ -174,6 +190,20 @@ protected:
 	String path;
 	String path_src;
 #endif
+
+	_FORCE_INLINE_ bool _is_read_buffered() const { return _read_buffer_size > 0 && flags == READ; }
+	virtual bool _fill_read_buffer() const;
+	uint64_t _get_buffer_buffered(uint8_t *p_dst, uint64_t p_length) const;
+	void _reset_read_buffer(uint64_t p_offset) const;
+
+	mutable uint8_t *_read_buffer;
+	uint32_t _read_buffer_size;
+	mutable uint32_t _read_buffer_pos;
+	mutable uint32_t _read_buffer_len;
+	// File position of _read_buffer[0]
+	mutable uint64_t _read_buffer_offset;
+
+	static uint32_t _default_read_buffer_size;
 };
 
 struct FileAccessRef {
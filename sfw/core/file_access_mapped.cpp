@@ -0,0 +1,274 @@
+
+//--STRIP
+#include "file_access_mapped.h"
+
+#include "core/error_macros.h"
+//--STRIP
+
+#if defined(_WIN64) || defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#endif
+
+#define MAPPED_WINDOW_SIZE 0x40000000
+
+#if defined(_WIN64) || defined(_WIN32)
+
+Error FileAccessMapped::_open(const String &p_path, int p_mode_flags) {
+	close();
+
+	ERR_FAIL_COND_V_MSG(p_mode_flags != READ, ERR_INVALID_PARAMETER, "Mapped files can only be opened for reading.");
+
+	path_src = p_path;
+	path = fix_path(p_path);
+
+	HANDLE file = CreateFileW((LPCWSTR)(path.utf16().get_data()), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		last_error = GetLastError() == ERROR_FILE_NOT_FOUND ? ERR_FILE_NOT_FOUND : ERR_FILE_CANT_OPEN;
+		return last_error;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		last_error = ERR_FILE_CANT_OPEN;
+		return last_error;
+	}
+
+	_size = size.QuadPart;
+
+	// Empty files can't be mapped
+	if (_size > 0) {
+		HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+		if (!mapping) {
+			CloseHandle(file);
+			last_error = ERR_FILE_CANT_OPEN;
+			return last_error;
+		}
+
+		_data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+		// The view keeps the file alive
+		CloseHandle(mapping);
+
+		if (!_data) {
+			CloseHandle(file);
+			last_error = ERR_FILE_CANT_OPEN;
+			return last_error;
+		}
+	}
+
+	CloseHandle(file);
+
+	_opened = true;
+	flags = READ;
+	last_error = OK;
+	_set_window(0);
+
+	return OK;
+}
+
+void FileAccessMapped::close() {
+	if (!_opened) {
+		return;
+	}
+
+	if (_data) {
+		UnmapViewOfFile(_data);
+	}
+
+	_data = NULL;
+	_size = 0;
+	_opened = false;
+
+	_read_buffer = NULL;
+	_reset_read_buffer(0);
+}
+
+#else
+
+Error FileAccessMapped::_open(const String &p_path, int p_mode_flags) {
+	close();
+
+	ERR_FAIL_COND_V_MSG(p_mode_flags != READ, ERR_INVALID_PARAMETER, "Mapped files can only be opened for reading.");
+
+	path_src = p_path;
+	path = fix_path(p_path);
+
+	int fd = ::open(path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1) {
+		last_error = errno == ENOENT ? ERR_FILE_NOT_FOUND : ERR_FILE_CANT_OPEN;
+		return last_error;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		last_error = ERR_FILE_CANT_OPEN;
+		return last_error;
+	}
+
+	_size = st.st_size;
+
+	// Empty files can't be mapped
+	if (_size > 0) {
+		void *data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (data == MAP_FAILED) {
+			::close(fd);
+			_size = 0;
+			last_error = ERR_FILE_CANT_OPEN;
+			return last_error;
+		}
+
+		_data = (const uint8_t *)data;
+	}
+
+	// The mapping keeps the file alive
+	::close(fd);
+
+	_opened = true;
+	flags = READ;
+	last_error = OK;
+	_set_window(0);
+
+	return OK;
+}
+
+void FileAccessMapped::close() {
+	if (!_opened) {
+		return;
+	}
+
+	if (_data) {
+		munmap((void *)_data, _size);
+	}
+
+	_data = NULL;
+	_size = 0;
+	_opened = false;
+
+	_read_buffer = NULL;
+	_reset_read_buffer(0);
+}
+
+#endif
+
+bool FileAccessMapped::is_open() const {
+	return _opened;
+}
+
+void FileAccessMapped::seek(uint64_t p_position) {
+	ERR_FAIL_COND_MSG(!_opened, "File must be opened before use.");
+
+	last_error = OK;
+	_set_window(MIN(p_position, _size));
+}
+
+void FileAccessMapped::seek_end(int64_t p_position) {
+	ERR_FAIL_COND_MSG(!_opened, "File must be opened before use.");
+	ERR_FAIL_COND(p_position > 0 || (uint64_t)(-p_position) > _size);
+
+	last_error = OK;
+	_set_window(_size + p_position);
+}
+
+uint64_t FileAccessMapped::get_position() const {
+	return _read_buffer_offset + _read_buffer_pos;
+}
+
+uint64_t FileAccessMapped::get_len() const {
+	return _size;
+}
+
+bool FileAccessMapped::eof_reached() const {
+	return last_error == ERR_FILE_EOF;
+}
+
+uint8_t FileAccessMapped::get_8() const {
+	if (_read_buffer_pos < _read_buffer_len || _fill_read_buffer()) {
+		return _read_buffer[_read_buffer_pos++];
+	}
+
+	return '\0';
+}
+
+uint64_t FileAccessMapped::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
+	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
+	ERR_FAIL_COND_V_MSG(!_opened, -1, "File must be opened before use.");
+
+	uint64_t pos = get_position();
+	uint64_t read = MIN(p_length, _size - pos);
+
+	if (read > 0) {
+		memcpy(p_dst, _data + pos, read);
+	}
+
+	_set_window(pos + read);
+
+	if (read < p_length) {
+		last_error = ERR_FILE_EOF;
+	}
+
+	return read;
+}
+
+void FileAccessMapped::flush() {
+}
+
+void FileAccessMapped::store_8(uint8_t p_dest) {
+	ERR_FAIL_MSG("Mapped files are read only.");
+}
+
+void FileAccessMapped::store_buffer(const uint8_t *p_src, uint64_t p_length) {
+	ERR_FAIL_MSG("Mapped files are read only.");
+}
+
+FileAccessMapped::FileAccessMapped() {
+	_data = NULL;
+	_size = 0;
+	_opened = false;
+
+	// Has to be non zero, so the buffered fast paths are used.
+	_read_buffer_size = MAPPED_WINDOW_SIZE;
+}
+
+FileAccessMapped::~FileAccessMapped() {
+	close();
+}
+
+bool FileAccessMapped::_fill_read_buffer() const {
+	uint64_t next = _read_buffer_offset + _read_buffer_len;
+
+	if (next >= _size) {
+		last_error = ERR_FILE_EOF;
+		return false;
+	}
+
+	_set_window(next);
+
+	return true;
+}
+
+void FileAccessMapped::_set_window(uint64_t p_position) const {
+	_read_buffer = (uint8_t *)_data + p_position;
+	_read_buffer_offset = p_position;
+	_read_buffer_pos = 0;
+	_read_buffer_len = MIN(_size - p_position, (uint64_t)MAPPED_WINDOW_SIZE);
+}
+
+#undef MAPPED_WINDOW_SIZE
@@ -0,0 +1,480 @@
+//--STRIP
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+//--STRIP
+
+//--STRIP
+#include "core/error_macros.h"
+#include "core/hashfuncs.h"
+#include "core/memory.h"
+#include "core/pair.h"
+#include "core/typedefs.h"
+//--STRIP
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Open addressing hash tables without per element allocations (swiss table style).
+ *
+ * Every slot has a control byte, that is either empty, deleted, or the low 7 bits of the hash of
+ * the key in it. Lookups compare a whole group of control bytes at once (16 with SSE2, 8 with
+ * plain 64 bit math otherwise), so the keys themselves are only touched on a likely hit.
+ * The control bytes, the full hashes, and the key / value pairs are stored in their own
+ * contiguous arrays. The hashes are kept so growing never has to hash a key again.
+ *
+ * Unlike HashMap, there is no insertion order, and inserting can move every element, which
+ * invalidates pointers and iterators. Erasing doesn't move anything, so it's fine to erase the
+ * current element while iterating.
+ */
+
+struct FlatHashGroup {
+	enum {
+		CTRL_EMPTY = -128,
+		CTRL_DELETED = -2,
+		// Full slots are 0 - 127
+	};
+
+#ifdef FLAT_HASH_SSE2
+	enum {
+		WIDTH = 16,
+		// Match masks have 1 bit per slot
+		MASK_SHIFT = 0,
+	};
+
+	__m128i ctrl;
+
+	_FORCE_INLINE_ uint64_t match(int8_t p_h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(p_h2), ctrl));
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+
+	// Both have the top bit set.
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return (uint32_t)_mm_movemask_epi8(ctrl);
+	}
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const int8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128((const __m128i *)p_ctrl);
+	}
+#else
+	enum {
+		WIDTH = 8,
+		// Match masks have the top bit set in every matching byte
+		MASK_SHIFT = 3,
+	};
+
+	static const uint64_t LSBS = 0x0101010101010101ULL;
+	static const uint64_t MSBS = 0x8080808080808080ULL;
+
+	uint64_t ctrl;
+
+	_FORCE_INLINE_ uint64_t match(int8_t p_h2) const {
+		uint64_t x = ctrl ^ (LSBS * (uint8_t)p_h2);
+		// Exact zero byte test, the usual (x - LSBS) & ~x trick has false positives after a borrow.
+		return ~(((x & ~MSBS) + ~MSBS) | x | ~MSBS);
+	}
+
+	// 0x80 vs 0xFE, only empty has bit 1 clear.
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return ctrl & ~(ctrl << 6) & MSBS;
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return ctrl & MSBS;
+	}
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const int8_t *p_ctrl) {
+		memcpy(&ctrl, p_ctrl, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		ctrl = BSWAP64(ctrl);
+#endif
+	}
+#endif
+
+	// Slot index of the lowest set bit of a match mask. Use p_mask &= p_mask - 1 to get to the next one.
+	static _FORCE_INLINE_ uint32_t lowest(uint64_t p_mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)p_mask)) {
+			return index >> MASK_SHIFT;
+		}
+		_BitScanForward(&index, (unsigned long)(p_mask >> 32));
+		return (index + 32) >> MASK_SHIFT;
+#else
+		return __builtin_ctzll(p_mask) >> MASK_SHIFT;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t h1(uint32_t p_hash) { return p_hash >> 7; }
+	static _FORCE_INLINE_ int8_t h2(uint32_t p_hash) { return p_hash & 0x7F; }
+
+	// Power of 2, and a multiple of the group width.
+	static _FORCE_INLINE_ uint32_t capacity_for(uint32_t p_count) {
+		// Max 7/8 occupancy
+		uint32_t capacity = next_power_of_2(p_count + p_count / 7 + 1);
+		return MAX(capacity, 16u);
+	}
+
+	static _FORCE_INLINE_ uint32_t max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+};
+
+template <class TKey, class TValue, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	typedef KeyValue<TKey, TValue> Pair;
+
+	class Iterator {
+	public:
+		_FORCE_INLINE_ Pair &operator*() const { return _map->_slots[_index]; }
+		_FORCE_INLINE_ Pair *operator->() const { return &_map->_slots[_index]; }
+		_FORCE_INLINE_ const TKey &key() const { return _map->_slots[_index].key; }
+		_FORCE_INLINE_ TValue &value() const { return _map->_slots[_index].value; }
+
+		_FORCE_INLINE_ Iterator &operator++() {
+			_index = _map->_next_full(_index + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &p_other) const { return _index == p_other._index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &p_other) const { return _index != p_other._index; }
+
+		Iterator(const FlatHashMap *p_map, uint32_t p_index) {
+			_map = p_map;
+			_index = p_index;
+		}
+
+	private:
+		friend class FlatHashMap;
+
+		const FlatHashMap *_map;
+		uint32_t _index;
+	};
+
+	_FORCE_INLINE_ uint32_t size() const { return _size; }
+	_FORCE_INLINE_ bool empty() const { return _size == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return _capacity; }
+
+	_FORCE_INLINE_ TValue *getptr(const TKey &p_key) {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+		return pos < 0 ? nullptr : &_slots[pos].value;
+	}
+
+	_FORCE_INLINE_ const TValue *getptr(const TKey &p_key) const {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+		return pos < 0 ? nullptr : &_slots[pos].value;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return _find(p_key, Hasher::hash(p_key)) >= 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		TValue *value = getptr(p_key);
+		CRASH_COND_MSG(!value, "FlatHashMap key not found.");
+		return *value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		const TValue *value = getptr(p_key);
+		CRASH_COND_MSG(!value, "FlatHashMap key not found.");
+		return *value;
+	}
+
+	Iterator find(const TKey &p_key) const {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+		return Iterator(this, pos < 0 ? _capacity : pos);
+	}
+
+	// Overwrites the value if the key is already in the map.
+	TValue &insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t hash = Hasher::hash(p_key);
+		int32_t pos = _find(p_key, hash);
+
+		if (pos >= 0) {
+			_slots[pos].value = p_value;
+			return _slots[pos].value;
+		}
+
+		// _insert_new() can reallocate _slots.
+		pos = _insert_new(p_key, p_value, hash);
+		return _slots[pos].value;
+	}
+
+	_FORCE_INLINE_ TValue &set(const TKey &p_key, const TValue &p_value) {
+		return insert(p_key, p_value);
+	}
+
+	bool erase(const TKey &p_key) {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+
+		if (pos < 0) {
+			return false;
+		}
+
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Erases the element at p_iter, it can be incremented after.
+	void erase(const Iterator &p_iter) {
+		_erase_pos(p_iter._index);
+	}
+
+	// Makes room for p_count elements in total, so that many can be inserted without rehashing.
+	void reserve(uint32_t p_count) {
+		if (p_count <= FlatHashGroup::max_load(_capacity)) {
+			return;
+		}
+
+		_rehash(FlatHashGroup::capacity_for(p_count));
+	}
+
+	// Keeps the capacity.
+	void clear() {
+		if (_capacity == 0) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < _capacity; ++i) {
+			if (_ctrl[i] >= 0) {
+				_slots[i].~Pair();
+			}
+		}
+
+		memset(_ctrl, FlatHashGroup::CTRL_EMPTY, _capacity);
+		_size = 0;
+		_growth_left = FlatHashGroup::max_load(_capacity);
+	}
+
+	// Frees the memory too.
+	void reset() {
+		clear();
+		_free();
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t hash = Hasher::hash(p_key);
+		int32_t pos = _find(p_key, hash);
+
+		if (pos >= 0) {
+			return _slots[pos].value;
+		}
+
+		pos = _insert_new(p_key, TValue(), hash);
+		return _slots[pos].value;
+	}
+
+	const TValue &operator[](const TKey &p_key) const {
+		return get(p_key);
+	}
+
+	_FORCE_INLINE_ Iterator begin() const { return Iterator(this, _next_full(0)); }
+	_FORCE_INLINE_ Iterator end() const { return Iterator(this, _capacity); }
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return;
+		}
+
+		clear();
+		reserve(p_other._size);
+
+		for (uint32_t i = 0; i < p_other._capacity; ++i) {
+			if (p_other._ctrl[i] >= 0) {
+				_insert_new(p_other._slots[i].key, p_other._slots[i].value, p_other._hashes[i]);
+			}
+		}
+	}
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		*this = p_other;
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+		_free();
+	}
+
+private:
+	friend class Iterator;
+
+	int8_t *_ctrl = nullptr;
+	uint32_t *_hashes = nullptr;
+	Pair *_slots = nullptr;
+
+	uint32_t _capacity = 0;
+	uint32_t _size = 0;
+	// Empty slots that can still be used before the table has to grow. Deleted ones don't count.
+	uint32_t _growth_left = 0;
+
+	_FORCE_INLINE_ int32_t _find(const TKey &p_key, uint32_t p_hash) const {
+		if (_size == 0) {
+			return -1;
+		}
+
+		const uint32_t group_mask = _capacity / FlatHashGroup::WIDTH - 1;
+		const int8_t h2 = FlatHashGroup::h2(p_hash);
+		uint32_t group = FlatHashGroup::h1(p_hash) & group_mask;
+
+		// Triangular probing, visits every group with power of 2 group counts.
+		for (uint32_t step = 1;; ++step) {
+			const uint32_t base = group * FlatHashGroup::WIDTH;
+			const FlatHashGroup g(_ctrl + base);
+
+			for (uint64_t m = g.match(h2); m; m &= m - 1) {
+				const uint32_t pos = base + FlatHashGroup::lowest(m);
+
+				if (_hashes[pos] == p_hash && Comparator::compare(_slots[pos].key, p_key)) {
+					return pos;
+				}
+			}
+
+			// The key would have been put into the first free slot.
+			if (g.match_empty()) {
+				return -1;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _find_free(uint32_t p_hash) const {
+		const uint32_t group_mask = _capacity / FlatHashGroup::WIDTH - 1;
+		uint32_t group = FlatHashGroup::h1(p_hash) & group_mask;
+
+		for (uint32_t step = 1;; ++step) {
+			const uint32_t base = group * FlatHashGroup::WIDTH;
+			const uint64_t m = FlatHashGroup(_ctrl + base).match_empty_or_deleted();
+
+			if (m) {
+				return base + FlatHashGroup::lowest(m);
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	uint32_t _insert_new(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		if (_capacity == 0) {
+			_rehash(FlatHashGroup::capacity_for(1));
+		}
+
+		uint32_t pos = _find_free(p_hash);
+
+		// Reusing a deleted slot doesn't use up an empty one.
+		if (_growth_left == 0 && _ctrl[pos] != FlatHashGroup::CTRL_DELETED) {
+			if (_size < FlatHashGroup::max_load(_capacity) / 2) {
+				// Mostly deleted slots, just clean them up.
+				_rehash(_capacity);
+			} else {
+				_rehash(_capacity * 2);
+			}
+
+			pos = _find_free(p_hash);
+		}
+
+		if (_ctrl[pos] == FlatHashGroup::CTRL_EMPTY) {
+			--_growth_left;
+		}
+
+		_ctrl[pos] = FlatHashGroup::h2(p_hash);
+		_hashes[pos] = p_hash;
+		memnew_placement(&_slots[pos], Pair(p_key, p_value));
+		++_size;
+
+		return pos;
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		_slots[p_pos].~Pair();
+		--_size;
+
+		// If the group still has an empty slot, no lookup ever probed past it, so this can be empty too.
+		const uint32_t base = p_pos & ~(uint32_t)(FlatHashGroup::WIDTH - 1);
+
+		if (FlatHashGroup(_ctrl + base).match_empty()) {
+			_ctrl[p_pos] = FlatHashGroup::CTRL_EMPTY;
+			++_growth_left;
+		} else {
+			_ctrl[p_pos] = FlatHashGroup::CTRL_DELETED;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _next_full(uint32_t p_from) const {
+		while (p_from < _capacity && _ctrl[p_from] < 0) {
+			++p_from;
+		}
+
+		return p_from;
+	}
+
+	void _rehash(uint32_t p_capacity) {
+		int8_t *old_ctrl = _ctrl;
+		uint32_t *old_hashes = _hashes;
+		Pair *old_slots = _slots;
+		uint32_t old_capacity = _capacity;
+
+		_ctrl = (int8_t *)memalloc(p_capacity);
+		_hashes = (uint32_t *)memalloc(sizeof(uint32_t) * p_capacity);
+		_slots = (Pair *)memalloc(sizeof(Pair) * p_capacity);
+		memset(_ctrl, FlatHashGroup::CTRL_EMPTY, p_capacity);
+
+		_capacity = p_capacity;
+		_growth_left = FlatHashGroup::max_load(p_capacity) - _size;
+
+		for (uint32_t i = 0; i < old_capacity; ++i) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+
+			uint32_t pos = _find_free(old_hashes[i]);
+
+			_ctrl[pos] = old_ctrl[i];
+			_hashes[pos] = old_hashes[i];
+			memnew_placement(&_slots[pos], Pair(old_slots[i]));
+			old_slots[i].~Pair();
+		}
+
+		if (old_ctrl) {
+			memfree(old_ctrl);
+			memfree(old_hashes);
+			memfree(old_slots);
+		}
+	}
+
+	void _free() {
+		if (_ctrl) {
+			memfree(_ctrl);
+			memfree(_hashes);
+			memfree(_slots);
+		}
+
+		_ctrl = nullptr;
+		_hashes = nullptr;
+		_slots = nullptr;
+		_capacity = 0;
+		_growth_left = 0;
+	}
+};
+
+//--STRIP
+#endif // FLAT_HASH_MAP_H
+//--STRIP
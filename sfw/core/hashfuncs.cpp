@@ -0,0 +1,755 @@
+//--STRIP
+#include "core/hashfuncs.h"
+
+#include "core/error_macros.h"
+//--STRIP
+
+// XXH3 is based on xxHash by Yann Collet (BSD 2-Clause). https://github.com/Cyan4973/xxHash
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XXH3_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XXH3_AVX2
+#define XXH3_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define XXH3_AVX2
+#define XXH3_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define XXH3_BIG_ENDIAN
+#endif
+
+#define XXH3_PRIME32_1 0x9E3779B1U
+#define XXH3_PRIME32_2 0x85EBCA77U
+#define XXH3_PRIME32_3 0xC2B2AE3DU
+#define XXH3_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH3_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH3_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH3_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH3_PRIME64_5 0x27D4EB2F165667C5ULL
+#define XXH3_PRIME_MX1 0x165667919E3779F9ULL
+#define XXH3_PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define XXH3_SECRET_SIZE 192
+#define XXH3_SECRET_SIZE_MIN 136
+#define XXH3_STRIPE_LEN 64
+#define XXH3_SECRET_CONSUME_RATE 8
+#define XXH3_STRIPES_PER_BLOCK ((XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE)
+#define XXH3_BLOCK_LEN (XXH3_STRIPE_LEN * XXH3_STRIPES_PER_BLOCK)
+#define XXH3_BUFFER_SIZE 256
+#define XXH3_BUFFER_STRIPES (XXH3_BUFFER_SIZE / XXH3_STRIPE_LEN)
+#define XXH3_MIDSIZE_MAX 240
+#define XXH3_MIDSIZE_STARTOFFSET 3
+#define XXH3_MIDSIZE_LASTOFFSET 17
+#define XXH3_SECRET_LASTACC_START 7
+#define XXH3_SECRET_MERGEACCS_START 11
+
+static const uint8_t _xxh3_default_secret[XXH3_SECRET_SIZE] = {
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static _FORCE_INLINE_ uint32_t _xxh3_read32(const uint8_t *p_ptr) {
+	uint32_t v;
+	memcpy(&v, p_ptr, sizeof(uint32_t));
+#ifdef XXH3_BIG_ENDIAN
+	v = BSWAP32(v);
+#endif
+	return v;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_read64(const uint8_t *p_ptr) {
+	uint64_t v;
+	memcpy(&v, p_ptr, sizeof(uint64_t));
+#ifdef XXH3_BIG_ENDIAN
+	v = BSWAP64(v);
+#endif
+	return v;
+}
+
+static _FORCE_INLINE_ void _xxh3_write64(uint8_t *p_ptr, uint64_t p_value) {
+#ifdef XXH3_BIG_ENDIAN
+	p_value = BSWAP64(p_value);
+#endif
+	memcpy(p_ptr, &p_value, sizeof(uint64_t));
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_rotl64(uint64_t p_x, int p_r) {
+	return (p_x << p_r) | (p_x >> (64 - p_r));
+}
+
+static _FORCE_INLINE_ uint32_t _xxh3_rotl32(uint32_t p_x, int p_r) {
+	return (p_x << p_r) | (p_x >> (32 - p_r));
+}
+
+static _FORCE_INLINE_ HashXXH3_128 _xxh3_mul128(uint64_t p_lhs, uint64_t p_rhs) {
+	HashXXH3_128 r;
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = (__uint128_t)p_lhs * (__uint128_t)p_rhs;
+	r.low64 = (uint64_t)product;
+	r.high64 = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	r.low64 = _umul128(p_lhs, p_rhs, &r.high64);
+#else
+	uint64_t lo_lo = (uint64_t)(uint32_t)p_lhs * (uint32_t)p_rhs;
+	uint64_t hi_lo = (p_lhs >> 32) * (uint32_t)p_rhs;
+	uint64_t lo_hi = (uint64_t)(uint32_t)p_lhs * (p_rhs >> 32);
+	uint64_t hi_hi = (p_lhs >> 32) * (p_rhs >> 32);
+
+	uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	r.high64 = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+	r.low64 = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+	return r;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_mul128_fold64(uint64_t p_lhs, uint64_t p_rhs) {
+	HashXXH3_128 p = _xxh3_mul128(p_lhs, p_rhs);
+	return p.low64 ^ p.high64;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_xxh64_avalanche(uint64_t h) {
+	h ^= h >> 33;
+	h *= XXH3_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH3_PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_avalanche(uint64_t h) {
+	h ^= h >> 37;
+	h *= XXH3_PRIME_MX1;
+	h ^= h >> 32;
+	return h;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_rrmxmx(uint64_t h, uint64_t p_len) {
+	h ^= _xxh3_rotl64(h, 49) ^ _xxh3_rotl64(h, 24);
+	h *= XXH3_PRIME_MX2;
+	h ^= (h >> 35) + p_len;
+	h *= XXH3_PRIME_MX2;
+	h ^= h >> 28;
+	return h;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_mix16(const uint8_t *p_input, const uint8_t *p_secret, uint64_t p_seed) {
+	return _xxh3_mul128_fold64(
+			_xxh3_read64(p_input) ^ (_xxh3_read64(p_secret) + p_seed),
+			_xxh3_read64(p_input + 8) ^ (_xxh3_read64(p_secret + 8) - p_seed));
+}
+
+static void _xxh3_init_secret(uint8_t *r_secret, uint64_t p_seed) {
+	for (int i = 0; i < XXH3_SECRET_SIZE; i += 16) {
+		_xxh3_write64(r_secret + i, _xxh3_read64(_xxh3_default_secret + i) + p_seed);
+		_xxh3_write64(r_secret + i + 8, _xxh3_read64(_xxh3_default_secret + i + 8) - p_seed);
+	}
+}
+
+// ==== Short inputs (<= 240 bytes). These only ever use the default secret. ====
+
+static uint64_t _xxh3_64_short(const uint8_t *p_input, uint64_t p_len, uint64_t p_seed) {
+	const uint8_t *secret = _xxh3_default_secret;
+
+	if (p_len <= 16) {
+		if (p_len > 8) {
+			uint64_t bitflip1 = (_xxh3_read64(secret + 24) ^ _xxh3_read64(secret + 32)) + p_seed;
+			uint64_t bitflip2 = (_xxh3_read64(secret + 40) ^ _xxh3_read64(secret + 48)) - p_seed;
+			uint64_t input_lo = _xxh3_read64(p_input) ^ bitflip1;
+			uint64_t input_hi = _xxh3_read64(p_input + p_len - 8) ^ bitflip2;
+			uint64_t acc = p_len + BSWAP64(input_lo) + input_hi + _xxh3_mul128_fold64(input_lo, input_hi);
+			return _xxh3_avalanche(acc);
+		}
+
+		if (p_len >= 4) {
+			uint64_t seed = p_seed ^ ((uint64_t)BSWAP32((uint32_t)p_seed) << 32);
+			uint32_t input1 = _xxh3_read32(p_input);
+			uint32_t input2 = _xxh3_read32(p_input + p_len - 4);
+			uint64_t bitflip = (_xxh3_read64(secret + 8) ^ _xxh3_read64(secret + 16)) - seed;
+			uint64_t input64 = input2 + (((uint64_t)input1) << 32);
+			return _xxh3_rrmxmx(input64 ^ bitflip, p_len);
+		}
+
+		if (p_len > 0) {
+			uint8_t c1 = p_input[0];
+			uint8_t c2 = p_input[p_len >> 1];
+			uint8_t c3 = p_input[p_len - 1];
+			uint32_t combined = ((uint32_t)c1 << 16) | ((uint32_t)c2 << 24) | ((uint32_t)c3 << 0) | ((uint32_t)p_len << 8);
+			uint64_t bitflip = (_xxh3_read32(secret) ^ _xxh3_read32(secret + 4)) + p_seed;
+			return _xxh3_xxh64_avalanche((uint64_t)combined ^ bitflip);
+		}
+
+		return _xxh3_xxh64_avalanche(p_seed ^ (_xxh3_read64(secret + 56) ^ _xxh3_read64(secret + 64)));
+	}
+
+	uint64_t acc = p_len * XXH3_PRIME64_1;
+
+	if (p_len <= 128) {
+		if (p_len > 32) {
+			if (p_len > 64) {
+				if (p_len > 96) {
+					acc += _xxh3_mix16(p_input + 48, secret + 96, p_seed);
+					acc += _xxh3_mix16(p_input + p_len - 64, secret + 112, p_seed);
+				}
+				acc += _xxh3_mix16(p_input + 32, secret + 64, p_seed);
+				acc += _xxh3_mix16(p_input + p_len - 48, secret + 80, p_seed);
+			}
+			acc += _xxh3_mix16(p_input + 16, secret + 32, p_seed);
+			acc += _xxh3_mix16(p_input + p_len - 32, secret + 48, p_seed);
+		}
+		acc += _xxh3_mix16(p_input + 0, secret + 0, p_seed);
+		acc += _xxh3_mix16(p_input + p_len - 16, secret + 16, p_seed);
+
+		return _xxh3_avalanche(acc);
+	}
+
+	uint32_t rounds = (uint32_t)p_len / 16;
+
+	for (uint32_t i = 0; i < 8; ++i) {
+		acc += _xxh3_mix16(p_input + (16 * i), secret + (16 * i), p_seed);
+	}
+
+	uint64_t acc_end = _xxh3_mix16(p_input + p_len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, p_seed);
+	acc = _xxh3_avalanche(acc);
+
+	for (uint32_t i = 8; i < rounds; ++i) {
+		acc_end += _xxh3_mix16(p_input + (16 * i), secret + (16 * (i - 8)) + XXH3_MIDSIZE_STARTOFFSET, p_seed);
+	}
+
+	return _xxh3_avalanche(acc + acc_end);
+}
+
+static _FORCE_INLINE_ HashXXH3_128 _xxh3_mix32(HashXXH3_128 p_acc, const uint8_t *p_input_1, const uint8_t *p_input_2, const uint8_t *p_secret, uint64_t p_seed) {
+	p_acc.low64 += _xxh3_mix16(p_input_1, p_secret + 0, p_seed);
+	p_acc.low64 ^= _xxh3_read64(p_input_2) + _xxh3_read64(p_input_2 + 8);
+	p_acc.high64 += _xxh3_mix16(p_input_2, p_secret + 16, p_seed);
+	p_acc.high64 ^= _xxh3_read64(p_input_1) + _xxh3_read64(p_input_1 + 8);
+	return p_acc;
+}
+
+static HashXXH3_128 _xxh3_128_short(const uint8_t *p_input, uint64_t p_len, uint64_t p_seed) {
+	const uint8_t *secret = _xxh3_default_secret;
+	HashXXH3_128 h;
+
+	if (p_len <= 16) {
+		if (p_len > 8) {
+			uint64_t bitflipl = (_xxh3_read64(secret + 32) ^ _xxh3_read64(secret + 40)) - p_seed;
+			uint64_t bitfliph = (_xxh3_read64(secret + 48) ^ _xxh3_read64(secret + 56)) + p_seed;
+			uint64_t input_lo = _xxh3_read64(p_input);
+			uint64_t input_hi = _xxh3_read64(p_input + p_len - 8);
+
+			HashXXH3_128 m = _xxh3_mul128(input_lo ^ input_hi ^ bitflipl, XXH3_PRIME64_1);
+			m.low64 += (uint64_t)(p_len - 1) << 54;
+			input_hi ^= bitfliph;
+			m.high64 += input_hi + (uint64_t)(uint32_t)input_hi * (uint64_t)(XXH3_PRIME32_2 - 1);
+			m.low64 ^= BSWAP64(m.high64);
+
+			h = _xxh3_mul128(m.low64, XXH3_PRIME64_2);
+			h.high64 += m.high64 * XXH3_PRIME64_2;
+			h.low64 = _xxh3_avalanche(h.low64);
+			h.high64 = _xxh3_avalanche(h.high64);
+			return h;
+		}
+
+		if (p_len >= 4) {
+			uint64_t seed = p_seed ^ ((uint64_t)BSWAP32((uint32_t)p_seed) << 32);
+			uint32_t input_lo = _xxh3_read32(p_input);
+			uint32_t input_hi = _xxh3_read32(p_input + p_len - 4);
+			uint64_t input64 = input_lo + ((uint64_t)input_hi << 32);
+			uint64_t bitflip = (_xxh3_read64(secret + 16) ^ _xxh3_read64(secret + 24)) + seed;
+
+			h = _xxh3_mul128(input64 ^ bitflip, XXH3_PRIME64_1 + (p_len << 2));
+			h.high64 += (h.low64 << 1);
+			h.low64 ^= (h.high64 >> 3);
+
+			h.low64 ^= h.low64 >> 35;
+			h.low64 *= XXH3_PRIME_MX2;
+			h.low64 ^= h.low64 >> 28;
+			h.high64 = _xxh3_avalanche(h.high64);
+			return h;
+		}
+
+		if (p_len > 0) {
+			uint8_t c1 = p_input[0];
+			uint8_t c2 = p_input[p_len >> 1];
+			uint8_t c3 = p_input[p_len - 1];
+			uint32_t combinedl = ((uint32_t)c1 << 16) | ((uint32_t)c2 << 24) | ((uint32_t)c3 << 0) | ((uint32_t)p_len << 8);
+			uint32_t combinedh = _xxh3_rotl32(BSWAP32(combinedl), 13);
+			uint64_t bitflipl = (_xxh3_read32(secret) ^ _xxh3_read32(secret + 4)) + p_seed;
+			uint64_t bitfliph = (_xxh3_read32(secret + 8) ^ _xxh3_read32(secret + 12)) - p_seed;
+			h.low64 = _xxh3_xxh64_avalanche((uint64_t)combinedl ^ bitflipl);
+			h.high64 = _xxh3_xxh64_avalanche((uint64_t)combinedh ^ bitfliph);
+			return h;
+		}
+
+		h.low64 = _xxh3_xxh64_avalanche(p_seed ^ (_xxh3_read64(secret + 64) ^ _xxh3_read64(secret + 72)));
+		h.high64 = _xxh3_xxh64_avalanche(p_seed ^ (_xxh3_read64(secret + 80) ^ _xxh3_read64(secret + 88)));
+		return h;
+	}
+
+	HashXXH3_128 acc;
+	acc.low64 = p_len * XXH3_PRIME64_1;
+	acc.high64 = 0;
+
+	if (p_len <= 128) {
+		if (p_len > 32) {
+			if (p_len > 64) {
+				if (p_len > 96) {
+					acc = _xxh3_mix32(acc, p_input + 48, p_input + p_len - 64, secret + 96, p_seed);
+				}
+				acc = _xxh3_mix32(acc, p_input + 32, p_input + p_len - 48, secret + 64, p_seed);
+			}
+			acc = _xxh3_mix32(acc, p_input + 16, p_input + p_len - 32, secret + 32, p_seed);
+		}
+		acc = _xxh3_mix32(acc, p_input, p_input + p_len - 16, secret, p_seed);
+	} else {
+		for (uint32_t i = 32; i < 160; i += 32) {
+			acc = _xxh3_mix32(acc, p_input + i - 32, p_input + i - 16, secret + i - 32, p_seed);
+		}
+
+		acc.low64 = _xxh3_avalanche(acc.low64);
+		acc.high64 = _xxh3_avalanche(acc.high64);
+
+		for (uint32_t i = 160; i <= p_len; i += 32) {
+			acc = _xxh3_mix32(acc, p_input + i - 32, p_input + i - 16, secret + XXH3_MIDSIZE_STARTOFFSET + i - 160, p_seed);
+		}
+
+		acc = _xxh3_mix32(acc, p_input + p_len - 16, p_input + p_len - 32, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16, (uint64_t)0 - p_seed);
+	}
+
+	h.low64 = acc.low64 + acc.high64;
+	h.high64 = (acc.low64 * XXH3_PRIME64_1) + (acc.high64 * XXH3_PRIME64_4) + ((p_len - p_seed) * XXH3_PRIME64_2);
+	h.low64 = _xxh3_avalanche(h.low64);
+	h.high64 = (uint64_t)0 - _xxh3_avalanche(h.high64);
+	return h;
+}
+
+// ==== Long inputs. The accumulator loop is the only part that is worth vectorizing. ====
+
+// Runs p_stripes 64 byte stripes through the 8 accumulators. The secret advances 8 bytes per stripe.
+typedef void (*XXH3AccumulateFunc)(uint64_t *r_acc, const uint8_t *p_input, const uint8_t *p_secret, size_t p_stripes);
+typedef void (*XXH3ScrambleFunc)(uint64_t *r_acc, const uint8_t *p_secret);
+
+static void _xxh3_accumulate_scalar(uint64_t *r_acc, const uint8_t *p_input, const uint8_t *p_secret, size_t p_stripes) {
+	uint64_t acc[8];
+	memcpy(acc, r_acc, sizeof(acc));
+
+	for (size_t n = 0; n < p_stripes; ++n) {
+		const uint8_t *input = p_input + n * XXH3_STRIPE_LEN;
+		const uint8_t *secret = p_secret + n * XXH3_SECRET_CONSUME_RATE;
+
+		for (int i = 0; i < 8; ++i) {
+			uint64_t data_val = _xxh3_read64(input + i * 8);
+			uint64_t data_key = data_val ^ _xxh3_read64(secret + i * 8);
+			acc[i ^ 1] += data_val;
+			acc[i] += (uint64_t)(uint32_t)data_key * (uint64_t)(data_key >> 32);
+		}
+	}
+
+	memcpy(r_acc, acc, sizeof(acc));
+}
+
+static void _xxh3_scramble_scalar(uint64_t *r_acc, const uint8_t *p_secret) {
+	for (int i = 0; i < 8; ++i) {
+		uint64_t acc = r_acc[i];
+		acc ^= acc >> 47;
+		acc ^= _xxh3_read64(p_secret + i * 8);
+		acc *= XXH3_PRIME32_1;
+		r_acc[i] = acc;
+	}
+}
+
+#ifdef XXH3_SSE2
+static void _xxh3_accumulate_sse2(uint64_t *r_acc, const uint8_t *p_input, const uint8_t *p_secret, size_t p_stripes) {
+	__m128i acc[4];
+
+	for (int i = 0; i < 4; ++i) {
+		acc[i] = _mm_loadu_si128((const __m128i *)r_acc + i);
+	}
+
+	for (size_t n = 0; n < p_stripes; ++n) {
+		const __m128i *input = (const __m128i *)(p_input + n * XXH3_STRIPE_LEN);
+		const __m128i *secret = (const __m128i *)(p_secret + n * XXH3_SECRET_CONSUME_RATE);
+
+		for (int i = 0; i < 4; ++i) {
+			__m128i data_vec = _mm_loadu_si128(input + i);
+			__m128i key_vec = _mm_loadu_si128(secret + i);
+			__m128i data_key = _mm_xor_si128(data_vec, key_vec);
+			// 32x32 -> 64 multiply of the low and high halves of every lane.
+			__m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+			__m128i product = _mm_mul_epu32(data_key, data_key_hi);
+			// The raw input is added to the neighbouring lane.
+			__m128i data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+			acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, data_swap));
+		}
+	}
+
+	for (int i = 0; i < 4; ++i) {
+		_mm_storeu_si128((__m128i *)r_acc + i, acc[i]);
+	}
+}
+
+static void _xxh3_scramble_sse2(uint64_t *r_acc, const uint8_t *p_secret) {
+	const __m128i prime32 = _mm_set1_epi32((int)XXH3_PRIME32_1);
+
+	for (int i = 0; i < 4; ++i) {
+		__m128i acc = _mm_loadu_si128((const __m128i *)r_acc + i);
+		acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+		acc = _mm_xor_si128(acc, _mm_loadu_si128((const __m128i *)p_secret + i));
+
+		// 64 bit multiply by a 32 bit constant.
+		__m128i acc_hi = _mm_shuffle_epi32(acc, _MM_SHUFFLE(0, 3, 0, 1));
+		__m128i prod_lo = _mm_mul_epu32(acc, prime32);
+		__m128i prod_hi = _mm_mul_epu32(acc_hi, prime32);
+		_mm_storeu_si128((__m128i *)r_acc + i, _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32)));
+	}
+}
+#endif
+
+#ifdef XXH3_AVX2
+XXH3_TARGET_AVX2 static void _xxh3_accumulate_avx2(uint64_t *r_acc, const uint8_t *p_input, const uint8_t *p_secret, size_t p_stripes) {
+	__m256i acc0 = _mm256_loadu_si256((const __m256i *)r_acc);
+	__m256i acc1 = _mm256_loadu_si256((const __m256i *)r_acc + 1);
+
+	for (size_t n = 0; n < p_stripes; ++n) {
+		const __m256i *input = (const __m256i *)(p_input + n * XXH3_STRIPE_LEN);
+		const __m256i *secret = (const __m256i *)(p_secret + n * XXH3_SECRET_CONSUME_RATE);
+
+		__m256i data_vec0 = _mm256_loadu_si256(input);
+		__m256i data_vec1 = _mm256_loadu_si256(input + 1);
+		__m256i data_key0 = _mm256_xor_si256(data_vec0, _mm256_loadu_si256(secret));
+		__m256i data_key1 = _mm256_xor_si256(data_vec1, _mm256_loadu_si256(secret + 1));
+
+		__m256i product0 = _mm256_mul_epu32(data_key0, _mm256_srli_epi64(data_key0, 32));
+		__m256i product1 = _mm256_mul_epu32(data_key1, _mm256_srli_epi64(data_key1, 32));
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data_vec0, _MM_SHUFFLE(1, 0, 3, 2))));
+		acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data_vec1, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	_mm256_storeu_si256((__m256i *)r_acc, acc0);
+	_mm256_storeu_si256((__m256i *)r_acc + 1, acc1);
+}
+
+XXH3_TARGET_AVX2 static void _xxh3_scramble_avx2(uint64_t *r_acc, const uint8_t *p_secret) {
+	const __m256i prime32 = _mm256_set1_epi32((int)XXH3_PRIME32_1);
+
+	for (int i = 0; i < 2; ++i) {
+		__m256i acc = _mm256_loadu_si256((const __m256i *)r_acc + i);
+		acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+		acc = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i *)p_secret + i));
+
+		__m256i prod_lo = _mm256_mul_epu32(acc, prime32);
+		__m256i prod_hi = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime32);
+		_mm256_storeu_si256((__m256i *)r_acc + i, _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32)));
+	}
+}
+
+static bool _xxh3_cpu_has_avx2() {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	int info[4];
+	__cpuid(info, 0);
+
+	if (info[0] < 7) {
+		return false;
+	}
+
+	__cpuid(info, 1);
+
+	// AVX and OSXSAVE, and the OS has to save the YMM registers.
+	if ((info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28))) {
+		return false;
+	}
+
+	if ((_xgetbv(0) & 6) != 6) {
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#endif
+}
+#endif
+
+static HashXXH3Implementation _xxh3_implementation = HASH_XXH3_IMPLEMENTATION_SCALAR;
+static XXH3AccumulateFunc _xxh3_accumulate = _xxh3_accumulate_scalar;
+static XXH3ScrambleFunc _xxh3_scramble = _xxh3_scramble_scalar;
+
+void hash_xxh3_set_implementation(HashXXH3Implementation p_implementation) {
+#ifdef XXH3_AVX2
+	if ((p_implementation == HASH_XXH3_IMPLEMENTATION_AUTO || p_implementation == HASH_XXH3_IMPLEMENTATION_AVX2) && _xxh3_cpu_has_avx2()) {
+		_xxh3_implementation = HASH_XXH3_IMPLEMENTATION_AVX2;
+		_xxh3_accumulate = _xxh3_accumulate_avx2;
+		_xxh3_scramble = _xxh3_scramble_avx2;
+		return;
+	}
+#endif
+
+#ifdef XXH3_SSE2
+	if (p_implementation != HASH_XXH3_IMPLEMENTATION_SCALAR) {
+		_xxh3_implementation = HASH_XXH3_IMPLEMENTATION_SSE2;
+		_xxh3_accumulate = _xxh3_accumulate_sse2;
+		_xxh3_scramble = _xxh3_scramble_sse2;
+		return;
+	}
+#endif
+
+	_xxh3_implementation = HASH_XXH3_IMPLEMENTATION_SCALAR;
+	_xxh3_accumulate = _xxh3_accumulate_scalar;
+	_xxh3_scramble = _xxh3_scramble_scalar;
+}
+
+HashXXH3Implementation hash_xxh3_get_implementation() {
+	return _xxh3_implementation;
+}
+
+// Selects the best path once, during static initialization.
+static struct XXH3AutoSelect {
+	XXH3AutoSelect() {
+		hash_xxh3_set_implementation(HASH_XXH3_IMPLEMENTATION_AUTO);
+	}
+} _xxh3_auto_select;
+
+static _FORCE_INLINE_ void _xxh3_init_acc(uint64_t *r_acc) {
+	r_acc[0] = XXH3_PRIME32_3;
+	r_acc[1] = XXH3_PRIME64_1;
+	r_acc[2] = XXH3_PRIME64_2;
+	r_acc[3] = XXH3_PRIME64_3;
+	r_acc[4] = XXH3_PRIME64_4;
+	r_acc[5] = XXH3_PRIME32_2;
+	r_acc[6] = XXH3_PRIME64_5;
+	r_acc[7] = XXH3_PRIME32_1;
+}
+
+static _FORCE_INLINE_ uint64_t _xxh3_merge_accs(const uint64_t *p_acc, const uint8_t *p_secret, uint64_t p_start) {
+	uint64_t result = p_start;
+
+	for (int i = 0; i < 4; ++i) {
+		result += _xxh3_mul128_fold64(p_acc[2 * i] ^ _xxh3_read64(p_secret + 16 * i), p_acc[2 * i + 1] ^ _xxh3_read64(p_secret + 16 * i + 8));
+	}
+
+	return _xxh3_avalanche(result);
+}
+
+static void _xxh3_hash_long(uint64_t *r_acc, const uint8_t *p_input, uint64_t p_len, const uint8_t *p_secret) {
+	XXH3AccumulateFunc accumulate = _xxh3_accumulate;
+	XXH3ScrambleFunc scramble = _xxh3_scramble;
+
+	uint64_t blocks = (p_len - 1) / XXH3_BLOCK_LEN;
+
+	for (uint64_t n = 0; n < blocks; ++n) {
+		accumulate(r_acc, p_input + n * XXH3_BLOCK_LEN, p_secret, XXH3_STRIPES_PER_BLOCK);
+		scramble(r_acc, p_secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+	}
+
+	size_t stripes = (size_t)(((p_len - 1) - (XXH3_BLOCK_LEN * blocks)) / XXH3_STRIPE_LEN);
+	accumulate(r_acc, p_input + blocks * XXH3_BLOCK_LEN, p_secret, stripes);
+
+	// The last stripe always ends at the end of the input, it can overlap the previous one.
+	accumulate(r_acc, p_input + p_len - XXH3_STRIPE_LEN, p_secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - XXH3_SECRET_LASTACC_START, 1);
+}
+
+uint64_t hash_xxh3_64(const void *p_data, uint64_t p_len, uint64_t p_seed) {
+	const uint8_t *input = (const uint8_t *)p_data;
+
+	if (p_len <= XXH3_MIDSIZE_MAX) {
+		return _xxh3_64_short(input, p_len, p_seed);
+	}
+
+	uint8_t custom_secret[XXH3_SECRET_SIZE];
+	const uint8_t *secret = _xxh3_default_secret;
+
+	if (p_seed != 0) {
+		_xxh3_init_secret(custom_secret, p_seed);
+		secret = custom_secret;
+	}
+
+	uint64_t acc[8];
+	_xxh3_init_acc(acc);
+	_xxh3_hash_long(acc, input, p_len, secret);
+
+	return _xxh3_merge_accs(acc, secret + XXH3_SECRET_MERGEACCS_START, p_len * XXH3_PRIME64_1);
+}
+
+HashXXH3_128 hash_xxh3_128(const void *p_data, uint64_t p_len, uint64_t p_seed) {
+	const uint8_t *input = (const uint8_t *)p_data;
+
+	if (p_len <= XXH3_MIDSIZE_MAX) {
+		return _xxh3_128_short(input, p_len, p_seed);
+	}
+
+	uint8_t custom_secret[XXH3_SECRET_SIZE];
+	const uint8_t *secret = _xxh3_default_secret;
+
+	if (p_seed != 0) {
+		_xxh3_init_secret(custom_secret, p_seed);
+		secret = custom_secret;
+	}
+
+	uint64_t acc[8];
+	_xxh3_init_acc(acc);
+	_xxh3_hash_long(acc, input, p_len, secret);
+
+	HashXXH3_128 h;
+	h.low64 = _xxh3_merge_accs(acc, secret + XXH3_SECRET_MERGEACCS_START, p_len * XXH3_PRIME64_1);
+	h.high64 = _xxh3_merge_accs(acc, secret + XXH3_SECRET_SIZE - sizeof(acc) - XXH3_SECRET_MERGEACCS_START, ~(p_len * XXH3_PRIME64_2));
+	return h;
+}
+
+// ==== Streaming ====
+
+// Like the block loop in _xxh3_hash_long(), but it can start and stop in the middle of a block.
+static const uint8_t *_xxh3_consume_stripes(uint64_t *r_acc, uint32_t *r_stripes_so_far, const uint8_t *p_input, size_t p_stripes, const uint8_t *p_secret) {
+	const uint8_t *secret = p_secret + *r_stripes_so_far * XXH3_SECRET_CONSUME_RATE;
+
+	while (p_stripes >= XXH3_STRIPES_PER_BLOCK - *r_stripes_so_far) {
+		size_t n = XXH3_STRIPES_PER_BLOCK - *r_stripes_so_far;
+
+		_xxh3_accumulate(r_acc, p_input, secret, n);
+		_xxh3_scramble(r_acc, p_secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+
+		p_input += n * XXH3_STRIPE_LEN;
+		p_stripes -= n;
+		*r_stripes_so_far = 0;
+		secret = p_secret;
+	}
+
+	if (p_stripes > 0) {
+		_xxh3_accumulate(r_acc, p_input, secret, p_stripes);
+		p_input += p_stripes * XXH3_STRIPE_LEN;
+		*r_stripes_so_far += p_stripes;
+	}
+
+	return p_input;
+}
+
+void hash_xxh3_reset(HashXXH3State *r_state, uint64_t p_seed) {
+	ERR_FAIL_COND(!r_state);
+
+	_xxh3_init_acc(r_state->acc);
+	_xxh3_init_secret(r_state->secret, p_seed);
+	r_state->total_len = 0;
+	r_state->seed = p_seed;
+	r_state->buffered_size = 0;
+	r_state->stripes_so_far = 0;
+}
+
+void hash_xxh3_update(HashXXH3State *r_state, const void *p_data, uint64_t p_len) {
+	ERR_FAIL_COND(!r_state);
+
+	if (p_len == 0) {
+		return;
+	}
+
+	ERR_FAIL_COND(!p_data);
+
+	const uint8_t *input = (const uint8_t *)p_data;
+	const uint8_t *const end = input + p_len;
+
+	r_state->total_len += p_len;
+
+	if (p_len <= XXH3_BUFFER_SIZE - r_state->buffered_size) {
+		memcpy(r_state->buffer + r_state->buffered_size, input, p_len);
+		r_state->buffered_size += (uint32_t)p_len;
+		return;
+	}
+
+	// The buffer is only consumed once more data arrives, so the last stripe is always available for the digest.
+	if (r_state->buffered_size) {
+		uint32_t load_size = XXH3_BUFFER_SIZE - r_state->buffered_size;
+		memcpy(r_state->buffer + r_state->buffered_size, input, load_size);
+		input += load_size;
+
+		_xxh3_consume_stripes(r_state->acc, &r_state->stripes_so_far, r_state->buffer, XXH3_BUFFER_STRIPES, r_state->secret);
+		r_state->buffered_size = 0;
+	}
+
+	if (end - input > XXH3_BUFFER_SIZE) {
+		size_t stripes = (size_t)(end - 1 - input) / XXH3_STRIPE_LEN;
+		input = _xxh3_consume_stripes(r_state->acc, &r_state->stripes_so_far, input, stripes, r_state->secret);
+
+		// Keep the last consumed stripe, the digest might need part of it.
+		memcpy(r_state->buffer + XXH3_BUFFER_SIZE - XXH3_STRIPE_LEN, input - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN);
+	}
+
+	memcpy(r_state->buffer, input, end - input);
+	r_state->buffered_size = (uint32_t)(end - input);
+}
+
+static void _xxh3_digest_long(uint64_t *r_acc, const HashXXH3State *p_state) {
+	memcpy(r_acc, p_state->acc, sizeof(p_state->acc));
+
+	const uint8_t *last_stripe;
+	uint8_t last_stripe_buf[XXH3_STRIPE_LEN];
+
+	if (p_state->buffered_size >= XXH3_STRIPE_LEN) {
+		size_t stripes = (p_state->buffered_size - 1) / XXH3_STRIPE_LEN;
+		uint32_t stripes_so_far = p_state->stripes_so_far;
+		_xxh3_consume_stripes(r_acc, &stripes_so_far, p_state->buffer, stripes, p_state->secret);
+
+		last_stripe = p_state->buffer + p_state->buffered_size - XXH3_STRIPE_LEN;
+	} else {
+		// The start of the last stripe is still at the end of the buffer.
+		uint32_t catchup_size = XXH3_STRIPE_LEN - p_state->buffered_size;
+		memcpy(last_stripe_buf, p_state->buffer + XXH3_BUFFER_SIZE - catchup_size, catchup_size);
+		memcpy(last_stripe_buf + catchup_size, p_state->buffer, p_state->buffered_size);
+
+		last_stripe = last_stripe_buf;
+	}
+
+	_xxh3_accumulate(r_acc, last_stripe, p_state->secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - XXH3_SECRET_LASTACC_START, 1);
+}
+
+uint64_t hash_xxh3_digest_64(const HashXXH3State *p_state) {
+	ERR_FAIL_COND_V(!p_state, 0);
+
+	if (p_state->total_len <= XXH3_MIDSIZE_MAX) {
+		return _xxh3_64_short(p_state->buffer, p_state->total_len, p_state->seed);
+	}
+
+	uint64_t acc[8];
+	_xxh3_digest_long(acc, p_state);
+
+	return _xxh3_merge_accs(acc, p_state->secret + XXH3_SECRET_MERGEACCS_START, p_state->total_len * XXH3_PRIME64_1);
+}
+
+HashXXH3_128 hash_xxh3_digest_128(const HashXXH3State *p_state) {
+	HashXXH3_128 h;
+	h.low64 = 0;
+	h.high64 = 0;
+
+	ERR_FAIL_COND_V(!p_state, h);
+
+	if (p_state->total_len <= XXH3_MIDSIZE_MAX) {
+		return _xxh3_128_short(p_state->buffer, p_state->total_len, p_state->seed);
+	}
+
+	uint64_t acc[8];
+	_xxh3_digest_long(acc, p_state);
+
+	h.low64 = _xxh3_merge_accs(acc, p_state->secret + XXH3_SECRET_MERGEACCS_START, p_state->total_len * XXH3_PRIME64_1);
+	h.high64 = _xxh3_merge_accs(acc, p_state->secret + XXH3_SECRET_SIZE - sizeof(acc) - XXH3_SECRET_MERGEACCS_START, ~(p_state->total_len * XXH3_PRIME64_2));
+	return h;
+}
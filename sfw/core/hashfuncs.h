@@ -22,6 +22,7 @@
 #include "core/vector4i.h"
 #include "core/string_name.h"
 #include "core/ustring.h"
+#include "core/utf8_string.h"
 #include "core/typedefs.h"
 //--STRIP
 
@@ -205,6 +206,51 @@ static _FORCE_INLINE_ uint32_t hash_murmur3_buffer(const void *key, int length,
 	return hash_fmix32(h1);
 }
 
+// XXH3 (xxHash 0.8), 64 and 128 bit. Fast non-cryptographic hash for big buffers, e.g. content addressed
+// caches or deduplication. The results are identical to the reference implementation's
+// XXH3_64bits_withSeed() / XXH3_128bits_withSeed().
+// Long inputs are processed with SSE2 or AVX2 when the CPU has them (AVX2 is detected at runtime).
+
+struct HashXXH3_128 {
+	uint64_t low64;
+	uint64_t high64;
+
+	_FORCE_INLINE_ bool operator==(const HashXXH3_128 &p_other) const { return low64 == p_other.low64 && high64 == p_other.high64; }
+	_FORCE_INLINE_ bool operator!=(const HashXXH3_128 &p_other) const { return low64 != p_other.low64 || high64 != p_other.high64; }
+};
+
+// Streaming state. Initialize it with hash_xxh3_reset().
+struct HashXXH3State {
+	uint64_t acc[8];
+	uint8_t secret[192];
+	uint8_t buffer[256];
+	uint64_t total_len;
+	uint64_t seed;
+	uint32_t buffered_size;
+	uint32_t stripes_so_far;
+};
+
+enum HashXXH3Implementation {
+	HASH_XXH3_IMPLEMENTATION_AUTO = 0,
+	HASH_XXH3_IMPLEMENTATION_SCALAR,
+	HASH_XXH3_IMPLEMENTATION_SSE2,
+	HASH_XXH3_IMPLEMENTATION_AVX2,
+};
+
+uint64_t hash_xxh3_64(const void *p_data, uint64_t p_len, uint64_t p_seed = 0);
+HashXXH3_128 hash_xxh3_128(const void *p_data, uint64_t p_len, uint64_t p_seed = 0);
+
+void hash_xxh3_reset(HashXXH3State *r_state, uint64_t p_seed = 0);
+void hash_xxh3_update(HashXXH3State *r_state, const void *p_data, uint64_t p_len);
+// The state is not modified, more data can be added afterwards.
+uint64_t hash_xxh3_digest_64(const HashXXH3State *p_state);
+HashXXH3_128 hash_xxh3_digest_128(const HashXXH3State *p_state);
+
+// Forces a code path, mostly for benchmarks and testing. Unsupported ones fall back to the best available.
+// Not thread safe, call it before hashing anything.
+void hash_xxh3_set_implementation(HashXXH3Implementation p_implementation);
+HashXXH3Implementation hash_xxh3_get_implementation();
+
 static inline uint32_t hash_djb2_one_float(double p_in, uint32_t p_prev = 5381) {
 	union {
 		double d;
@@ -292,6 +338,7 @@ struct HashMapHasherDefault {
 	static _FORCE_INLINE_ uint32_t hash(const Ref<T> &p_ref) { return hash_one_uint64((uint64_t)p_ref.operator->()); }
 
 	static _FORCE_INLINE_ uint32_t hash(const String &p_string) { return p_string.hash(); }
+	static _FORCE_INLINE_ uint32_t hash(const Utf8String &p_string) { return p_string.hash(); }
 	static _FORCE_INLINE_ uint32_t hash(const char *p_cstr) { return hash_djb2(p_cstr); }
 	static _FORCE_INLINE_ uint32_t hash(const wchar_t p_wchar) { return hash_fmix32(p_wchar); }
 	static _FORCE_INLINE_ uint32_t hash(const char16_t p_uchar) { return hash_fmix32(p_uchar); }
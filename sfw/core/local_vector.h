@@ -16,7 +16,8 @@
 #include "core/memory.h"
 //--STRIP
 
-template <class T, class U = uint32_t, bool force_trivial = false>
+// A is the allocator, it needs alloc(), realloc() and free() (see DefaultAllocator and ArenaAllocator).
+template <class T, class U = uint32_t, bool force_trivial = false, class A = DefaultAllocator>
 class LocalVector {
 protected:
 	U count = 0;
@@ -39,7 +40,7 @@ public:
 			} else {
 				capacity <<= 1;
 			}
-			data = (T *)memrealloc(data, capacity * sizeof(T));
+			data = (T *)A::realloc(data, capacity * sizeof(T));
 			CRASH_COND_MSG(!data, "Out of memory");
 		}
 
@@ -109,7 +110,7 @@ public:
 	_FORCE_INLINE_ void reset() {
 		clear();
 		if (data) {
-			memfree(data);
+			A::free(data);
 			data = nullptr;
 			capacity = 0;
 		}
@@ -120,7 +121,7 @@ public:
 		p_size = nearest_power_of_2_templated(p_size);
 		if (!p_allow_shrink ? p_size > capacity : ((p_size >= count) && (p_size != capacity))) {
 			capacity = p_size;
-			data = (T *)memrealloc(data, capacity * sizeof(T));
+			data = (T *)A::realloc(data, capacity * sizeof(T));
 			CRASH_COND_MSG(!data, "Out of memory");
 		}
 	}
@@ -142,7 +143,7 @@ public:
 				while (capacity < p_size) {
 					capacity <<= 1;
 				}
-				data = (T *)memrealloc(data, capacity * sizeof(T));
+				data = (T *)A::realloc(data, capacity * sizeof(T));
 				CRASH_COND_MSG(!data, "Out of memory");
 			}
 			if (!HAS_TRIVIAL_CONSTRUCTOR(T) && !force_trivial) {
@@ -294,8 +295,8 @@ public:
 };
 
 // Integer default version
-template <class T, class I = int32_t, bool force_trivial = false>
-class LocalVectori : public LocalVector<T, I, force_trivial> {
+template <class T, class I = int32_t, bool force_trivial = false, class A = DefaultAllocator>
+class LocalVectori : public LocalVector<T, I, force_trivial, A> {
 };
 
 //--STRIP
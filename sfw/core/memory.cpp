@@ -7,6 +7,8 @@
 #include "core/memory.h"
 
 #include "core/error_macros.h"
+#include "core/memory_arena.h"
+#include "core/memory_profiler.h"
 #include "core/safe_refcount.h"
 
 #include <stdio.h>
@@ -14,7 +16,7 @@
 //--STRIP
 
 void *operator new(size_t p_size, const char *p_description) {
-	return Memory::alloc_static(p_size, false);
+	return Memory::alloc_static(p_size, false, p_description);
 }
 
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)) {
@@ -42,7 +44,14 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+static thread_local MemoryArena *_redirect_arena = nullptr;
+
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align, const char *p_description) {
+	if (unlikely(_redirect_arena != nullptr)) {
+		// Arena allocations always have the pad.
+		return _redirect_arena->alloc(p_bytes);
+	}
+
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
 #else
@@ -65,15 +74,23 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 		uint64_t new_mem_usage = mem_usage.add(p_bytes);
 		max_usage.exchange_if_greater(new_mem_usage);
 #endif
-		return s8 + PAD_ALIGN;
-	} else {
-		return mem;
+		mem = s8 + PAD_ALIGN;
 	}
+
+	if (unlikely(MemoryProfiler::is_active())) {
+		MemoryProfiler::_on_alloc(mem, p_bytes, p_description);
+	}
+
+	return mem;
 }
 
-void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
+void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align, const char *p_description) {
 	if (p_memory == nullptr) {
-		return alloc_static(p_bytes, p_pad_align);
+		return alloc_static(p_bytes, p_pad_align, p_description);
+	}
+
+	if (unlikely(_redirect_arena != nullptr) && _redirect_arena->owns(p_memory)) {
+		return _redirect_arena->realloc(p_memory, p_bytes);
 	}
 
 	uint8_t *mem = (uint8_t *)p_memory;
@@ -98,6 +115,10 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
+			if (unlikely(MemoryProfiler::is_active())) {
+				MemoryProfiler::_on_free(p_memory);
+			}
+
 			free(mem);
 			return nullptr;
 		} else {
@@ -110,6 +131,10 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 			*s = p_bytes;
 
+			if (unlikely(MemoryProfiler::is_active())) {
+				MemoryProfiler::_on_realloc(p_memory, mem + PAD_ALIGN, p_bytes);
+			}
+
 			return mem + PAD_ALIGN;
 		}
 	} else {
@@ -117,6 +142,14 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
+		if (unlikely(MemoryProfiler::is_active())) {
+			if (p_bytes == 0) {
+				MemoryProfiler::_on_free(p_memory);
+			} else {
+				MemoryProfiler::_on_realloc(p_memory, mem, p_bytes);
+			}
+		}
+
 		return mem;
 	}
 }
@@ -124,6 +157,11 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	ERR_FAIL_COND(p_ptr == nullptr);
 
+	if (unlikely(_redirect_arena != nullptr) && _redirect_arena->owns(p_ptr)) {
+		_redirect_arena->free(p_ptr);
+		return;
+	}
+
 	uint8_t *mem = (uint8_t *)p_ptr;
 
 #ifdef DEBUG_ENABLED
@@ -134,6 +172,10 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	alloc_count.decrement();
 
+	if (unlikely(MemoryProfiler::is_active())) {
+		MemoryProfiler::_on_free(p_ptr);
+	}
+
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
@@ -168,6 +210,14 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+void Memory::set_thread_redirect_arena(MemoryArena *p_arena) {
+	_redirect_arena = p_arena;
+}
+
+MemoryArena *Memory::get_thread_redirect_arena() {
+	return _redirect_arena;
+}
+
 _GlobalNil::_GlobalNil() {
 	color = 1;
 	left = this;
@@ -0,0 +1,240 @@
+//--STRIP
+#include "core/memory_arena.h"
+
+#include "core/error_macros.h"
+
+#include <string.h>
+//--STRIP
+
+void *MemoryArena::alloc(size_t p_bytes) {
+	size_t size = HEADER_SIZE + ((p_bytes + 15) & ~(size_t)15);
+
+	if (unlikely(!_chunk || _chunk->used + size > _chunk->size)) {
+		if (!_add_chunk(size)) {
+			return NULL;
+		}
+	}
+
+	uint8_t *mem = _get_chunk_data(_chunk) + _chunk->used;
+	*(uint64_t *)mem = p_bytes;
+
+	_chunk->used += size;
+	_last = mem + HEADER_SIZE;
+
+	return _last;
+}
+
+void *MemoryArena::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return NULL;
+	}
+
+	uint64_t *size = (uint64_t *)((uint8_t *)p_ptr - HEADER_SIZE);
+	size_t old_size = *size;
+	size_t old_padded = (old_size + 15) & ~(size_t)15;
+	size_t new_padded = (p_bytes + 15) & ~(size_t)15;
+
+	if (new_padded <= old_padded) {
+		*size = p_bytes;
+		return p_ptr;
+	}
+
+	if (p_ptr == _last && _chunk->used + (new_padded - old_padded) <= _chunk->size) {
+		// The last allocation can just grow.
+		_chunk->used += new_padded - old_padded;
+		*size = p_bytes;
+		return p_ptr;
+	}
+
+	uint8_t *mem = (uint8_t *)alloc(p_bytes);
+	ERR_FAIL_COND_V(!mem, NULL);
+
+	// The second half of the header belongs to the caller (CowData keeps its refcount and size there).
+	memcpy(mem - HEADER_SIZE / 2, (uint8_t *)p_ptr - HEADER_SIZE / 2, old_size + HEADER_SIZE / 2);
+
+	return mem;
+}
+
+void MemoryArena::free(void *p_ptr) {
+	if (p_ptr && p_ptr == _last) {
+		_chunk->used = (uint8_t *)p_ptr - HEADER_SIZE - _get_chunk_data(_chunk);
+		_last = NULL;
+	}
+}
+
+bool MemoryArena::owns(const void *p_ptr) const {
+	for (Chunk *c = _chunk; c; c = c->prev) {
+		const uint8_t *data = _get_chunk_data(c);
+
+		if (p_ptr >= data && p_ptr < data + c->used) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+MemoryArena::Marker MemoryArena::get_marker() const {
+	Marker marker;
+
+	if (_chunk) {
+		marker.chunk = _chunk;
+		marker.used = _chunk->used;
+	}
+
+	return marker;
+}
+
+void MemoryArena::reset_to(const Marker &p_marker) {
+	while (_chunk && _chunk != p_marker.chunk) {
+		Chunk *c = _chunk;
+		_chunk = c->prev;
+
+		c->prev = _free_chunks;
+		_free_chunks = c;
+	}
+
+	ERR_FAIL_COND_MSG(p_marker.chunk && !_chunk, "The marker is not from this arena, or it was already reset past it.");
+
+	if (_chunk) {
+		_chunk->used = p_marker.used;
+	}
+
+	_last = NULL;
+}
+
+void MemoryArena::reset() {
+	reset_to(Marker());
+}
+
+void MemoryArena::release() {
+	reset();
+
+	// Might be called while this arena is the redirect target.
+	MemoryArena *redirect = Memory::get_thread_redirect_arena();
+	Memory::set_thread_redirect_arena(NULL);
+
+	while (_free_chunks) {
+		Chunk *c = _free_chunks;
+		_free_chunks = c->prev;
+
+		memfree(c);
+	}
+
+	Memory::set_thread_redirect_arena(redirect);
+}
+
+size_t MemoryArena::get_used() const {
+	size_t used = 0;
+
+	for (Chunk *c = _chunk; c; c = c->prev) {
+		used += c->used;
+	}
+
+	return used;
+}
+
+size_t MemoryArena::get_capacity() const {
+	size_t capacity = 0;
+
+	for (Chunk *c = _chunk; c; c = c->prev) {
+		capacity += c->size;
+	}
+
+	for (Chunk *c = _free_chunks; c; c = c->prev) {
+		capacity += c->size;
+	}
+
+	return capacity;
+}
+
+MemoryArena *MemoryArena::get_thread_arena() {
+	static thread_local MemoryArena arena;
+	return &arena;
+}
+
+MemoryArena::MemoryArena(size_t p_chunk_size) {
+	_chunk = NULL;
+	_free_chunks = NULL;
+	_chunk_size = p_chunk_size;
+	_last = NULL;
+}
+
+MemoryArena::~MemoryArena() {
+	release();
+}
+
+bool MemoryArena::_add_chunk(size_t p_min_size) {
+	// Reuse a kept chunk if one is big enough.
+	Chunk **prev = &_free_chunks;
+
+	for (Chunk *c = _free_chunks; c; c = c->prev) {
+		if (c->size >= p_min_size) {
+			*prev = c->prev;
+
+			c->prev = _chunk;
+			c->used = 0;
+			_chunk = c;
+
+			return true;
+		}
+
+		prev = &c->prev;
+	}
+
+	size_t size = MAX(_chunk_size, p_min_size);
+
+	Chunk *c;
+
+	{
+		// The chunks themselves come from the heap, even while this arena is the redirect target.
+		MemoryHeapScope heap_scope;
+		c = (Chunk *)memalloc(CHUNK_HEADER_SIZE + size);
+	}
+
+	ERR_FAIL_COND_V(!c, false);
+
+	c->prev = _chunk;
+	c->size = size;
+	c->used = 0;
+	_chunk = c;
+
+	return true;
+}
+
+MemoryArenaScope::MemoryArenaScope(bool p_redirect) {
+	_arena = MemoryArena::get_thread_arena();
+	_marker = _arena->get_marker();
+	_redirect = p_redirect;
+	_prev_redirect = NULL;
+
+	if (_redirect) {
+		_prev_redirect = Memory::get_thread_redirect_arena();
+		Memory::set_thread_redirect_arena(_arena);
+	}
+}
+
+MemoryArenaScope::MemoryArenaScope(MemoryArena *p_arena, bool p_redirect) {
+	_arena = p_arena ? p_arena : MemoryArena::get_thread_arena();
+	_marker = _arena->get_marker();
+	_redirect = p_redirect;
+	_prev_redirect = NULL;
+
+	if (_redirect) {
+		_prev_redirect = Memory::get_thread_redirect_arena();
+		Memory::set_thread_redirect_arena(_arena);
+	}
+}
+
+MemoryArenaScope::~MemoryArenaScope() {
+	if (_redirect) {
+		Memory::set_thread_redirect_arena(_prev_redirect);
+	}
+
+	_arena->reset_to(_marker);
+}
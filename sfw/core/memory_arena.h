@@ -0,0 +1,137 @@
+//--STRIP
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+//--STRIP
+
+//--STRIP
+#include "core/memory.h"
+#include "core/typedefs.h"
+
+#include <stddef.h>
+//--STRIP
+
+// Bump allocator for short lived data.
+//
+// Allocating is just moving a pointer forward in a chunk, freeing a single allocation does nothing
+// (except for the last one, which gets rolled back). Memory is given back all at once, with reset() or
+// by returning to a marker, usually through a MemoryArenaScope. Chunks are kept for reuse, so after
+// warming up a frame allocator doesn't touch the heap at all.
+//
+// Every allocation is 16 byte aligned and has the same 16 byte header as Memory::alloc_static(..., true)
+// allocations, so it can stand in for the heap everywhere, including CowData (Vector, String).
+//
+// Not thread safe, every thread should use its own (see get_thread_arena()).
+
+class MemoryArena {
+public:
+	enum {
+		DEFAULT_CHUNK_SIZE = 64 * 1024,
+	};
+
+	struct Marker {
+		void *chunk;
+		size_t used;
+
+		Marker() {
+			chunk = NULL;
+			used = 0;
+		}
+	};
+
+	void *alloc(size_t p_bytes);
+	// Grows in place if p_ptr is the last allocation.
+	void *realloc(void *p_ptr, size_t p_bytes);
+	void free(void *p_ptr);
+
+	bool owns(const void *p_ptr) const;
+
+	Marker get_marker() const;
+	// Releases everything that was allocated since p_marker was taken.
+	void reset_to(const Marker &p_marker);
+	// Releases every allocation, the chunks are kept.
+	void reset();
+	// Frees the chunks too.
+	void release();
+
+	// Bytes handed out (with headers and padding).
+	size_t get_used() const;
+	// Bytes in chunks, including the ones kept for reuse.
+	size_t get_capacity() const;
+
+	// The calling thread's own arena. Created on first use and freed when the thread exits.
+	// It's meant to be a frame allocator: reset() it (or use MemoryArenaScopes) once per frame.
+	static MemoryArena *get_thread_arena();
+
+	MemoryArena(size_t p_chunk_size = DEFAULT_CHUNK_SIZE);
+	~MemoryArena();
+
+protected:
+	struct Chunk {
+		Chunk *prev;
+		size_t size;
+		size_t used;
+	};
+
+	_FORCE_INLINE_ static uint8_t *_get_chunk_data(Chunk *p_chunk) {
+		return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE;
+	}
+
+	bool _add_chunk(size_t p_min_size);
+
+	enum {
+		HEADER_SIZE = PAD_ALIGN,
+		CHUNK_HEADER_SIZE = (sizeof(Chunk) + 15) & ~15,
+	};
+
+	// Current chunk, the previous ones are linked from it.
+	Chunk *_chunk;
+	// Chunks given back by resets.
+	Chunk *_free_chunks;
+	size_t _chunk_size;
+	void *_last;
+};
+
+// Releases everything allocated on an arena during its lifetime when it ends. Scopes can be nested.
+//
+// With p_redirect every allocation of the calling thread that goes through Memory (memalloc, memnew, Vector,
+// String, LocalVector, ...) comes from the arena too, until the scope ends. Nothing allocated that way may
+// outlive the scope. Heap blocks from before the scope are still freed / reallocated on the heap.
+// Allocations the engine keeps around on its own (ObjectDB pages, ObjectRCs, StringName entries) always use the heap,
+// see MemoryHeapScope. StringName copies the characters of the String it's made from, everything else keeps what
+// it's given: Strings, Vectors, Variants etc. passed to objects (set_meta(), signal binds, setters) or singletons
+// that outlive the scope must not be made inside it.
+//
+// {
+//     MemoryArenaScope scope(true);
+//     Vector<Vector2> points;
+//     ...
+// }
+
+class MemoryArenaScope {
+public:
+	_FORCE_INLINE_ MemoryArena *get_arena() const { return _arena; }
+
+	// Uses the calling thread's arena.
+	MemoryArenaScope(bool p_redirect = false);
+	MemoryArenaScope(MemoryArena *p_arena, bool p_redirect = false);
+	~MemoryArenaScope();
+
+protected:
+	MemoryArena *_arena;
+	MemoryArena::Marker _marker;
+	bool _redirect;
+	MemoryArena *_prev_redirect;
+};
+
+// For the allocator parameter of containers (List, LocalVector) and memnew_allocator(). Uses the calling
+// thread's arena, so the memory is only valid until that gets reset.
+class ArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return MemoryArena::get_thread_arena()->alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return MemoryArena::get_thread_arena()->realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { MemoryArena::get_thread_arena()->free(p_ptr); }
+};
+
+//--STRIP
+#endif
+//--STRIP
@@ -0,0 +1,100 @@
+//--STRIP
+#ifndef MEMORY_PROFILER_H
+#define MEMORY_PROFILER_H
+//--STRIP
+
+//--STRIP
+#include "core/safe_refcount.h"
+#include "core/typedefs.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+//--STRIP
+
+// Allocation tracking, for finding where the heap gets used.
+//
+// While it's running (start() / stop()) every allocation that goes through Memory is recorded, grouped by tag.
+// A tag is the innermost MemoryProfilerScope of the allocating thread, plus the call site of memnew / memalloc etc.
+// Call sites are only known if the build defines MEMORY_PROFILER_ENABLED (see MEMORY_CALLSITE in memory.h),
+// allocations from elsewhere (e.g. Vector and String growth) are grouped by scope only.
+//
+// For every tag it keeps counts, bytes, the live and peak live bytes, and a histogram of how long the freed
+// allocations lived. get_report() / print_report() give a table, get_snapshot() the raw numbers,
+// both can be called while it's running.
+//
+// MEMORY_PROFILER_SCOPE("physics");
+//
+// It has its own tables that don't use Memory. When it's not running, the cost is one flag check per allocation.
+
+class MemoryProfiler {
+public:
+	enum Lifetime {
+		LIFETIME_100_US = 0,
+		LIFETIME_1_MS,
+		LIFETIME_10_MS,
+		LIFETIME_100_MS,
+		LIFETIME_1_S,
+		LIFETIME_10_S,
+		LIFETIME_LONGER,
+		LIFETIME_MAX,
+	};
+
+	struct TagStats {
+		// NULL if the allocation wasn't in a scope.
+		const char *scope;
+		// Empty if the call site isn't known.
+		const char *site;
+
+		uint64_t alloc_count;
+		uint64_t realloc_count;
+		uint64_t free_count;
+		// Everything that was ever allocated, reallocs count the growth.
+		uint64_t total_bytes;
+
+		uint64_t live_count;
+		uint64_t live_bytes;
+		uint64_t peak_bytes;
+
+		// Freed allocations, by how long they lived.
+		uint64_t lifetimes[LIFETIME_MAX];
+	};
+
+	// Clears the previous results. Allocations that were made before starting are not tracked.
+	static void start();
+	static void stop();
+	_FORCE_INLINE_ static bool is_active() { return _active.is_set(); }
+	static void clear();
+
+	// Sorted by total bytes.
+	static Vector<TagStats> get_snapshot();
+	// Top p_max_entries tags. p_max_entries < 0 means all.
+	static String get_report(int p_max_entries = 40);
+	static void print_report(int p_max_entries = 40);
+
+	// Sets the calling thread's scope tag, returns the previous one. Use MemoryProfilerScope instead of calling this directly.
+	// p_tag has to stay valid (string literals are fine).
+	static const char *set_scope(const char *p_tag);
+	static const char *get_scope();
+
+	// Called by Memory.
+	static void _on_alloc(void *p_ptr, size_t p_bytes, const char *p_site);
+	static void _on_realloc(void *p_old_ptr, void *p_new_ptr, size_t p_bytes);
+	static void _on_free(void *p_ptr);
+
+protected:
+	static SafeFlag _active;
+};
+
+class MemoryProfilerScope {
+public:
+	_FORCE_INLINE_ MemoryProfilerScope(const char *p_tag) { _prev = MemoryProfiler::set_scope(p_tag); }
+	_FORCE_INLINE_ ~MemoryProfilerScope() { MemoryProfiler::set_scope(_prev); }
+
+protected:
+	const char *_prev;
+};
+
+#define MEMORY_PROFILER_SCOPE(m_tag) MemoryProfilerScope _memory_profiler_scope(m_tag)
+
+//--STRIP
+#endif
+//--STRIP
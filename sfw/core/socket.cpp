@@ -28,14 +28,23 @@
 #include <cerrno>
 
 #if defined(_WIN64) || defined(_WIN32)
+#include <io.h>
 #include <ws2tcpip.h>
 #else
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/types.h>
 #endif
 
 //--STRIP
 #include "core/error_macros.h"
+#include "core/file_access.h"
 #include "core/ustring.h"
 //--STRIP
 
@@ -230,7 +239,10 @@ int Socket::read(char *buffer, uint64_t len) {
 int Socket::send(const char *buffer, uint64_t len) {
 	//ERR_FAIL_COND_V(_socket == 0, -1);
 
-#if !defined(_WIN64) && !defined(_WIN32)
+#if defined(MSG_NOSIGNAL)
+	// A peer that closed the connection should result in EPIPE, not in a SIGPIPE.
+	return ::send(_socket, buffer, len, MSG_NOSIGNAL);
+#elif !defined(_WIN64) && !defined(_WIN32)
 	return write(_socket, buffer, len);
 #else
 	errno = 0;
@@ -238,6 +250,227 @@ int Socket::send(const char *buffer, uint64_t len) {
 #endif
 }
 
+int Socket::readv(const IOBuffer *p_buffers, int p_count) {
+	ERR_FAIL_COND_V(!p_buffers && p_count > 0, -1);
+
+	p_count = MIN(p_count, (int)SOCKET_IO_BUFFER_MAX);
+
+#if !defined(_WIN64) && !defined(_WIN32)
+	struct iovec iov[SOCKET_IO_BUFFER_MAX];
+
+	for (int i = 0; i < p_count; ++i) {
+		iov[i].iov_base = p_buffers[i].data;
+		iov[i].iov_len = p_buffers[i].size;
+	}
+
+	return ::readv(_socket, iov, p_count);
+#else
+	WSABUF bufs[SOCKET_IO_BUFFER_MAX];
+
+	for (int i = 0; i < p_count; ++i) {
+		bufs[i].buf = (CHAR *)p_buffers[i].data;
+		bufs[i].len = static_cast<ULONG>(p_buffers[i].size);
+	}
+
+	DWORD received = 0;
+	DWORD flags = 0;
+
+	if (WSARecv(_socket, bufs, p_count, &received, &flags, NULL, NULL) != 0) {
+		return -1;
+	}
+
+	return static_cast<int>(received);
+#endif
+}
+
+int Socket::writev(const IOBuffer *p_buffers, int p_count) {
+	ERR_FAIL_COND_V(!p_buffers && p_count > 0, -1);
+
+	p_count = MIN(p_count, (int)SOCKET_IO_BUFFER_MAX);
+
+#if !defined(_WIN64) && !defined(_WIN32)
+	struct iovec iov[SOCKET_IO_BUFFER_MAX];
+
+	for (int i = 0; i < p_count; ++i) {
+		iov[i].iov_base = p_buffers[i].data;
+		iov[i].iov_len = p_buffers[i].size;
+	}
+
+#if defined(MSG_NOSIGNAL)
+	// Same as send(), sendmsg() is the only vectored call that takes flags.
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = p_count;
+
+	return ::sendmsg(_socket, &msg, MSG_NOSIGNAL);
+#else
+	return ::writev(_socket, iov, p_count);
+#endif
+#else
+	WSABUF bufs[SOCKET_IO_BUFFER_MAX];
+
+	for (int i = 0; i < p_count; ++i) {
+		bufs[i].buf = (CHAR *)p_buffers[i].data;
+		bufs[i].len = static_cast<ULONG>(p_buffers[i].size);
+	}
+
+	DWORD sent = 0;
+
+	if (WSASend(_socket, bufs, p_count, &sent, 0, NULL, NULL) != 0) {
+		return -1;
+	}
+
+	return static_cast<int>(sent);
+#endif
+}
+
+int64_t Socket::send_file(int p_fd, uint64_t p_offset, uint64_t p_len) {
+	ERR_FAIL_COND_V(_socket == 0, -1);
+	ERR_FAIL_COND_V(p_fd < 0, -1);
+
+#if defined(__linux__)
+	int64_t sent = 0;
+
+	while ((uint64_t)sent < p_len) {
+		off_t offset = p_offset + sent;
+
+		// Linux transfers at most 0x7ffff000 bytes per call.
+		ssize_t n = ::sendfile(_socket, p_fd, &offset, MIN(p_len - sent, (uint64_t)0x7ffff000));
+
+		if (n > 0) {
+			sent += n;
+			continue;
+		}
+
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (n < 0 && sent == 0) {
+			return -1;
+		}
+
+		// Would block, or end of file
+		break;
+	}
+
+	return sent;
+#elif defined(__APPLE__)
+	off_t len = p_len;
+
+	// When it's interrupted, or would block, len is still set to the amount that got sent.
+	if (::sendfile(p_fd, _socket, p_offset, &len, NULL, 0) != 0 && len == 0) {
+		return -1;
+	}
+
+	return len;
+#elif defined(__FreeBSD__)
+	off_t sent = 0;
+
+	if (::sendfile(p_fd, _socket, p_offset, p_len, NULL, &sent, 0) != 0 && sent == 0) {
+		return -1;
+	}
+
+	return sent;
+#else
+	// No sendfile(), copy through a buffer.
+	char buffer[65536];
+	int64_t sent = 0;
+
+#if defined(_WIN64) || defined(_WIN32)
+	int64_t position = _telli64(p_fd);
+	_lseeki64(p_fd, p_offset, SEEK_SET);
+#endif
+
+	while ((uint64_t)sent < p_len) {
+		unsigned int chunk = static_cast<unsigned int>(MIN(p_len - sent, (uint64_t)sizeof(buffer)));
+
+#if defined(_WIN64) || defined(_WIN32)
+		int read = _read(p_fd, buffer, chunk);
+#else
+		int read = static_cast<int>(::pread(p_fd, buffer, chunk, p_offset + sent));
+#endif
+
+		if (read <= 0) {
+			break;
+		}
+
+		int n = send(buffer, read);
+
+		if (n < 0) {
+			if (sent == 0) {
+				sent = -1;
+			}
+
+			break;
+		}
+
+		sent += n;
+
+		if (n < read) {
+			break;
+		}
+	}
+
+#if defined(_WIN64) || defined(_WIN32)
+	_lseeki64(p_fd, position, SEEK_SET);
+#endif
+
+	return sent;
+#endif
+}
+
+int64_t Socket::send_file(FileAccess *p_file, uint64_t p_offset, uint64_t p_len) {
+	ERR_FAIL_COND_V(!p_file || !p_file->is_open(), -1);
+
+#if !defined(_WIN64) && !defined(_WIN32)
+	int fd = p_file->get_fd();
+
+	if (fd >= 0) {
+		return send_file(fd, p_offset, p_len);
+	}
+#endif
+
+	// Through the FileAccess api, e.g. for FileAccessMapped. On windows the descriptor would bypass the FILE buffer.
+	char buffer[65536];
+	int64_t sent = 0;
+
+	uint64_t position = p_file->get_position();
+	p_file->seek(p_offset);
+
+	while ((uint64_t)sent < p_len) {
+		uint64_t read = p_file->get_buffer((uint8_t *)buffer, MIN(p_len - sent, (uint64_t)sizeof(buffer)));
+
+		if (read == 0) {
+			break;
+		}
+
+		int n = send(buffer, read);
+
+		if (n < 0) {
+			if (sent == 0) {
+				sent = -1;
+			}
+
+			break;
+		}
+
+		sent += n;
+
+		if ((uint64_t)n < read) {
+			break;
+		}
+	}
+
+	// Keep errno for the caller (EAGAIN)
+	int err = errno;
+	p_file->seek(position);
+	errno = err;
+
+	return sent;
+}
+
 void Socket::set_tcp_nodelay(bool on) {
 	ERR_FAIL_COND(_socket == 0);
 
@@ -227,7 +227,7 @@ Error SubProcess::stop() {
 	return ret != 0 ? OK : FAILED;
 }
 
-Error SubProcess::poll() {
+Error SubProcess::poll(int p_timeout_msec) {
 	if (!_process_started) {
 		return FAILED;
 	}
@@ -293,6 +293,9 @@ Error SubProcess::send_data(const String &p_data) {
 	ERR_FAIL_V(ERR_BUG);
 }
 
+void SubProcess::close_write_std() {
+}
+
 bool SubProcess::is_process_running() const {
 	if (_process_id == 0) {
 		return false;
@@ -358,6 +361,8 @@ SubProcess::SubProcess() {
 
 	_read_std = true;
 	_read_std_err = false;
+	_separate_std_err = false;
+	_write_std = false;
 
 	_use_pipe_mutex = false;
 
@@ -386,13 +391,70 @@ SubProcess::~SubProcess() {
 #else
 
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+extern char **environ;
+
+static bool _sub_process_create_pipe(int r_fds[2]) {
+#if defined(__linux__)
+	return pipe2(r_fds, O_CLOEXEC) == 0;
+#else
+	if (pipe(r_fds) != 0) {
+		return false;
+	}
+
+	fcntl(r_fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(r_fds[1], F_SETFD, FD_CLOEXEC);
+
+	return true;
+#endif
+}
+
+static void _sub_process_close_fd(int &r_fd) {
+	if (r_fd >= 0) {
+		::close(r_fd);
+		r_fd = -1;
+	}
+}
+
+// Writing into the pipe of a process that already exited raises SIGPIPE. Block it for this thread,
+// and swallow it if it got raised.
+static ssize_t _sub_process_write(int p_fd, const char *p_data, size_t p_size) {
+	sigset_t sigpipe_mask;
+	sigset_t old_mask;
+	sigemptyset(&sigpipe_mask);
+	sigaddset(&sigpipe_mask, SIGPIPE);
+
+	pthread_sigmask(SIG_BLOCK, &sigpipe_mask, &old_mask);
+
+	ssize_t ret = ::write(p_fd, p_data, p_size);
+
+	if (ret < 0 && errno == EPIPE && !sigismember(&old_mask, SIGPIPE)) {
+		sigset_t pending;
+		sigpending(&pending);
+
+		if (sigismember(&pending, SIGPIPE)) {
+			int sig;
+			sigwait(&sigpipe_mask, &sig);
+		}
+
+		errno = EPIPE;
+	}
+
+	pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+	return ret;
+}
+
 Error SubProcess::start() {
 #ifdef __EMSCRIPTEN__
 	// Don't compile this code at all to avoid undefined references.
@@ -407,95 +469,128 @@ Error SubProcess::start() {
 		return ERR_BUSY;
 	}
 
-	if (_blocking && _read_output) {
-		String argss;
-		argss = "\"" + _executable_path + "\"";
+	_close_pipes();
+	_exitcode = 0;
 
-		for (int i = 0; i < _arguments.size(); i++) {
-			argss += String(" \"") + _arguments[i] + "\"";
-		}
+	Vector<CharString> cs;
+	cs.push_back(_executable_path.utf8());
+	for (int i = 0; i < _arguments.size(); i++) {
+		cs.push_back(_arguments[i].utf8());
+	}
 
-		if (_read_std_err) {
-			argss += " 2>&1"; // Read stderr too
-		} else {
-			argss += " 2>/dev/null"; //silence stderr
-		}
-		FILE *f = popen(argss.utf8().get_data(), "r");
+	Vector<char *> args;
+	for (int i = 0; i < cs.size(); i++) {
+		args.push_back((char *)cs[i].get_data());
+	}
+	args.push_back(0);
 
-		ERR_FAIL_COND_V_MSG(!f, ERR_CANT_OPEN, "Cannot pipe stream from process running with following arguments '" + argss + "'.");
+	// Without read_output everything is inherited, otherwise what's not read goes to /dev/null.
+	bool read_std = _read_output && _read_std;
+	bool read_std_err = _read_output && _read_std_err;
+	bool separate_std_err = read_std_err && _separate_std_err;
+	// A blocking call couldn't write it anyway.
+	bool write_std = _write_std && !_blocking;
 
-		char buf[65535];
+	int out_fds[2] = { -1, -1 };
+	int err_fds[2] = { -1, -1 };
+	int in_fds[2] = { -1, -1 };
 
-		while (fgets(buf, 65535, f)) {
-			if (_pipe_mutex) {
-				_pipe_mutex->lock();
-			}
-			_pipe += String::utf8(buf);
-			if (_pipe_mutex) {
-				_pipe_mutex->unlock();
-			}
-		}
-		int rv = pclose(f);
+	bool pipes_ok = true;
 
-		_exitcode = WEXITSTATUS(rv);
+	if (read_std || (read_std_err && !separate_std_err)) {
+		pipes_ok = pipes_ok && _sub_process_create_pipe(out_fds);
+	}
 
-		return OK;
+	if (separate_std_err) {
+		pipes_ok = pipes_ok && _sub_process_create_pipe(err_fds);
 	}
 
-	if (!_blocking && _read_output) {
-		String argss;
-		argss = "\"" + _executable_path + "\"";
+	if (write_std) {
+		pipes_ok = pipes_ok && _sub_process_create_pipe(in_fds);
+	}
 
-		for (int i = 0; i < _arguments.size(); i++) {
-			argss += String(" \"") + _arguments[i] + "\"";
+	if (!pipes_ok) {
+		for (int i = 0; i < 2; ++i) {
+			_sub_process_close_fd(out_fds[i]);
+			_sub_process_close_fd(err_fds[i]);
+			_sub_process_close_fd(in_fds[i]);
 		}
 
-		if (_read_std_err) {
-			argss += " 2>&1"; // Read stderr too
-		} else {
-			argss += " 2>/dev/null"; //silence stderr
-		}
+		ERR_FAIL_V_MSG(ERR_CANT_OPEN, "Cannot create pipes for process '" + _executable_path + "'.");
+	}
 
-		_process_fp = popen(argss.utf8().get_data(), "r");
+	// The pipe ends are all close on exec, dup2() clears that flag on the process' copies.
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
 
-		ERR_FAIL_COND_V_MSG(!_process_fp, ERR_CANT_OPEN, "Cannot pipe stream from process running with following arguments '" + argss + "'.");
+	if (write_std) {
+		posix_spawn_file_actions_adddup2(&actions, in_fds[0], 0);
+	}
 
-		return OK;
+	if (read_std) {
+		posix_spawn_file_actions_adddup2(&actions, out_fds[1], 1);
+	} else if (_read_output) {
+		posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
 	}
 
-	// We just run it, no need to worry about output
+	if (separate_std_err) {
+		posix_spawn_file_actions_adddup2(&actions, err_fds[1], 2);
+	} else if (read_std_err) {
+		posix_spawn_file_actions_adddup2(&actions, out_fds[1], 2);
+	} else if (_read_output) {
+		posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+	}
 
-	pid_t pid = fork();
-	ERR_FAIL_COND_V(pid < 0, ERR_CANT_FORK);
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
 
-	if (pid == 0) {
-		// is child
+	if (!_blocking) {
+		// For non blocking calls, create a new session-ID so parent won't wait for it.
+#ifdef POSIX_SPAWN_SETSID
+		posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+#else
+		posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+		posix_spawnattr_setpgroup(&attr, 0);
+#endif
+	}
 
-		if (!_blocking) {
-			// For non blocking calls, create a new session-ID so parent won't wait for it.
-			// This ensures the process won't go zombie at end.
-			setsid();
-		}
+	// No shell, and it uses vfork() (or an equivalent) where it can, so it's cheap even for big parents.
+	pid_t pid = 0;
+	int spawn_error = posix_spawnp(&pid, args[0], &actions, &attr, &args[0], environ);
 
-		Vector<CharString> cs;
-		cs.push_back(_executable_path.utf8());
-		for (int i = 0; i < _arguments.size(); i++) {
-			cs.push_back(_arguments[i].utf8());
-		}
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
 
-		Vector<char *> args;
-		for (int i = 0; i < cs.size(); i++) {
-			args.push_back((char *)cs[i].get_data());
-		}
-		args.push_back(0);
+	_sub_process_close_fd(out_fds[1]);
+	_sub_process_close_fd(err_fds[1]);
+	_sub_process_close_fd(in_fds[0]);
 
-		execvp(_executable_path.utf8().get_data(), &args[0]);
-		// still alive? something failed..
-		fprintf(stderr, "**ERROR** SubProcess::execute - Could not create child process while executing: %s\n", _executable_path.utf8().get_data());
-		raise(SIGKILL);
+	if (spawn_error != 0) {
+		_sub_process_close_fd(out_fds[0]);
+		_sub_process_close_fd(err_fds[0]);
+		_sub_process_close_fd(in_fds[1]);
+
+		ERR_FAIL_V_MSG(ERR_CANT_FORK, "Could not create child process while executing: " + _executable_path + " (" + String(strerror(spawn_error)) + ").");
+	}
+
+	_pipe_fds[0] = in_fds[1];
+	_pipe_fds[1] = out_fds[0];
+	_pipe_fds[2] = err_fds[0];
+
+	for (int i = 0; i < 3; ++i) {
+		if (_pipe_fds[i] >= 0) {
+			fcntl(_pipe_fds[i], F_SETFL, fcntl(_pipe_fds[i], F_GETFL) | O_NONBLOCK);
+		}
 	}
 
 	if (_blocking) {
+		// Everything is read as it comes, so a full stderr pipe can't block the process while it's writing stdout.
+		while (_drain_pipes(-1)) {
+			;
+		}
+
+		_close_pipes();
+
 		int status;
 		waitpid(pid, &status, 0);
 
@@ -514,11 +609,17 @@ Error SubProcess::stop() {
 	// Actual virtual call goes to OS_JavaScript.
 	ERR_FAIL_V(ERR_BUG);
 #else
-	if (_process_fp) {
-		int rv = pclose(_process_fp);
-		_process_fp = NULL;
-		_exitcode = WEXITSTATUS(rv);
+	if (_process_id && (_pipe_fds[1] >= 0 || _pipe_fds[2] >= 0)) {
+		// Same as the old pclose(): close the pipes, and wait for it to exit.
+		_close_pipes();
+
+		int status;
+		if (waitpid(_process_id, &status, 0) == _process_id) {
+			_exitcode = WIFEXITED(status) ? WEXITSTATUS(status) : status;
+		}
+
 		_process_id = 0;
+
 		return OK;
 	}
 
@@ -533,38 +634,61 @@ Error SubProcess::stop() {
 
 		_process_id = 0;
 
+		_close_pipes();
+
 		return ret ? ERR_INVALID_PARAMETER : OK;
 	}
 
+	_close_pipes();
+
 	return OK;
 #endif
 }
 
-Error SubProcess::poll() {
+Error SubProcess::poll(int p_timeout_msec) {
 #ifdef __EMSCRIPTEN__
 	// Don't compile this code at all to avoid undefined references.
 	// Actual virtual call goes to OS_JavaScript.
 	ERR_FAIL_V(ERR_BUG);
 #else
+	if (_process_id == 0) {
+		return FAILED;
+	}
 
-	if (_process_fp) {
-		if (fgets(_process_buf, 65535, _process_fp)) {
-			if (_pipe_mutex) {
-				_pipe_mutex->lock();
-			}
-			_pipe = String::utf8(_process_buf);
-			if (_pipe_mutex) {
-				_pipe_mutex->unlock();
-			}
-		} else {
-			// The process finished
-			// Cleanup:
-			stop();
-			return ERR_FILE_EOF;
-		}
+	if (_pipe_mutex) {
+		_pipe_mutex->lock();
+	}
+	_pipe.clear();
+	_pipe_err.clear();
+	if (_pipe_mutex) {
+		_pipe_mutex->unlock();
 	}
 
-	return OK;
+	bool has_output = _pipe_fds[1] >= 0 || _pipe_fds[2] >= 0;
+
+	if (_drain_pipes(p_timeout_msec)) {
+		return OK;
+	}
+
+	// The output got closed, so it's exiting, wait for it like pclose() would.
+	// Without output, only wait when told to, and nothing is left to write.
+	bool wait = has_output || (p_timeout_msec < 0 && _pipe_fds[0] < 0);
+
+	int status = 0;
+	pid_t ret = waitpid(_process_id, &status, wait ? 0 : WNOHANG);
+
+	if (ret == 0) {
+		return OK;
+	}
+
+	if (ret == _process_id) {
+		_exitcode = WIFEXITED(status) ? WEXITSTATUS(status) : status;
+	}
+
+	_process_id = 0;
+	_close_pipes();
+
+	return ERR_FILE_EOF;
 #endif
 }
 
@@ -574,8 +698,22 @@ Error SubProcess::send_signal(const int p_signal) {
 }
 
 Error SubProcess::send_data(const String &p_data) {
-	//Not Yet Impl
-	ERR_FAIL_V(ERR_BUG);
+	ERR_FAIL_COND_V_MSG(_pipe_fds[0] < 0 || _close_std_in, ERR_UNAVAILABLE, "Stdin is not open. It needs set_write_std(true), and a non blocking process.");
+
+	CharString cs = p_data.utf8();
+
+	uint32_t size = _std_in_data.size();
+	_std_in_data.resize(size + cs.length());
+	memcpy(_std_in_data.ptr() + size, cs.get_data(), cs.length());
+
+	_flush_std_in();
+
+	return OK;
+}
+
+void SubProcess::close_write_std() {
+	_close_std_in = true;
+	_flush_std_in();
 }
 
 bool SubProcess::is_process_running() const {
@@ -584,24 +722,200 @@ bool SubProcess::is_process_running() const {
 	// Actual virtual call goes to OS_JavaScript.
 	ERR_FAIL_V(false);
 #else
-
-	if (_process_fp) {
-		return !feof(_process_fp);
-	}
-
 	if (_process_id == 0) {
 		return false;
 	}
 
-	int status = 0;
-	if (waitpid(_process_id, &status, WNOHANG) != 0) {
+	// WNOWAIT leaves it a zombie, so poll() can still get the exit code.
+	siginfo_t info;
+	info.si_pid = 0;
+
+	if (waitid(P_PID, _process_id, &info, WEXITED | WNOHANG | WNOWAIT) != 0) {
 		return false;
 	}
 
-	return true;
+	return info.si_pid == 0;
 #endif
 }
 
+bool SubProcess::_drain_pipes(int p_timeout_msec) {
+	struct pollfd pfds[3];
+	int indices[3];
+	int count = 0;
+
+	for (int i = 0; i < 3; ++i) {
+		if (_pipe_fds[i] < 0) {
+			continue;
+		}
+
+		if (i == 0 && _std_in_data.size() == 0) {
+			continue;
+		}
+
+		pfds[count].fd = _pipe_fds[i];
+		pfds[count].events = i == 0 ? POLLOUT : POLLIN;
+		pfds[count].revents = 0;
+		indices[count] = i;
+		++count;
+	}
+
+	if (count == 0) {
+		if (p_timeout_msec > 0) {
+			::poll(NULL, 0, p_timeout_msec);
+		}
+
+		return false;
+	}
+
+	if (::poll(pfds, count, p_timeout_msec) > 0) {
+		for (int i = 0; i < count; ++i) {
+			if (!pfds[i].revents) {
+				continue;
+			}
+
+			if (indices[i] == 0) {
+				_flush_std_in();
+			} else {
+				_read_pipe(indices[i]);
+			}
+		}
+	}
+
+	return _pipe_fds[1] >= 0 || _pipe_fds[2] >= 0;
+}
+
+void SubProcess::_read_pipe(int p_index) {
+	char buf[65536];
+
+	// Bounded, so a chatty stdout can't starve stderr and stdin.
+	for (int i = 0; i < 16; ++i) {
+		ssize_t n = ::read(_pipe_fds[p_index], buf, sizeof(buf));
+
+		if (n > 0) {
+			_append_output(p_index, buf, n, false);
+			continue;
+		}
+
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return;
+		}
+
+		// EOF, or error
+		_append_output(p_index, NULL, 0, true);
+		_sub_process_close_fd(_pipe_fds[p_index]);
+		return;
+	}
+}
+
+void SubProcess::_flush_std_in() {
+	if (_pipe_fds[0] < 0) {
+		_std_in_data.clear();
+		return;
+	}
+
+	uint32_t written = 0;
+
+	while (written < _std_in_data.size()) {
+		ssize_t n = _sub_process_write(_pipe_fds[0], _std_in_data.ptr() + written, _std_in_data.size() - written);
+
+		if (n > 0) {
+			written += n;
+			continue;
+		}
+
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+
+		// The process closed it's stdin.
+		_std_in_data.clear();
+		_sub_process_close_fd(_pipe_fds[0]);
+		return;
+	}
+
+	if (written > 0) {
+		uint32_t remaining = _std_in_data.size() - written;
+		memmove(_std_in_data.ptr(), _std_in_data.ptr() + written, remaining);
+		_std_in_data.resize(remaining);
+	}
+
+	if (_close_std_in && _std_in_data.size() == 0) {
+		_sub_process_close_fd(_pipe_fds[0]);
+	}
+}
+
+void SubProcess::_append_output(int p_index, const char *p_data, int p_size, bool p_eof) {
+	LocalVector<char> &bytes = _pipe_bytes[p_index];
+
+	if (p_size > 0) {
+		uint32_t size = bytes.size();
+		bytes.resize(size + p_size);
+		memcpy(bytes.ptr() + size, p_data, p_size);
+	}
+
+	uint32_t len = bytes.size();
+
+	if (!p_eof) {
+		// Keep an incomplete utf8 sequence at the end for the next read.
+		for (uint32_t i = 1; i <= MIN(len, 4u); ++i) {
+			uint8_t c = bytes[len - i];
+
+			if ((c & 0xC0) == 0x80) {
+				// Continuation byte
+				continue;
+			}
+
+			uint32_t sequence_length = c < 0xC0 ? 1 : (c < 0xE0 ? 2 : (c < 0xF0 ? 3 : 4));
+
+			if (sequence_length > i) {
+				len -= i;
+			}
+
+			break;
+		}
+	}
+
+	if (len == 0) {
+		return;
+	}
+
+	String str = String::utf8(bytes.ptr(), len);
+
+	if (_pipe_mutex) {
+		_pipe_mutex->lock();
+	}
+	if (p_index == 2) {
+		_pipe_err += str;
+	} else {
+		_pipe += str;
+	}
+	if (_pipe_mutex) {
+		_pipe_mutex->unlock();
+	}
+
+	uint32_t remaining = bytes.size() - len;
+	memmove(bytes.ptr(), bytes.ptr() + len, remaining);
+	bytes.resize(remaining);
+}
+
+void SubProcess::_close_pipes() {
+	for (int i = 0; i < 3; ++i) {
+		_sub_process_close_fd(_pipe_fds[i]);
+		_pipe_bytes[i].clear();
+	}
+
+	_std_in_data.clear();
+	_close_std_in = false;
+}
+
 SubProcess::SubProcess() {
 	_blocking = false;
 
@@ -609,6 +923,8 @@ SubProcess::SubProcess() {
 
 	_read_std = true;
 	_read_std_err = false;
+	_separate_std_err = false;
+	_write_std = false;
 
 	_use_pipe_mutex = false;
 
@@ -619,7 +935,10 @@ SubProcess::SubProcess() {
 	_process_id = ProcessID();
 	_exitcode = 0;
 
-	_process_fp = NULL;
+	_pipe_fds[0] = -1;
+	_pipe_fds[1] = -1;
+	_pipe_fds[2] = -1;
+	_close_std_in = false;
 }
 SubProcess::~SubProcess() {
 	stop();
@@ -685,6 +1004,24 @@ void SubProcess::set_read_std_err(const bool p_value) {
 	_read_std_err = p_value;
 }
 
+bool SubProcess::get_separate_std_err() const {
+	return _separate_std_err;
+}
+void SubProcess::set_separate_std_err(const bool p_value) {
+	ERR_FAIL_COND(is_process_running());
+
+	_separate_std_err = p_value;
+}
+
+bool SubProcess::get_write_std() const {
+	return _write_std;
+}
+void SubProcess::set_write_std(const bool p_value) {
+	ERR_FAIL_COND(is_process_running());
+
+	_write_std = p_value;
+}
+
 bool SubProcess::get_use_pipe_mutex() const {
 	return _use_pipe_mutex;
 }
@@ -0,0 +1,142 @@
+//--STRIP
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+//--STRIP
+
+//--STRIP
+#include "core/int_types.h"
+#include "core/local_vector.h"
+#include "core/mutex.h"
+#include "core/safe_refcount.h"
+#include "core/semaphore.h"
+#include "core/spin_lock.h"
+#include "core/thread.h"
+#include "core/typedefs.h"
+//--STRIP
+
+// Work stealing task system.
+// Every worker has it's own task queue. A worker runs the newest task from it's own queue first (cache friendly),
+// and when it runs out it steals the oldest tasks from the others.
+// Threads that wait on a TaskGroup help with executing tasks instead of just blocking.
+// With NO_THREADS (or 0 threads) tasks are executed immediately on the calling thread.
+
+class WorkerPool {
+public:
+	typedef void (*TaskCallback)(void *p_userdata);
+	// Processes the [p_from, p_to) range
+	typedef void (*RangeCallback)(void *p_userdata, uint32_t p_from, uint32_t p_to);
+
+	class TaskGroup {
+	public:
+		_FORCE_INLINE_ bool is_done() const { return _pending.get() == 0; }
+		_FORCE_INLINE_ uint32_t get_pending_count() const { return _pending.get(); }
+
+		// Runs queued tasks while waiting, then sleeps if there is nothing left to do
+		void wait();
+
+		TaskGroup();
+		~TaskGroup();
+
+	protected:
+		friend class WorkerPool;
+
+		struct Continuation {
+			TaskCallback callback;
+			void *userdata;
+			TaskGroup *group;
+		};
+
+		void _task_done();
+
+		WorkerPool *_pool;
+		SafeNumeric<uint32_t> _pending;
+		// Threads that are inside _task_done(). wait() can't return while this is not 0,
+		// otherwise the group could get deleted while it's still in use.
+		SafeNumeric<uint32_t> _busy;
+		SafeNumeric<uint32_t> _waiters;
+		Semaphore _semaphore;
+		Mutex _mutex;
+		LocalVector<Continuation> _continuations;
+	};
+
+	// The task is only started after every task in p_depends_on finished.
+	void add_task(TaskCallback p_callback, void *p_userdata, TaskGroup *p_group = NULL, TaskGroup *p_depends_on = NULL);
+
+	// Splits [p_begin, p_end) into p_grain_size chunks, runs them on the workers and waits for all of them.
+	// p_grain_size == 0 means automatic.
+	void parallel_for(uint32_t p_begin, uint32_t p_end, RangeCallback p_callback, void *p_userdata, uint32_t p_grain_size = 0);
+
+	// Executes one queued task on the calling thread. Returns false if there was nothing to do.
+	bool run_pending_task();
+
+	_FORCE_INLINE_ int get_thread_count() const { return _workers.size(); }
+
+	// Index of the calling worker thread, -1 if it's not a worker of this pool.
+	int get_current_worker_index() const;
+
+	void start(int p_thread_count = -1);
+	void stop();
+
+	// Lazily creates and starts a pool with OS::get_processor_count() - 1 threads.
+	static WorkerPool *get_singleton();
+	static void cleanup();
+
+	WorkerPool();
+	~WorkerPool();
+
+protected:
+	struct Task {
+		TaskCallback callback;
+		void *userdata;
+		TaskGroup *group;
+	};
+
+	struct Worker {
+		WorkerPool *pool;
+		int index;
+		Thread thread;
+
+		// The owner pushes and pops at the back, thieves take from head.
+		SpinLock lock;
+		LocalVector<Task> tasks;
+		uint32_t head;
+
+		Worker() {
+			pool = NULL;
+			index = -1;
+			head = 0;
+		}
+	};
+
+	struct ParallelForData {
+		RangeCallback callback;
+		void *userdata;
+		uint32_t begin;
+		uint32_t end;
+		uint32_t grain_size;
+		uint32_t chunk_count;
+		SafeNumeric<uint32_t> next_chunk;
+	};
+
+	void _push_task(const Task &p_task);
+	bool _pop_task(Task &r_task);
+	bool _pop_task_from(Worker *p_worker, bool p_lifo, Task &r_task);
+	void _execute_task(const Task &p_task);
+
+	static void _worker_func(void *p_userdata);
+	static void _parallel_for_task(void *p_userdata);
+
+	LocalVector<Worker *> _workers;
+	SafeNumeric<uint32_t> _next_worker;
+	SafeNumeric<uint32_t> _queued_count;
+	SafeNumeric<uint32_t> _sleeping_count;
+	Semaphore _semaphore;
+	SafeFlag _exit;
+
+	static SafePointer<WorkerPool *> _singleton;
+	static Mutex _singleton_mutex;
+};
+
+//--STRIP
+#endif // WORKER_POOL_H
+//--STRIP
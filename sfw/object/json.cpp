@@ -0,0 +1,1209 @@
+//--STRIP
+#include "json.h"
+
+#include "core/error_macros.h"
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/math_funcs.h"
+#include "core/string_builder.h"
+
+#include "object/array.h"
+#include "object/dictionary.h"
+//--STRIP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Parser. C is uint8_t for UTF-8, or CharType.
+
+template <class C>
+class JSONParser {
+public:
+	const C *pos;
+	const C *end;
+	int line;
+	String error;
+
+	bool parse_value(Variant &r_value, int p_depth);
+	bool parse_string(String &r_string);
+	bool parse_number(Variant &r_value);
+
+	_FORCE_INLINE_ void skip_whitespace() {
+		while (pos < end) {
+			uint32_t c = *pos;
+
+			if (c == '\n') {
+				line++;
+			} else if (c != ' ' && c != '\t' && c != '\r') {
+				return;
+			}
+
+			pos++;
+		}
+	}
+
+	JSONParser(const C *p_begin, const C *p_end) {
+		pos = p_begin;
+		end = p_end;
+		line = 1;
+	}
+
+protected:
+	// Reused for every string.
+	LocalVector<CharType> _string_buffer;
+
+	bool _fail(const char *p_message) {
+		if (error.empty()) {
+			error = p_message;
+		}
+
+		return false;
+	}
+
+	bool _parse_literal(const char *p_literal) {
+		for (const char *c = p_literal; *c; ++c) {
+			if (pos >= end || *pos != (C)*c) {
+				return _fail("Unknown identifier.");
+			}
+
+			pos++;
+		}
+
+		return true;
+	}
+
+	bool _parse_hex4(uint32_t &r_value) {
+		if (end - pos < 4) {
+			return _fail("Unterminated unicode escape.");
+		}
+
+		r_value = 0;
+
+		for (int i = 0; i < 4; ++i) {
+			uint32_t c = *pos++;
+
+			if (c >= '0' && c <= '9') {
+				c -= '0';
+			} else if (c >= 'a' && c <= 'f') {
+				c -= 'a' - 10;
+			} else if (c >= 'A' && c <= 'F') {
+				c -= 'A' - 10;
+			} else {
+				return _fail("Invalid unicode escape.");
+			}
+
+			r_value = (r_value << 4) | c;
+		}
+
+		return true;
+	}
+
+	// Only used with UTF-8 input, pos is at a byte >= 0x80.
+	bool _decode_utf8(uint32_t &r_char) {
+		static const uint32_t min_values[3] = { 0x80, 0x800, 0x10000 };
+
+		uint32_t c = *pos;
+		int size;
+
+		if ((c & 0xE0) == 0xC0) {
+			size = 2;
+			c &= 0x1F;
+		} else if ((c & 0xF0) == 0xE0) {
+			size = 3;
+			c &= 0x0F;
+		} else if ((c & 0xF8) == 0xF0) {
+			size = 4;
+			c &= 0x07;
+		} else {
+			return _fail("Invalid UTF-8.");
+		}
+
+		if (end - pos < size) {
+			return _fail("Invalid UTF-8.");
+		}
+
+		for (int i = 1; i < size; ++i) {
+			uint32_t b = pos[i];
+
+			if ((b & 0xC0) != 0x80) {
+				return _fail("Invalid UTF-8.");
+			}
+
+			c = (c << 6) | (b & 0x3F);
+		}
+
+		if (c < min_values[size - 2] || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+			return _fail("Invalid UTF-8.");
+		}
+
+		pos += size;
+		r_char = c;
+		return true;
+	}
+};
+
+template <class C>
+bool JSONParser<C>::parse_value(Variant &r_value, int p_depth) {
+	if (p_depth > Variant::MAX_RECURSION_DEPTH) {
+		return _fail("JSON structure is too deep.");
+	}
+
+	skip_whitespace();
+
+	if (pos >= end) {
+		return _fail("Unexpected end of input.");
+	}
+
+	switch (*pos) {
+		case '{': {
+			pos++;
+			Dictionary d;
+
+			skip_whitespace();
+
+			if (pos < end && *pos == '}') {
+				pos++;
+				r_value = d;
+				return true;
+			}
+
+			while (true) {
+				skip_whitespace();
+
+				if (pos >= end || *pos != '"') {
+					return _fail("Expected a string key.");
+				}
+
+				String key;
+				if (!parse_string(key)) {
+					return false;
+				}
+
+				skip_whitespace();
+
+				if (pos >= end || *pos != ':') {
+					return _fail("Expected ':'.");
+				}
+
+				pos++;
+
+				if (!parse_value(d[key], p_depth + 1)) {
+					return false;
+				}
+
+				skip_whitespace();
+
+				if (pos < end && *pos == ',') {
+					pos++;
+				} else if (pos < end && *pos == '}') {
+					pos++;
+					break;
+				} else {
+					return _fail("Expected ',' or '}'.");
+				}
+			}
+
+			r_value = d;
+			return true;
+		}
+		case '[': {
+			pos++;
+			Array a;
+
+			skip_whitespace();
+
+			if (pos < end && *pos == ']') {
+				pos++;
+				r_value = a;
+				return true;
+			}
+
+			while (true) {
+				Variant v;
+				if (!parse_value(v, p_depth + 1)) {
+					return false;
+				}
+
+				a.push_back(v);
+
+				skip_whitespace();
+
+				if (pos < end && *pos == ',') {
+					pos++;
+				} else if (pos < end && *pos == ']') {
+					pos++;
+					break;
+				} else {
+					return _fail("Expected ',' or ']'.");
+				}
+			}
+
+			r_value = a;
+			return true;
+		}
+		case '"': {
+			String str;
+			if (!parse_string(str)) {
+				return false;
+			}
+
+			r_value = str;
+			return true;
+		}
+		case 't': {
+			r_value = true;
+			return _parse_literal("true");
+		}
+		case 'f': {
+			r_value = false;
+			return _parse_literal("false");
+		}
+		case 'n': {
+			r_value = Variant();
+			return _parse_literal("null");
+		}
+		default: {
+			return parse_number(r_value);
+		}
+	}
+}
+
+template <class C>
+bool JSONParser<C>::parse_string(String &r_string) {
+	// Opening quote
+	pos++;
+	_string_buffer.clear();
+
+	while (true) {
+		if (pos >= end) {
+			return _fail("Unterminated string.");
+		}
+
+		uint32_t c = *pos;
+
+		if (c == '"') {
+			pos++;
+			break;
+		}
+
+		if (c == '\\') {
+			pos++;
+
+			if (pos >= end) {
+				return _fail("Unterminated string.");
+			}
+
+			c = *pos++;
+
+			switch (c) {
+				case '"':
+				case '\\':
+				case '/': {
+				} break;
+				case 'b': {
+					c = '\b';
+				} break;
+				case 'f': {
+					c = '\f';
+				} break;
+				case 'n': {
+					c = '\n';
+				} break;
+				case 'r': {
+					c = '\r';
+				} break;
+				case 't': {
+					c = '\t';
+				} break;
+				case 'u': {
+					if (!_parse_hex4(c)) {
+						return false;
+					}
+
+					if (c >= 0xD800 && c <= 0xDBFF) {
+						uint32_t low;
+
+						if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+							return _fail("Invalid unicode surrogate pair.");
+						}
+
+						pos += 2;
+
+						if (!_parse_hex4(low)) {
+							return false;
+						}
+
+						if (low < 0xDC00 || low > 0xDFFF) {
+							return _fail("Invalid unicode surrogate pair.");
+						}
+
+						c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+					} else if (c >= 0xDC00 && c <= 0xDFFF) {
+						return _fail("Invalid unicode surrogate pair.");
+					}
+				} break;
+				default: {
+					return _fail("Invalid escape sequence.");
+				}
+			}
+		} else if (sizeof(C) == 1 && c >= 0x80) {
+			if (!_decode_utf8(c)) {
+				return false;
+			}
+		} else {
+			if (c == '\n') {
+				line++;
+			}
+
+			pos++;
+		}
+
+		_string_buffer.push_back(c);
+	}
+
+	if (_string_buffer.size()) {
+		r_string = String(_string_buffer.ptr(), _string_buffer.size());
+	} else {
+		r_string = String();
+	}
+
+	return true;
+}
+
+template <class C>
+bool JSONParser<C>::parse_number(Variant &r_value) {
+	// Powers of 10 that are exact doubles.
+	static const double pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const C *start = pos;
+
+	bool negative = false;
+	if (pos < end && *pos == '-') {
+		negative = true;
+		pos++;
+	}
+
+	if (pos >= end || *pos < '0' || *pos > '9') {
+		return _fail("Unexpected character.");
+	}
+
+	// First 19 significant digits, the rest are only counted in the exponent.
+	uint64_t mantissa = 0;
+	int digits = 0;
+	bool truncated = false;
+	int exponent = 0;
+	bool is_int = true;
+
+	if (*pos == '0') {
+		pos++;
+	} else {
+		while (pos < end && *pos >= '0' && *pos <= '9') {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*pos - '0');
+				digits++;
+			} else {
+				truncated = true;
+				exponent++;
+			}
+
+			pos++;
+		}
+	}
+
+	if (pos < end && *pos == '.') {
+		is_int = false;
+		pos++;
+
+		if (pos >= end || *pos < '0' || *pos > '9') {
+			return _fail("Expected a digit after '.'.");
+		}
+
+		while (pos < end && *pos >= '0' && *pos <= '9') {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*pos - '0');
+				// Leading zeros are not significant.
+				if (mantissa) {
+					digits++;
+				}
+				exponent--;
+			} else if (*pos != '0') {
+				truncated = true;
+			}
+
+			pos++;
+		}
+	}
+
+	if (pos < end && (*pos == 'e' || *pos == 'E')) {
+		is_int = false;
+		pos++;
+
+		bool negative_exponent = false;
+		if (pos < end && (*pos == '+' || *pos == '-')) {
+			negative_exponent = *pos == '-';
+			pos++;
+		}
+
+		if (pos >= end || *pos < '0' || *pos > '9') {
+			return _fail("Expected a digit in the exponent.");
+		}
+
+		int e = 0;
+		while (pos < end && *pos >= '0' && *pos <= '9') {
+			// Anything this big is 0 or inf anyway.
+			if (e < 100000) {
+				e = e * 10 + (*pos - '0');
+			}
+
+			pos++;
+		}
+
+		exponent += negative_exponent ? -e : e;
+	}
+
+	if (is_int && !truncated) {
+		if (!negative && mantissa <= (uint64_t)INT64_MAX) {
+			r_value = (int64_t)mantissa;
+			return true;
+		}
+
+		if (negative && mantissa <= (uint64_t)INT64_MAX + 1) {
+			r_value = (int64_t)(0 - mantissa);
+			return true;
+		}
+	}
+
+	// Exact, both the mantissa and the power of 10 can be represented as doubles.
+	if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+		double value = (double)mantissa;
+
+		if (exponent < 0) {
+			value /= pow10[-exponent];
+		} else {
+			value *= pow10[exponent];
+		}
+
+		r_value = negative ? -value : value;
+		return true;
+	}
+
+	// Slow path, rare. strtod() rounds correctly, String::to_double() doesn't always.
+	// JSON numbers never contain anything locale dependent except the '.', the C locale is expected.
+	int len = pos - start;
+	char stack_buffer[64];
+	CharString heap_buffer;
+	char *dst = stack_buffer;
+
+	if (len >= (int)sizeof(stack_buffer)) {
+		heap_buffer.resize(len + 1);
+		dst = heap_buffer.ptrw();
+	}
+
+	for (int i = 0; i < len; ++i) {
+		dst[i] = (char)start[i];
+	}
+
+	dst[len] = '\0';
+
+	r_value = strtod(dst, NULL);
+	return true;
+}
+
+// Lazy mode helpers. They only find the end of things, and return NULL if the input is broken.
+
+static _FORCE_INLINE_ const char *_lazy_skip_whitespace(const char *p_pos, const char *p_end) {
+	while (p_pos < p_end && (*p_pos == ' ' || *p_pos == '\t' || *p_pos == '\n' || *p_pos == '\r')) {
+		p_pos++;
+	}
+
+	return p_pos;
+}
+
+// p_pos is at the opening quote.
+static const char *_lazy_skip_string(const char *p_pos, const char *p_end) {
+	p_pos++;
+
+	while (p_pos < p_end) {
+		if (*p_pos == '"') {
+			return p_pos + 1;
+		}
+
+		if (*p_pos == '\\') {
+			p_pos++;
+		}
+
+		p_pos++;
+	}
+
+	return NULL;
+}
+
+static const char *_lazy_skip_value(const char *p_pos, const char *p_end) {
+	if (p_pos >= p_end) {
+		return NULL;
+	}
+
+	if (*p_pos == '"') {
+		return _lazy_skip_string(p_pos, p_end);
+	}
+
+	if (*p_pos == '{' || *p_pos == '[') {
+		int depth = 0;
+
+		while (p_pos < p_end) {
+			switch (*p_pos) {
+				case '"': {
+					p_pos = _lazy_skip_string(p_pos, p_end);
+
+					if (!p_pos) {
+						return NULL;
+					}
+
+					continue;
+				}
+				case '{':
+				case '[': {
+					depth++;
+				} break;
+				case '}':
+				case ']': {
+					depth--;
+
+					if (depth == 0) {
+						return p_pos + 1;
+					}
+				} break;
+			}
+
+			p_pos++;
+		}
+
+		return NULL;
+	}
+
+	// Number, or true / false / null
+	const char *start = p_pos;
+
+	while (p_pos < p_end && *p_pos != ',' && *p_pos != '}' && *p_pos != ']' && *p_pos != ' ' && *p_pos != '\t' && *p_pos != '\n' && *p_pos != '\r') {
+		p_pos++;
+	}
+
+	return p_pos == start ? NULL : p_pos;
+}
+
+// p_pos is after '{' or ','. Sets up a Value for the member there.
+static JSON::Value _lazy_member(const char *p_pos, const char *p_end, const char **r_key) {
+	p_pos = _lazy_skip_whitespace(p_pos, p_end);
+
+	if (p_pos >= p_end || *p_pos != '"') {
+		return JSON::Value();
+	}
+
+	*r_key = p_pos;
+	p_pos = _lazy_skip_string(p_pos, p_end);
+
+	if (!p_pos) {
+		return JSON::Value();
+	}
+
+	p_pos = _lazy_skip_whitespace(p_pos, p_end);
+
+	if (p_pos >= p_end || *p_pos != ':') {
+		return JSON::Value();
+	}
+
+	p_pos = _lazy_skip_whitespace(p_pos + 1, p_end);
+
+	if (p_pos >= p_end) {
+		return JSON::Value();
+	}
+
+	return JSON::parse_lazy(p_pos, p_end - p_pos);
+}
+
+JSON::ValueType JSON::Value::get_type() const {
+	if (!_begin) {
+		return TYPE_INVALID;
+	}
+
+	switch (*_begin) {
+		case '{':
+			return TYPE_OBJECT;
+		case '[':
+			return TYPE_ARRAY;
+		case '"':
+			return TYPE_STRING;
+		case 't':
+		case 'f':
+			return TYPE_BOOL;
+		case 'n':
+			return TYPE_NULL;
+		case '-':
+			return TYPE_NUMBER;
+		default:
+			return (*_begin >= '0' && *_begin <= '9') ? TYPE_NUMBER : TYPE_INVALID;
+	}
+}
+
+JSON::Value JSON::Value::get(const String &p_key) const {
+	if (get_type() != TYPE_OBJECT) {
+		return Value();
+	}
+
+	CharString key = p_key.utf8();
+
+	for (Value v = first(); v.is_valid(); v = v.next()) {
+		const char *raw = v._key + 1;
+		const char *raw_end = _lazy_skip_string(v._key, _end) - 1;
+
+		if (raw_end - raw == key.length() && memcmp(raw, key.get_data(), key.length()) == 0) {
+			return v;
+		}
+
+		// Escaped keys need to be decoded to compare them.
+		if (memchr(raw, '\\', raw_end - raw) && v.get_key() == p_key) {
+			return v;
+		}
+	}
+
+	return Value();
+}
+
+JSON::Value JSON::Value::get_index(int p_index) const {
+	if (get_type() != TYPE_ARRAY || p_index < 0) {
+		return Value();
+	}
+
+	Value v = first();
+
+	for (int i = 0; i < p_index && v.is_valid(); ++i) {
+		v = v.next();
+	}
+
+	return v;
+}
+
+int JSON::Value::size() const {
+	int count = 0;
+
+	for (Value v = first(); v.is_valid(); v = v.next()) {
+		count++;
+	}
+
+	return count;
+}
+
+JSON::Value JSON::Value::first() const {
+	ValueType type = get_type();
+
+	if (type != TYPE_ARRAY && type != TYPE_OBJECT) {
+		return Value();
+	}
+
+	const char *pos = _lazy_skip_whitespace(_begin + 1, _end);
+
+	if (pos >= _end || *pos == ']' || *pos == '}') {
+		return Value();
+	}
+
+	if (type == TYPE_ARRAY) {
+		return Value(pos, _end, NULL);
+	}
+
+	const char *key = NULL;
+	Value v = _lazy_member(pos, _end, &key);
+	v._key = key;
+	return v;
+}
+
+JSON::Value JSON::Value::next() const {
+	if (!_begin) {
+		return Value();
+	}
+
+	const char *pos = _lazy_skip_value(_begin, _end);
+
+	if (!pos) {
+		return Value();
+	}
+
+	pos = _lazy_skip_whitespace(pos, _end);
+
+	if (pos >= _end || *pos != ',') {
+		return Value();
+	}
+
+	pos = _lazy_skip_whitespace(pos + 1, _end);
+
+	if (!_key) {
+		return Value(pos < _end ? pos : NULL, _end, NULL);
+	}
+
+	const char *key = NULL;
+	Value v = _lazy_member(pos, _end, &key);
+	v._key = key;
+	return v;
+}
+
+String JSON::Value::get_key() const {
+	if (!_key) {
+		return String();
+	}
+
+	JSONParser<uint8_t> parser((const uint8_t *)_key, (const uint8_t *)_end);
+
+	String key;
+	parser.parse_string(key);
+	return key;
+}
+
+Variant JSON::Value::to_variant() const {
+	if (!_begin) {
+		return Variant();
+	}
+
+	JSONParser<uint8_t> parser((const uint8_t *)_begin, (const uint8_t *)_end);
+
+	Variant value;
+	if (!parser.parse_value(value, 0)) {
+		ERR_PRINT("JSON: " + parser.error);
+		return Variant();
+	}
+
+	return value;
+}
+
+// Writer
+
+class JSONWriter {
+public:
+	bool write(const Variant &p_var, int p_depth);
+
+	void flush() {
+		if (_position == 0) {
+			return;
+		}
+
+		_chunk.resize(_position + 1);
+		_chunk.ptrw()[_position] = 0;
+		_builder.append(_chunk);
+
+		_chunk = String();
+		_position = 0;
+		_ptr = NULL;
+	}
+
+	JSONWriter(StringBuilder &p_builder, const String &p_indent, bool p_sort_keys) :
+			_builder(p_builder) {
+		_indent = p_indent;
+		_sort_keys = p_sort_keys;
+		_ptr = NULL;
+		_position = 0;
+	}
+
+protected:
+	enum {
+		CHUNK_SIZE = 16384,
+	};
+
+	StringBuilder &_builder;
+	String _indent;
+	bool _sort_keys;
+
+	String _chunk;
+	CharType *_ptr;
+	int _position;
+
+	_FORCE_INLINE_ void _put(CharType p_char) {
+		if (unlikely(!_ptr || _position == CHUNK_SIZE)) {
+			flush();
+			_chunk.resize(CHUNK_SIZE + 1);
+			_ptr = _chunk.ptrw();
+		}
+
+		_ptr[_position++] = p_char;
+	}
+
+	_FORCE_INLINE_ void _put(const char *p_str) {
+		while (*p_str) {
+			_put((CharType)(uint8_t)*p_str++);
+		}
+	}
+
+	void _put_newline(int p_depth) {
+		if (_indent.empty()) {
+			return;
+		}
+
+		_put('\n');
+
+		for (int i = 0; i < p_depth; ++i) {
+			for (int j = 0; j < _indent.length(); ++j) {
+				_put(_indent[j]);
+			}
+		}
+	}
+
+	void _put_int(int64_t p_value) {
+		char buf[24];
+		char *c = buf + sizeof(buf);
+		*--c = '\0';
+
+		uint64_t value = p_value < 0 ? 0 - (uint64_t)p_value : (uint64_t)p_value;
+
+		do {
+			*--c = '0' + value % 10;
+			value /= 10;
+		} while (value);
+
+		if (p_value < 0) {
+			*--c = '-';
+		}
+
+		_put(c);
+	}
+
+	void _put_real(double p_value) {
+		if (Math::is_nan(p_value) || Math::is_inf(p_value)) {
+			// Not representable in JSON.
+			_put("null");
+			return;
+		}
+
+		// Shortest of the two that reads back exactly.
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.15g", p_value);
+
+		if (strtod(buf, NULL) != p_value) {
+			snprintf(buf, sizeof(buf), "%.17g", p_value);
+		}
+
+		_put(buf);
+
+		// So it reads back as a REAL.
+		if (!strpbrk(buf, ".eE")) {
+			_put(".0");
+		}
+	}
+
+	void _put_string(const String &p_string) {
+		static const char hex[] = "0123456789abcdef";
+
+		_put('"');
+
+		const CharType *c = p_string.ptr();
+		int len = p_string.length();
+
+		for (int i = 0; i < len; ++i) {
+			CharType ch = c[i];
+
+			switch (ch) {
+				case '"': {
+					_put("\\\"");
+				} break;
+				case '\\': {
+					_put("\\\\");
+				} break;
+				case '\b': {
+					_put("\\b");
+				} break;
+				case '\f': {
+					_put("\\f");
+				} break;
+				case '\n': {
+					_put("\\n");
+				} break;
+				case '\r': {
+					_put("\\r");
+				} break;
+				case '\t': {
+					_put("\\t");
+				} break;
+				default: {
+					if (ch < 0x20) {
+						_put("\\u00");
+						_put(hex[ch >> 4]);
+						_put(hex[ch & 0xF]);
+					} else {
+						_put(ch);
+					}
+				}
+			}
+		}
+
+		_put('"');
+	}
+};
+
+bool JSONWriter::write(const Variant &p_var, int p_depth) {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, false, "JSON structure is too deep. Bailing.");
+
+	const char *colon = _indent.empty() ? ":" : ": ";
+
+	switch (p_var.get_type()) {
+		case Variant::NIL: {
+			_put("null");
+		} break;
+		case Variant::BOOL: {
+			_put(p_var.operator bool() ? "true" : "false");
+		} break;
+		case Variant::INT: {
+			_put_int(p_var);
+		} break;
+		case Variant::REAL: {
+			_put_real(p_var);
+		} break;
+		case Variant::STRING:
+		case Variant::STRING_NAME: {
+			_put_string(p_var.operator String());
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_var;
+
+			if (d.empty()) {
+				_put("{}");
+				break;
+			}
+
+			_put('{');
+
+			bool first = true;
+
+			if (_sort_keys) {
+				List<Variant> keys;
+				d.get_key_list(&keys);
+				keys.sort();
+
+				for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+					if (!first) {
+						_put(',');
+					}
+
+					first = false;
+
+					_put_newline(p_depth + 1);
+					_put_string(E->get().operator String());
+					_put(colon);
+
+					if (!write(d[E->get()], p_depth + 1)) {
+						return false;
+					}
+				}
+			} else {
+				const Variant *key = NULL;
+
+				while ((key = d.next(key))) {
+					if (!first) {
+						_put(',');
+					}
+
+					first = false;
+
+					_put_newline(p_depth + 1);
+					_put_string(key->operator String());
+					_put(colon);
+
+					if (!write(d[*key], p_depth + 1)) {
+						return false;
+					}
+				}
+			}
+
+			_put_newline(p_depth);
+			_put('}');
+		} break;
+		case Variant::ARRAY: {
+			Array a = p_var;
+
+			if (a.empty()) {
+				_put("[]");
+				break;
+			}
+
+			_put('[');
+
+			for (int i = 0; i < a.size(); ++i) {
+				if (i > 0) {
+					_put(',');
+				}
+
+				_put_newline(p_depth + 1);
+
+				if (!write(a[i], p_depth + 1)) {
+					return false;
+				}
+			}
+
+			_put_newline(p_depth);
+			_put(']');
+		} break;
+		case Variant::POOL_BYTE_ARRAY:
+		case Variant::POOL_INT_ARRAY:
+		case Variant::POOL_REAL_ARRAY:
+		case Variant::POOL_STRING_ARRAY: {
+			// No Variant per element.
+			_put('[');
+
+			Variant::Type type = p_var.get_type();
+			int size = 0;
+
+			if (type == Variant::POOL_BYTE_ARRAY) {
+				PoolByteArray array = p_var;
+				PoolByteArray::Read r = array.read();
+				size = array.size();
+
+				for (int i = 0; i < size; ++i) {
+					if (i > 0) {
+						_put(',');
+					}
+
+					_put_newline(p_depth + 1);
+					_put_int(r[i]);
+				}
+			} else if (type == Variant::POOL_INT_ARRAY) {
+				PoolIntArray array = p_var;
+				PoolIntArray::Read r = array.read();
+				size = array.size();
+
+				for (int i = 0; i < size; ++i) {
+					if (i > 0) {
+						_put(',');
+					}
+
+					_put_newline(p_depth + 1);
+					_put_int(r[i]);
+				}
+			} else if (type == Variant::POOL_REAL_ARRAY) {
+				PoolRealArray array = p_var;
+				PoolRealArray::Read r = array.read();
+				size = array.size();
+
+				for (int i = 0; i < size; ++i) {
+					if (i > 0) {
+						_put(',');
+					}
+
+					_put_newline(p_depth + 1);
+					_put_real(r[i]);
+				}
+			} else {
+				PoolStringArray array = p_var;
+				PoolStringArray::Read r = array.read();
+				size = array.size();
+
+				for (int i = 0; i < size; ++i) {
+					if (i > 0) {
+						_put(',');
+					}
+
+					_put_newline(p_depth + 1);
+					_put_string(r[i]);
+				}
+			}
+
+			if (size > 0) {
+				_put_newline(p_depth);
+			}
+
+			_put(']');
+		} break;
+		default: {
+			_put_string(p_var.operator String());
+		} break;
+	}
+
+	return true;
+}
+
+String JSON::stringify(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
+	StringBuilder builder;
+
+	if (stringify(p_var, builder, p_indent, p_sort_keys) != OK) {
+		return String();
+	}
+
+	return builder.as_string();
+}
+
+Error JSON::stringify(const Variant &p_var, StringBuilder &r_builder, const String &p_indent, bool p_sort_keys) {
+	JSONWriter writer(r_builder, p_indent, p_sort_keys);
+
+	if (!writer.write(p_var, 0)) {
+		return ERR_OUT_OF_MEMORY;
+	}
+
+	writer.flush();
+	return OK;
+}
+
+template <class C>
+static Error _parse(JSONParser<C> &p_parser, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	bool ok = p_parser.parse_value(r_ret, 0);
+
+	if (ok) {
+		p_parser.skip_whitespace();
+
+		if (p_parser.pos < p_parser.end) {
+			p_parser.error = "Expected end of input.";
+			ok = false;
+		}
+	}
+
+	if (!ok) {
+		r_ret = Variant();
+		r_err_str = p_parser.error;
+		r_err_line = p_parser.line;
+		return ERR_PARSE_ERROR;
+	}
+
+	r_err_str = String();
+	r_err_line = 0;
+	return OK;
+}
+
+Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	const CharType *begin = p_json.ptr();
+	JSONParser<CharType> parser(begin, begin + p_json.length());
+
+	return _parse(parser, r_ret, r_err_str, r_err_line);
+}
+
+Error JSON::parse_utf8(const char *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_COND_V(!p_utf8 && p_len > 0, ERR_INVALID_PARAMETER);
+
+	const uint8_t *begin = (const uint8_t *)p_utf8;
+
+	// BOM
+	if (p_len >= 3 && begin[0] == 0xEF && begin[1] == 0xBB && begin[2] == 0xBF) {
+		begin += 3;
+		p_len -= 3;
+	}
+
+	JSONParser<uint8_t> parser(begin, begin + p_len);
+
+	return _parse(parser, r_ret, r_err_str, r_err_line);
+}
+
+JSON::Value JSON::parse_lazy(const char *p_utf8, int p_len) {
+	if (!p_utf8) {
+		return Value();
+	}
+
+	const char *end = p_utf8 + p_len;
+
+	if (p_len >= 3 && (uint8_t)p_utf8[0] == 0xEF && (uint8_t)p_utf8[1] == 0xBB && (uint8_t)p_utf8[2] == 0xBF) {
+		p_utf8 += 3;
+	}
+
+	const char *begin = _lazy_skip_whitespace(p_utf8, end);
+
+	if (begin >= end) {
+		return Value();
+	}
+
+	return Value(begin, end, NULL);
+}
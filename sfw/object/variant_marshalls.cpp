@@ -0,0 +1,779 @@
+//--STRIP
+#include "variant_marshalls.h"
+
+#include "core/error_macros.h"
+#include "core/ustring.h"
+
+#include "object/object.h"
+//--STRIP
+
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define VARIANT_MARSHALLS_BIG_ENDIAN
+#endif
+
+#ifdef REAL_T_IS_DOUBLE
+#define VARIANT_ENCODE_FLAG_REAL VARIANT_ENCODE_FLAG_64
+#else
+#define VARIANT_ENCODE_FLAG_REAL 0
+#endif
+
+// Encoding. Every _put_* appends to r_buf (if it's not NULL), and adds its size to r_len.
+
+static _FORCE_INLINE_ void _put_32(uint32_t p_value, uint8_t *&r_buf, int &r_len) {
+	if (r_buf) {
+		encode_uint32(p_value, r_buf);
+		r_buf += 4;
+	}
+
+	r_len += 4;
+}
+
+static _FORCE_INLINE_ void _put_64(uint64_t p_value, uint8_t *&r_buf, int &r_len) {
+	if (r_buf) {
+		encode_uint64(p_value, r_buf);
+		r_buf += 8;
+	}
+
+	r_len += 8;
+}
+
+static _FORCE_INLINE_ void _put_padding(int p_size, uint8_t *&r_buf, int &r_len) {
+	int pad = (4 - (p_size & 3)) & 3;
+
+	if (r_buf) {
+		memset(r_buf, 0, pad);
+		r_buf += pad;
+	}
+
+	r_len += pad;
+}
+
+// p_count 1, 4 or 8 byte scalars in host order.
+static void _put_scalars(const void *p_src, int p_count, int p_scalar_size, uint8_t *&r_buf, int &r_len) {
+	int size = p_count * p_scalar_size;
+
+	if (r_buf) {
+#ifdef VARIANT_MARSHALLS_BIG_ENDIAN
+		const uint8_t *src = (const uint8_t *)p_src;
+
+		for (int i = 0; i < size; i += p_scalar_size) {
+			for (int j = 0; j < p_scalar_size; ++j) {
+				r_buf[i + j] = src[i + p_scalar_size - 1 - j];
+			}
+		}
+#else
+		memcpy(r_buf, p_src, size);
+#endif
+		r_buf += size;
+	}
+
+	r_len += size;
+}
+
+// Same output as String::utf8(), without the temporary CharString.
+static void _put_string(const String &p_string, uint8_t *&r_buf, int &r_len) {
+	int size = p_string.utf8_byte_length();
+
+	_put_32(size, r_buf, r_len);
+
+	if (r_buf) {
+		const CharType *src = p_string.ptr();
+		char *dst = (char *)r_buf;
+
+		for (int i = 0; i < p_string.length(); ++i) {
+			dst += String::utf8_encode_char(src[i], dst);
+		}
+
+		r_buf += size;
+	}
+
+	r_len += size;
+	_put_padding(size, r_buf, r_len);
+}
+
+template <class T>
+static void _put_pool_array(const PoolVector<T> &p_array, int p_components, int p_scalar_size, uint8_t *&r_buf, int &r_len) {
+	int count = p_array.size();
+
+	_put_32(count, r_buf, r_len);
+
+	if (r_buf && count) {
+		typename PoolVector<T>::Read r = p_array.read();
+		_put_scalars(r.ptr(), count * p_components, p_scalar_size, r_buf, r_len);
+	} else {
+		r_len += count * p_components * p_scalar_size;
+	}
+
+	_put_padding(count * p_components * p_scalar_size, r_buf, r_len);
+}
+
+template <class T>
+static _FORCE_INLINE_ void _put_reals(const T &p_value, uint8_t *&r_buf, int &r_len) {
+	_put_scalars(&p_value, sizeof(T) / sizeof(real_t), sizeof(real_t), r_buf, r_len);
+}
+
+template <class T>
+static _FORCE_INLINE_ void _put_ints(const T &p_value, uint8_t *&r_buf, int &r_len) {
+	_put_scalars(&p_value, sizeof(T) / sizeof(int32_t), sizeof(int32_t), r_buf, r_len);
+}
+
+static Error _encode_variant(const Variant &p_variant, uint8_t *&r_buf, int &r_len, int p_depth) {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
+
+	uint32_t header = p_variant.get_type();
+
+	switch (p_variant.get_type()) {
+		case Variant::INT: {
+			int64_t value = p_variant;
+
+			if (value > 0x7FFFFFFFLL || value < -0x80000000LL) {
+				_put_32(header | VARIANT_ENCODE_FLAG_64, r_buf, r_len);
+				_put_64(value, r_buf, r_len);
+			} else {
+				_put_32(header, r_buf, r_len);
+				_put_32((int32_t)value, r_buf, r_len);
+			}
+		} break;
+		case Variant::REAL: {
+			MarshallDouble md;
+			md.d = p_variant;
+			MarshallFloat mf;
+			mf.f = md.d;
+
+			// Only use 64 bits if needed.
+			if ((double)mf.f != md.d) {
+				_put_32(header | VARIANT_ENCODE_FLAG_64, r_buf, r_len);
+				_put_64(md.l, r_buf, r_len);
+			} else {
+				_put_32(header, r_buf, r_len);
+				_put_32(mf.i, r_buf, r_len);
+			}
+		} break;
+		case Variant::RECT2:
+		case Variant::VECTOR2:
+		case Variant::VECTOR3:
+		case Variant::VECTOR4:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::AABB:
+		case Variant::BASIS:
+		case Variant::TRANSFORM:
+		case Variant::TRANSFORM2D:
+		case Variant::PROJECTION:
+		case Variant::POOL_REAL_ARRAY:
+		case Variant::POOL_VECTOR2_ARRAY:
+		case Variant::POOL_VECTOR3_ARRAY:
+		case Variant::POOL_VECTOR4_ARRAY: {
+			_put_32(header | VARIANT_ENCODE_FLAG_REAL, r_buf, r_len);
+		} break;
+		case Variant::OBJECT: {
+			_put_32(header | VARIANT_ENCODE_FLAG_64, r_buf, r_len);
+		} break;
+		default: {
+			_put_32(header, r_buf, r_len);
+		} break;
+	}
+
+	switch (p_variant.get_type()) {
+		case Variant::NIL:
+		case Variant::INT:
+		case Variant::REAL: {
+			// Already done.
+		} break;
+		case Variant::BOOL: {
+			_put_32(p_variant.operator bool() ? 1 : 0, r_buf, r_len);
+		} break;
+		case Variant::STRING:
+		case Variant::STRING_NAME: {
+			_put_string(p_variant.operator String(), r_buf, r_len);
+		} break;
+		case Variant::RECT2: {
+			_put_reals(p_variant.operator Rect2(), r_buf, r_len);
+		} break;
+		case Variant::RECT2I: {
+			_put_ints(p_variant.operator Rect2i(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR2: {
+			_put_reals(p_variant.operator Vector2(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR2I: {
+			_put_ints(p_variant.operator Vector2i(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR3: {
+			_put_reals(p_variant.operator Vector3(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR3I: {
+			_put_ints(p_variant.operator Vector3i(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR4: {
+			_put_reals(p_variant.operator Vector4(), r_buf, r_len);
+		} break;
+		case Variant::VECTOR4I: {
+			_put_ints(p_variant.operator Vector4i(), r_buf, r_len);
+		} break;
+		case Variant::PLANE: {
+			_put_reals(p_variant.operator Plane(), r_buf, r_len);
+		} break;
+		case Variant::QUATERNION: {
+			_put_reals(p_variant.operator Quaternion(), r_buf, r_len);
+		} break;
+		case Variant::AABB: {
+			_put_reals(p_variant.operator ::AABB(), r_buf, r_len);
+		} break;
+		case Variant::BASIS: {
+			_put_reals(p_variant.operator Basis(), r_buf, r_len);
+		} break;
+		case Variant::TRANSFORM: {
+			_put_reals(p_variant.operator Transform(), r_buf, r_len);
+		} break;
+		case Variant::TRANSFORM2D: {
+			_put_reals(p_variant.operator Transform2D(), r_buf, r_len);
+		} break;
+		case Variant::PROJECTION: {
+			_put_reals(p_variant.operator Projection(), r_buf, r_len);
+		} break;
+		case Variant::COLOR: {
+			Color color = p_variant;
+			_put_scalars(color.components, 4, sizeof(float), r_buf, r_len);
+		} break;
+		case Variant::OBJECT: {
+			_put_64(p_variant.get_object_instance_id(), r_buf, r_len);
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_variant;
+
+			_put_32(d.size(), r_buf, r_len);
+
+			const Variant *key = NULL;
+			while ((key = d.next(key))) {
+				Error err = _encode_variant(*key, r_buf, r_len, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+
+				err = _encode_variant(d[*key], r_buf, r_len, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+			}
+		} break;
+		case Variant::ARRAY: {
+			Array array = p_variant;
+
+			_put_32(array.size(), r_buf, r_len);
+
+			for (int i = 0; i < array.size(); ++i) {
+				Error err = _encode_variant(array[i], r_buf, r_len, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+			}
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+			_put_pool_array(p_variant.operator PoolByteArray(), 1, 1, r_buf, r_len);
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+			_put_pool_array(p_variant.operator PoolIntArray(), 1, sizeof(int32_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+			_put_pool_array(p_variant.operator PoolRealArray(), 1, sizeof(real_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+			PoolStringArray array = p_variant;
+			PoolStringArray::Read r = array.read();
+
+			_put_32(array.size(), r_buf, r_len);
+
+			for (int i = 0; i < array.size(); ++i) {
+				_put_string(r[i], r_buf, r_len);
+			}
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector2Array(), 2, sizeof(real_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_VECTOR2I_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector2iArray(), 2, sizeof(int32_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_VECTOR3_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector3Array(), 3, sizeof(real_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_VECTOR3I_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector3iArray(), 3, sizeof(int32_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_VECTOR4_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector4Array(), 4, sizeof(real_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_VECTOR4I_ARRAY: {
+			_put_pool_array(p_variant.operator PoolVector4iArray(), 4, sizeof(int32_t), r_buf, r_len);
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+			_put_pool_array(p_variant.operator PoolColorArray(), 4, sizeof(float), r_buf, r_len);
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_BUG);
+		}
+	}
+
+	return OK;
+}
+
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, int p_depth) {
+	r_len = 0;
+	return _encode_variant(p_variant, r_buffer, r_len, p_depth);
+}
+
+Error encode_variant(const Variant &p_variant, PoolByteArray &r_data) {
+	int len;
+	Error err = encode_variant(p_variant, NULL, len);
+	ERR_FAIL_COND_V(err, err);
+
+	err = r_data.resize(len);
+	ERR_FAIL_COND_V(err, err);
+
+	PoolByteArray::Write w = r_data.write();
+	return encode_variant(p_variant, w.ptr(), len);
+}
+
+// Decoding. Every _get_* reads from r_buf and advances it. The callers check the sizes.
+
+#define VARIANT_DECODE_NEED(m_size)                                          \
+	if (unlikely((int64_t)(m_size) > (int64_t)(p_end - r_buf))) {            \
+		ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Truncated encoded Variant data."); \
+	}
+
+static _FORCE_INLINE_ uint32_t _get_32(const uint8_t *&r_buf) {
+	uint32_t value = decode_uint32(r_buf);
+	r_buf += 4;
+	return value;
+}
+
+static _FORCE_INLINE_ uint64_t _get_64(const uint8_t *&r_buf) {
+	uint64_t value = decode_uint64(r_buf);
+	r_buf += 8;
+	return value;
+}
+
+static _FORCE_INLINE_ int64_t _get_padded_size(int64_t p_size) {
+	return (p_size + 3) & ~3;
+}
+
+static void _get_scalars(void *r_dst, int p_count, int p_scalar_size, const uint8_t *p_buf) {
+	int size = p_count * p_scalar_size;
+
+#ifdef VARIANT_MARSHALLS_BIG_ENDIAN
+	uint8_t *dst = (uint8_t *)r_dst;
+
+	for (int i = 0; i < size; i += p_scalar_size) {
+		for (int j = 0; j < p_scalar_size; ++j) {
+			dst[i + j] = p_buf[i + p_scalar_size - 1 - j];
+		}
+	}
+#else
+	memcpy(r_dst, p_buf, size);
+#endif
+}
+
+// Converts if the data was encoded with a different real_t.
+static void _get_reals(real_t *r_dst, int p_count, bool p_64, const uint8_t *p_buf) {
+	if (p_64 == (sizeof(real_t) == 8)) {
+		_get_scalars(r_dst, p_count, sizeof(real_t), p_buf);
+		return;
+	}
+
+	for (int i = 0; i < p_count; ++i) {
+		if (p_64) {
+			r_dst[i] = decode_double(p_buf + i * 8);
+		} else {
+			r_dst[i] = decode_float(p_buf + i * 4);
+		}
+	}
+}
+
+static Error _get_string(String &r_string, const uint8_t *&r_buf, const uint8_t *p_end) {
+	VARIANT_DECODE_NEED(4);
+	uint32_t size = _get_32(r_buf);
+	VARIANT_DECODE_NEED(_get_padded_size(size));
+
+	if (size) {
+		r_string.parse_utf8((const char *)r_buf, size);
+	} else {
+		r_string = String();
+	}
+
+	r_buf += _get_padded_size(size);
+	return OK;
+}
+
+template <class T>
+static Error _get_reals_value(T &r_value, bool p_64, const uint8_t *&r_buf, const uint8_t *p_end) {
+	const int count = sizeof(T) / sizeof(real_t);
+	VARIANT_DECODE_NEED(count * (p_64 ? 8 : 4));
+
+	_get_reals((real_t *)&r_value, count, p_64, r_buf);
+	r_buf += count * (p_64 ? 8 : 4);
+	return OK;
+}
+
+template <class T>
+static Error _get_ints_value(T &r_value, const uint8_t *&r_buf, const uint8_t *p_end) {
+	VARIANT_DECODE_NEED(sizeof(T));
+
+	_get_scalars(&r_value, sizeof(T) / sizeof(int32_t), sizeof(int32_t), r_buf);
+	r_buf += sizeof(T);
+	return OK;
+}
+
+// p_encoded_scalar_size can only differ from p_scalar_size for real_t arrays.
+template <class T>
+static Error _get_pool_array(PoolVector<T> &r_array, int p_components, int p_scalar_size, int p_encoded_scalar_size, const uint8_t *&r_buf, const uint8_t *p_end) {
+	VARIANT_DECODE_NEED(4);
+	uint32_t count = _get_32(r_buf);
+
+	int64_t size = (int64_t)count * p_components * p_encoded_scalar_size;
+	ERR_FAIL_COND_V(count > 0x7FFFFFFF, ERR_INVALID_DATA);
+	VARIANT_DECODE_NEED(_get_padded_size(size));
+
+	Error err = r_array.resize(count);
+	ERR_FAIL_COND_V(err, err);
+
+	if (count) {
+		typename PoolVector<T>::Write w = r_array.write();
+
+		if (p_scalar_size == p_encoded_scalar_size) {
+			_get_scalars(w.ptr(), count * p_components, p_scalar_size, r_buf);
+		} else {
+			_get_reals((real_t *)w.ptr(), count * p_components, p_encoded_scalar_size == 8, r_buf);
+		}
+	}
+
+	r_buf += _get_padded_size(size);
+	return OK;
+}
+
+static Error _decode_variant(Variant &r_variant, const uint8_t *&r_buf, const uint8_t *p_end, bool p_allow_objects, int p_depth) {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
+
+	VARIANT_DECODE_NEED(4);
+	uint32_t header = _get_32(r_buf);
+	uint32_t type = header & VARIANT_ENCODE_MASK;
+	bool is_64 = header & VARIANT_ENCODE_FLAG_64;
+	int real_size = is_64 ? 8 : 4;
+
+	ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+
+	Error err = OK;
+
+	switch (type) {
+		case Variant::NIL: {
+			r_variant = Variant();
+		} break;
+		case Variant::BOOL: {
+			VARIANT_DECODE_NEED(4);
+			r_variant = _get_32(r_buf) != 0;
+		} break;
+		case Variant::INT: {
+			VARIANT_DECODE_NEED(real_size);
+
+			if (is_64) {
+				r_variant = (int64_t)_get_64(r_buf);
+			} else {
+				r_variant = (int32_t)_get_32(r_buf);
+			}
+		} break;
+		case Variant::REAL: {
+			VARIANT_DECODE_NEED(real_size);
+
+			if (is_64) {
+				r_variant = decode_double(r_buf);
+			} else {
+				r_variant = decode_float(r_buf);
+			}
+
+			r_buf += real_size;
+		} break;
+		case Variant::STRING: {
+			String str;
+			err = _get_string(str, r_buf, p_end);
+			r_variant = str;
+		} break;
+		case Variant::STRING_NAME: {
+			String str;
+			err = _get_string(str, r_buf, p_end);
+			r_variant = StringName(str);
+		} break;
+		case Variant::RECT2: {
+			Rect2 value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::RECT2I: {
+			Rect2i value;
+			err = _get_ints_value(value, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR2I: {
+			Vector2i value;
+			err = _get_ints_value(value, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i value;
+			err = _get_ints_value(value, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR4: {
+			Vector4 value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::VECTOR4I: {
+			Vector4i value;
+			err = _get_ints_value(value, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::PLANE: {
+			Plane value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::QUATERNION: {
+			Quaternion value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::AABB: {
+			::AABB value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::BASIS: {
+			Basis value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::TRANSFORM: {
+			Transform value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::TRANSFORM2D: {
+			Transform2D value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::PROJECTION: {
+			Projection value;
+			err = _get_reals_value(value, is_64, r_buf, p_end);
+			r_variant = value;
+		} break;
+		case Variant::COLOR: {
+			VARIANT_DECODE_NEED(16);
+			Color value;
+			_get_scalars(value.components, 4, sizeof(float), r_buf);
+			r_buf += 16;
+			r_variant = value;
+		} break;
+		case Variant::OBJECT: {
+			VARIANT_DECODE_NEED(8);
+			ObjectID id = _get_64(r_buf);
+
+			if (p_allow_objects && id != 0) {
+				r_variant = ObjectDB::get_instance(id);
+			} else {
+				r_variant = Variant();
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			VARIANT_DECODE_NEED(4);
+			uint32_t count = _get_32(r_buf);
+			// Every element needs at least 8 bytes (2 headers), don't let a bad count spin for long.
+			VARIANT_DECODE_NEED((int64_t)count * 8);
+
+			Dictionary d;
+
+			for (uint32_t i = 0; i < count; ++i) {
+				Variant key;
+				err = _decode_variant(key, r_buf, p_end, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+
+				Variant value;
+				err = _decode_variant(value, r_buf, p_end, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+
+				d[key] = value;
+			}
+
+			r_variant = d;
+		} break;
+		case Variant::ARRAY: {
+			VARIANT_DECODE_NEED(4);
+			uint32_t count = _get_32(r_buf);
+			VARIANT_DECODE_NEED((int64_t)count * 4);
+
+			Array array;
+			array.resize(count);
+
+			for (uint32_t i = 0; i < count; ++i) {
+				err = _decode_variant(array[i], r_buf, p_end, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+			}
+
+			r_variant = array;
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+			PoolByteArray array;
+			err = _get_pool_array(array, 1, 1, 1, r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+			PoolIntArray array;
+			err = _get_pool_array(array, 1, sizeof(int32_t), sizeof(int32_t), r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+			PoolRealArray array;
+			err = _get_pool_array(array, 1, sizeof(real_t), real_size, r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+			VARIANT_DECODE_NEED(4);
+			uint32_t count = _get_32(r_buf);
+			VARIANT_DECODE_NEED((int64_t)count * 4);
+
+			PoolStringArray array;
+			array.resize(count);
+
+			if (count) {
+				PoolStringArray::Write w = array.write();
+
+				for (uint32_t i = 0; i < count; ++i) {
+					err = _get_string(w[i], r_buf, p_end);
+					ERR_FAIL_COND_V(err, err);
+				}
+			}
+
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+			PoolVector2Array array;
+			err = _get_pool_array(array, 2, sizeof(real_t), real_size, r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR2I_ARRAY: {
+			PoolVector2iArray array;
+			err = _get_pool_array(array, 2, sizeof(int32_t), sizeof(int32_t), r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR3_ARRAY: {
+			PoolVector3Array array;
+			err = _get_pool_array(array, 3, sizeof(real_t), real_size, r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR3I_ARRAY: {
+			PoolVector3iArray array;
+			err = _get_pool_array(array, 3, sizeof(int32_t), sizeof(int32_t), r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR4_ARRAY: {
+			PoolVector4Array array;
+			err = _get_pool_array(array, 4, sizeof(real_t), real_size, r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_VECTOR4I_ARRAY: {
+			PoolVector4iArray array;
+			err = _get_pool_array(array, 4, sizeof(int32_t), sizeof(int32_t), r_buf, p_end);
+			r_variant = array;
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+			PoolColorArray array;
+			err = _get_pool_array(array, 4, sizeof(float), sizeof(float), r_buf, p_end);
+			r_variant = array;
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_INVALID_DATA);
+		}
+	}
+
+	return err;
+}
+
+Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects, int p_depth) {
+	ERR_FAIL_COND_V(!p_buffer && p_len > 0, ERR_INVALID_PARAMETER);
+
+	const uint8_t *buf = p_buffer;
+	Error err = _decode_variant(r_variant, buf, p_buffer + p_len, p_allow_objects, p_depth);
+
+	if (r_len) {
+		*r_len = err == OK ? buf - p_buffer : 0;
+	}
+
+	return err;
+}
+
+Error get_encoded_pool_array(const uint8_t *p_buffer, int p_len, Variant::Type &r_type, const uint8_t *&r_data, int &r_count) {
+	ERR_FAIL_COND_V(!p_buffer || p_len < 8, ERR_INVALID_PARAMETER);
+
+	uint32_t header = decode_uint32(p_buffer);
+	uint32_t type = header & VARIANT_ENCODE_MASK;
+	bool is_64 = header & VARIANT_ENCODE_FLAG_64;
+
+	int element_size;
+
+	switch (type) {
+		case Variant::POOL_BYTE_ARRAY: {
+			element_size = 1;
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+			element_size = sizeof(int32_t);
+		} break;
+		case Variant::POOL_VECTOR2I_ARRAY: {
+			element_size = sizeof(Vector2i);
+		} break;
+		case Variant::POOL_VECTOR3I_ARRAY: {
+			element_size = sizeof(Vector3i);
+		} break;
+		case Variant::POOL_VECTOR4I_ARRAY: {
+			element_size = sizeof(Vector4i);
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+			element_size = sizeof(Color);
+		} break;
+		case Variant::POOL_REAL_ARRAY:
+		case Variant::POOL_VECTOR2_ARRAY:
+		case Variant::POOL_VECTOR3_ARRAY:
+		case Variant::POOL_VECTOR4_ARRAY: {
+			if (is_64 != (sizeof(real_t) == 8)) {
+				return ERR_UNAVAILABLE;
+			}
+
+			element_size = type == Variant::POOL_REAL_ARRAY ? sizeof(real_t) : type == Variant::POOL_VECTOR2_ARRAY ? sizeof(Vector2) : type == Variant::POOL_VECTOR3_ARRAY ? sizeof(Vector3) : sizeof(Vector4);
+		} break;
+		default: {
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Not an encoded pool array, or it can't be used in place.");
+		}
+	}
+
+#ifdef VARIANT_MARSHALLS_BIG_ENDIAN
+	if (element_size > 1) {
+		return ERR_UNAVAILABLE;
+	}
+#endif
+
+	uint32_t count = decode_uint32(p_buffer + 4);
+	ERR_FAIL_COND_V((int64_t)count * element_size > (int64_t)p_len - 8, ERR_INVALID_DATA);
+
+	r_type = (Variant::Type)type;
+	r_data = p_buffer + 8;
+	r_count = count;
+
+	return OK;
+}
+
+#undef VARIANT_DECODE_NEED
+#undef VARIANT_ENCODE_FLAG_REAL
@@ -0,0 +1,45 @@
+//--STRIP
+#ifndef VARIANT_MARSHALLS_H
+#define VARIANT_MARSHALLS_H
+//--STRIP
+
+//--STRIP
+#include "core/error_list.h"
+#include "core/marshalls.h"
+#include "object/variant.h"
+//--STRIP
+
+/**
+ * Binary (de)serialization of Variants, including Dictionary and Array trees.
+ *
+ * Every value starts with a 32 bit header, the low 16 bits are the Variant::Type, and
+ * VARIANT_ENCODE_FLAG_64 is set if the payload uses 64 bit ints / doubles. Everything is little endian and
+ * padded to 4 bytes. Pool arrays are a 32 bit element count followed by the raw elements, so on
+ * little endian hosts they are written and read with a single memcpy, and can be used in place
+ * (e.g. from FileAccessMapped::get_data()) through get_encoded_pool_array().
+ *
+ * Objects can't be serialized, only their ObjectID is stored.
+ */
+
+enum {
+	VARIANT_ENCODE_MASK = 0xFFFF,
+	VARIANT_ENCODE_FLAG_64 = 1 << 16,
+};
+
+// If r_buffer is NULL, only r_len is calculated. r_len is set to the encoded size in both cases.
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, int p_depth = 0);
+// Measures first, so r_data is allocated exactly once.
+Error encode_variant(const Variant &p_variant, PoolByteArray &r_data);
+
+// r_len is set to the number of bytes used.
+// With p_allow_objects, encoded ObjectIDs are looked up in this process's ObjectDB, otherwise they decode as null.
+Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = false, int p_depth = 0);
+
+// Zero copy access to an encoded pool array. r_data points into p_buffer at the elements.
+// Only succeeds if the data can be used as is, which means a little endian host, and, for real_t
+// based arrays, the same real_t size as the encoder. p_buffer must be aligned for the element type.
+Error get_encoded_pool_array(const uint8_t *p_buffer, int p_len, Variant::Type &r_type, const uint8_t *&r_data, int &r_count);
+
+//--STRIP
+#endif
+//--STRIP
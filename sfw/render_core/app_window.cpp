@@ -471,6 +471,8 @@ int AppWindow::frame_begin() {
 
 	glNewFrame();
 
+	++frame_count;
+
 	double now = paused ? t : glfwGetTime();
 	dt = now - t;
 	t = now;
@@ -481,6 +483,7 @@ int AppWindow::frame_begin() {
 }
 
 void AppWindow::frame_end() {
+	RenderState::flush(true);
 }
 
 void AppWindow::frame_swap() {
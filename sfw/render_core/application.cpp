@@ -12,6 +12,7 @@
 #include "render_core/app_window.h"
 #include "render_core/input.h"
 #include "render_core/input_map.h"
+#include "render_core/texture_streamer.h"
 
 #include "core/sfw_core.h"
 #include "object/core_string_names.h"
@@ -55,6 +56,11 @@ void Application::main_loop() {
 		return;
 	}
 
+	// Uploads the next pieces of the textures that are being loaded
+	if (TextureStreamer::has_singleton()) {
+		TextureStreamer::get_singleton()->update();
+	}
+
 	//handle input
 	Input::get_singleton()->iteration(frame_delta);
 
@@ -124,6 +130,9 @@ Application::~Application() {
 
 	CoreStringNames::free();
 
+	// Needs the GL context
+	TextureStreamer::cleanup();
+
 	// TODO add a helper static method
 	memdelete(AppWindow::get_singleton());
 	memdelete(Input::get_singleton());
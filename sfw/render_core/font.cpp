@@ -32,6 +32,7 @@
 #include "font.h"
 
 #include "app_window.h"
+#include "core/file_access_mapped.h"
 
 #include "3rd_glad.h"
 #define STB_TRUETYPE_IMPLEMENTATION
@@ -40,11 +41,86 @@
 #include "font_data_bm_mini.inc.h"
 #include "font_data_tables.inc.h"
 
+#include "core/flat_hash_map.h"
+#include "core/local_vector.h"
+#include "core/rect2i.h"
+
 #include "render_core/image.h"
 #include "render_core/mesh.h"
 #include "render_core/texture.h"
 //--STRIP
 
+// Atlas of a FONT_DYNAMIC font.
+// The atlas is split into pages (bands of rows over the full width), glyphs are packed into the pages in shelves.
+// It grows by a page at a time, once it reached the maximum size the least recently used page gets cleared and reused.
+// A page that was used in the current frame is never evicted, the text drawn earlier might not be rendered yet.
+struct Font::GlyphCache {
+	enum {
+		PADDING = 1,
+		// SDF atlases are filtered, their glyphs need more room to not bleed into each other
+		SDF_PADDING = 2,
+		// Texels around SDF glyphs, the distance field fades out over this many
+		SDF_SPREAD = 6,
+		SDF_ON_EDGE = 128,
+	};
+
+	struct Glyph {
+		TextureOffset offset;
+		// -1 for glyphs without pixels (spaces), or ones that didn't fit into the atlas
+		int page;
+		// Not 0 if the glyph didn't fit, it's drawn as an empty advance until this frame, then cached again.
+		uint64_t retry_frame;
+	};
+
+	struct Shelf {
+		int y;
+		int height;
+		int x;
+	};
+
+	struct Page {
+		int y;
+		int next_shelf_y;
+		uint64_t last_used;
+		LocalVector<Shelf> shelves;
+		LocalVector<uint32_t> codepoints;
+	};
+
+	// The font data has to be kept around
+	Vector<uint8_t> ttf_data;
+	stbtt_fontinfo info;
+
+	float scale;
+	int oversample_h;
+	int oversample_v;
+	bool sdf;
+	// Empty texels right and below every glyph
+	int padding;
+
+	int page_height;
+	int max_height;
+
+	FlatHashMap<uint32_t, Glyph> glyphs;
+	LocalVector<Page> pages;
+	uint32_t version;
+
+	// Rasterized, but not uploaded yet
+	Rect2i dirty;
+	// The atlas grew, the texture has to be recreated
+	bool texture_stale;
+};
+
+static void _font_get_vertical_metrics(const stbtt_fontinfo *info, float &r_ascent, float &r_descent, float &r_linegap) {
+	int a, d, l;
+	if (!stbtt_GetFontVMetricsOS2(info, &a, &d, &l)) {
+		stbtt_GetFontVMetrics(info, &a, &d, &l);
+	}
+
+	r_ascent = a;
+	r_descent = d;
+	r_linegap = l;
+}
+
 void Font::load_default(const float size, const uint32_t flags) {
 	font_face_from_mem(bm_mini_ttf, 20176, size, flags);
 }
@@ -82,6 +158,11 @@ void Font::font_face_from_mem(const void *ttf_data, uint32_t ttf_len, float font
 	_font_size = font_size;
 	_scale = 1.0000f;
 
+	if (flags & (FONT_DYNAMIC | FONT_SDF)) {
+		_init_glyph_cache(ttf_data, ttf_len, flags);
+		return;
+	}
+
 // figure out what ranges we're about to bake
 #define MERGE_TABLE(table)                                     \
 	do {                                                       \
@@ -224,15 +305,8 @@ void Font::font_face_from_mem(const void *ttf_data, uint32_t ttf_len, float font
 	stbtt_fontinfo info = { 0 };
 	stbtt_InitFont(&info, (const unsigned char *)ttf_data, stbtt_GetFontOffsetForIndex((const unsigned char *)ttf_data, 0));
 
-	int a, d, l;
-	if (!stbtt_GetFontVMetricsOS2(&info, &a, &d, &l)) {
-		stbtt_GetFontVMetrics(&info, &a, &d, &l);
-	}
-
-	_ascent = a;
-	_descent = d;
-	_linegap = l;
-	_linedist = (a - d + l);
+	_font_get_vertical_metrics(&info, _ascent, _descent, _linegap);
+	_linedist = (_ascent - _descent + _linegap);
 	_factor = (_font_size / (_ascent - _descent));
 
 	// save some gpu memory by truncating unused vertical space in atlas texture
@@ -304,16 +378,426 @@ void Font::font_face_from_mem(const void *ttf_data, uint32_t ttf_len, float font
 }
 
 void Font::font_face(const char *filename_ttf, float font_size, unsigned flags) {
-	/*
-	font_init();
+	Error err;
+	FileAccessMapped *f = FileAccess::create_mapped(String::utf8(filename_ttf), &err);
+
+	ERR_FAIL_COND_MSG(err != OK, "Couldn't open font! " + String::utf8(filename_ttf));
+
+	if (f->get_size() > UINT32_MAX) {
+		memdelete(f);
+		ERR_FAIL_MSG("Font file is too big! " + String::utf8(filename_ttf));
+	}
+
+	// Baked fonts are packed into the atlas here. Dynamic and SDF fonts keep their own copy of the ttf data.
+	font_face_from_mem(f->get_data(), f->get_size(), font_size, flags);
+
+	memdelete(f);
+}
+
+void Font::cache_glyphs(const String &p_text) const {
+	GlyphCache *cache = _glyph_cache;
+
+	if (!cache) {
+		return;
+	}
+
+	uint64_t frame = AppWindow::get_singleton() ? AppWindow::get_singleton()->frame() : 0;
+
+	for (int i = 0, end = p_text.length(); i < end; ++i) {
+		uint32_t ch = p_text[i];
+
+		if (ch == '\n') {
+			continue;
+		}
+
+		const GlyphCache::Glyph *g = cache->glyphs.getptr(ch);
+
+		if (!g || (g->retry_frame != 0 && frame >= g->retry_frame)) {
+			_cache_glyph(ch, frame);
+		} else if (g->page >= 0) {
+			cache->pages[g->page].last_used = frame;
+		}
+	}
+
+	if (cache->texture_stale) {
+		// The old texture is left alone, text that was batched with it is still drawn correctly.
+		_texture.instance();
+
+		if (cache->sdf) {
+			_texture->set_flags(Texture::TEXTURE_FLAG_FILTER);
+		}
+
+		_texture->create_from_image(_image);
+
+		cache->texture_stale = false;
+		cache->dirty = Rect2i();
+	} else if (!cache->dirty.has_no_area()) {
+		_texture->update_region(cache->dirty);
+
+		cache->dirty = Rect2i();
+	}
+}
+
+bool Font::is_dynamic() const {
+	return _glyph_cache != NULL;
+}
+
+bool Font::is_sdf() const {
+	return _glyph_cache && _glyph_cache->sdf;
+}
+
+uint32_t Font::get_atlas_version() const {
+	return _glyph_cache ? _glyph_cache->version : 0;
+}
 
-	int len;
-	const char *buffer = vfs_load(filename_ttf, &len);
-	if (!buffer)
-		buffer = file_load(filename_ttf, &len);
+void Font::_init_glyph_cache(const void *ttf_data, uint32_t ttf_len, uint32_t flags) {
+	GlyphCache *cache = memnew(GlyphCache);
 
-	font_face_from_mem(tag, buffer, len, font_size, flags);
-	*/
+	cache->ttf_data.resize(ttf_len);
+	memcpy(cache->ttf_data.ptrw(), ttf_data, ttf_len);
+
+	const unsigned char *data = cache->ttf_data.ptr();
+
+	if (!stbtt_InitFont(&cache->info, data, stbtt_GetFontOffsetForIndex(data, 0))) {
+		memdelete(cache);
+		ERR_FAIL_MSG("Failed to initialize font!");
+	}
+
+	cache->scale = stbtt_ScaleForPixelHeight(&cache->info, _font_size);
+	cache->sdf = flags & FONT_SDF;
+	cache->oversample_h = !cache->sdf && (flags & FONT_OVERSAMPLE_X) ? 2 : 1;
+	cache->oversample_v = !cache->sdf && (flags & FONT_OVERSAMPLE_Y) ? 2 : 1;
+
+	cache->padding = cache->sdf ? GlyphCache::SDF_PADDING : GlyphCache::PADDING;
+
+	int max_glyph_height = Math::ceil(_font_size * cache->oversample_v) + cache->padding;
+
+	if (cache->sdf) {
+		max_glyph_height += GlyphCache::SDF_SPREAD * 2;
+	}
+
+	// A page has room for at least a couple of rows
+	cache->max_height = _height;
+	cache->page_height = CLAMP((int)next_power_of_2(max_glyph_height) * 2, 64, cache->max_height);
+
+	cache->version = 0;
+	cache->texture_stale = false;
+
+	_glyph_cache = cache;
+
+	_font_get_vertical_metrics(&cache->info, _ascent, _descent, _linegap);
+	_linedist = (_ascent - _descent + _linegap);
+	_factor = (_font_size / (_ascent - _descent));
+
+	// Starts with a single page
+	_height = 0;
+	_image.instance();
+	_grow_atlas();
+
+	_texture.instance();
+
+	// Distance fields have to be interpolated, that's what keeps them sharp when scaled up.
+	if (cache->sdf) {
+		_texture->set_flags(Texture::TEXTURE_FLAG_FILTER);
+	}
+
+	_texture->create_from_image(_image);
+	cache->texture_stale = false;
+
+	_initialized = true;
+}
+
+void Font::_cache_glyph(uint32_t p_codepoint, uint64_t p_frame) const {
+	GlyphCache *cache = _glyph_cache;
+
+	// 0 is the missing glyph box
+	int glyph = stbtt_FindGlyphIndex(&cache->info, p_codepoint);
+
+	int advance;
+	int lsb;
+	stbtt_GetGlyphHMetrics(&cache->info, glyph, &advance, &lsb);
+
+	GlyphCache::Glyph g;
+	g.page = -1;
+	g.retry_frame = 0;
+
+	TextureOffset &t = g.offset;
+	memset(&t, 0, sizeof(TextureOffset));
+	t.xadvance = cache->scale * advance;
+
+	if (stbtt_IsGlyphEmpty(&cache->info, glyph)) {
+		cache->glyphs.insert(p_codepoint, g);
+		return;
+	}
+
+	if (cache->sdf) {
+		_cache_sdf_glyph(p_codepoint, glyph, t.xadvance, p_frame);
+		return;
+	}
+
+	float scale_x = cache->scale * cache->oversample_h;
+	float scale_y = cache->scale * cache->oversample_v;
+
+	int x0, y0, x1, y1;
+	stbtt_GetGlyphBitmapBoxSubpixel(&cache->info, glyph, scale_x, scale_y, 0, 0, &x0, &y0, &x1, &y1);
+
+	// Same sizes and offsets as stbtt_PackFontRange()
+	int w = x1 - x0 + cache->oversample_h - 1;
+	int h = y1 - y0 + cache->oversample_v - 1;
+
+	int page;
+	int x;
+	int y;
+
+	if (!_allocate_glyph_rect(w + cache->padding, h + cache->padding, p_frame, page, x, y)) {
+		// Every page is in use this frame, it gets another chance in the next one.
+		// Until then the text still advances past it.
+		g.retry_frame = p_frame + 1;
+		cache->glyphs.insert(p_codepoint, g);
+		return;
+	}
+
+	float sub_x;
+	float sub_y;
+	stbtt_MakeGlyphBitmapSubpixelPrefilter(&cache->info, _image->dataw() + y * _width + x, w, h, _width, scale_x, scale_y, 0, 0, cache->oversample_h, cache->oversample_v, &sub_x, &sub_y, glyph);
+
+	float recip_h = 1.0f / cache->oversample_h;
+	float recip_v = 1.0f / cache->oversample_v;
+
+	t.x0_orig = x;
+	t.y0_orig = y;
+	t.x1_orig = x + w;
+	t.y1_orig = y + h;
+
+	t.x0 = t.x0_orig / (double)_width;
+	t.y0 = t.y0_orig / (double)_height;
+	t.x1 = t.x1_orig / (double)_width;
+	t.y1 = t.y1_orig / (double)_height;
+
+	t.xoff = x0 * recip_h + sub_x;
+	t.yoff = y0 * recip_v + sub_y;
+	t.xoff2 = (x0 + w) * recip_h + sub_x;
+	t.yoff2 = (y0 + h) * recip_v + sub_y;
+
+	g.page = page;
+
+	GlyphCache::Page &p = cache->pages[page];
+	p.codepoints.push_back(p_codepoint);
+	p.last_used = p_frame;
+
+	Rect2i rect(x, y, w, h);
+	cache->dirty = cache->dirty.has_no_area() ? rect : cache->dirty.merge(rect);
+
+	cache->glyphs.insert(p_codepoint, g);
+}
+
+void Font::_cache_sdf_glyph(uint32_t p_codepoint, int p_glyph, float p_xadvance, uint64_t p_frame) const {
+	GlyphCache *cache = _glyph_cache;
+
+	GlyphCache::Glyph g;
+	g.page = -1;
+	g.retry_frame = 0;
+
+	TextureOffset &t = g.offset;
+	memset(&t, 0, sizeof(TextureOffset));
+	t.xadvance = p_xadvance;
+
+	// The distance is 0.5 (SDF_ON_EDGE) on the outline, and reaches 0 SDF_SPREAD texels outside of it.
+	int w;
+	int h;
+	int xoff;
+	int yoff;
+	unsigned char *bitmap = stbtt_GetGlyphSDF(&cache->info, cache->scale, p_glyph, GlyphCache::SDF_SPREAD, GlyphCache::SDF_ON_EDGE, (float)GlyphCache::SDF_ON_EDGE / GlyphCache::SDF_SPREAD, &w, &h, &xoff, &yoff);
+
+	if (!bitmap) {
+		cache->glyphs.insert(p_codepoint, g);
+		return;
+	}
+
+	int page;
+	int x;
+	int y;
+
+	if (!_allocate_glyph_rect(w + cache->padding, h + cache->padding, p_frame, page, x, y)) {
+		stbtt_FreeSDF(bitmap, NULL);
+
+		g.retry_frame = p_frame + 1;
+		cache->glyphs.insert(p_codepoint, g);
+		return;
+	}
+
+	uint8_t *dst = _image->dataw() + y * _width + x;
+
+	for (int i = 0; i < h; ++i) {
+		memcpy(dst + i * _width, bitmap + i * w, w);
+	}
+
+	stbtt_FreeSDF(bitmap, NULL);
+
+	t.x0_orig = x;
+	t.y0_orig = y;
+	t.x1_orig = x + w;
+	t.y1_orig = y + h;
+
+	t.x0 = t.x0_orig / (double)_width;
+	t.y0 = t.y0_orig / (double)_height;
+	t.x1 = t.x1_orig / (double)_width;
+	t.y1 = t.y1_orig / (double)_height;
+
+	// The quad includes the spread, the advance doesn't
+	t.xoff = xoff;
+	t.yoff = yoff;
+	t.xoff2 = xoff + w;
+	t.yoff2 = yoff + h;
+
+	g.page = page;
+
+	GlyphCache::Page &p = cache->pages[page];
+	p.codepoints.push_back(p_codepoint);
+	p.last_used = p_frame;
+
+	Rect2i rect(x, y, w, h);
+	cache->dirty = cache->dirty.has_no_area() ? rect : cache->dirty.merge(rect);
+
+	cache->glyphs.insert(p_codepoint, g);
+}
+
+bool Font::_allocate_glyph_rect(int p_width, int p_height, uint64_t p_frame, int &r_page, int &r_x, int &r_y) const {
+	GlyphCache *cache = _glyph_cache;
+
+	ERR_FAIL_COND_V(p_width > _width || p_height > cache->page_height, false);
+
+	while (true) {
+		for (uint32_t i = 0; i < cache->pages.size(); ++i) {
+			GlyphCache::Page &page = cache->pages[i];
+
+			// The lowest shelf the glyph fits on
+			GlyphCache::Shelf *best = NULL;
+
+			for (uint32_t j = 0; j < page.shelves.size(); ++j) {
+				GlyphCache::Shelf &shelf = page.shelves[j];
+
+				if (shelf.height >= p_height && shelf.x + p_width <= _width && (!best || shelf.height < best->height)) {
+					best = &shelf;
+				}
+			}
+
+			if (!best && page.next_shelf_y + p_height <= cache->page_height) {
+				GlyphCache::Shelf shelf;
+				shelf.y = page.next_shelf_y;
+				shelf.height = p_height;
+				shelf.x = 0;
+
+				page.shelves.push_back(shelf);
+				page.next_shelf_y += p_height;
+
+				best = &page.shelves[page.shelves.size() - 1];
+			}
+
+			if (best) {
+				r_page = i;
+				r_x = best->x;
+				r_y = page.y + best->y;
+
+				best->x += p_width;
+
+				return true;
+			}
+		}
+
+		if (!_grow_atlas() && !_evict_page(p_frame)) {
+			return false;
+		}
+	}
+}
+
+bool Font::_grow_atlas() const {
+	GlyphCache *cache = _glyph_cache;
+
+	int old_height = _height;
+	int new_height = _height + cache->page_height;
+
+	if (new_height > cache->max_height) {
+		return false;
+	}
+
+	Vector<uint8_t> data = _image->get_data();
+	data.resize(_width * new_height);
+	memset(data.ptrw() + _width * old_height, 0, _width * (new_height - old_height));
+
+	// A new image, the old one is still used by the old texture
+	_image.instance();
+	_image->create(_width, new_height, false, Image::FORMAT_L8, data);
+	_height = new_height;
+
+	GlyphCache::Page page;
+	page.y = old_height;
+	page.next_shelf_y = 0;
+	page.last_used = 0;
+	cache->pages.push_back(page);
+
+	// The uvs are relative to the height
+	for (FlatHashMap<uint32_t, GlyphCache::Glyph>::Iterator E = cache->glyphs.begin(); E != cache->glyphs.end(); ++E) {
+		TextureOffset &t = E.value().offset;
+
+		t.y0 = t.y0_orig / (double)_height;
+		t.y1 = t.y1_orig / (double)_height;
+	}
+
+	cache->texture_stale = true;
+	++cache->version;
+
+	return true;
+}
+
+bool Font::_evict_page(uint64_t p_frame) const {
+	GlyphCache *cache = _glyph_cache;
+
+	int oldest = -1;
+
+	for (uint32_t i = 0; i < cache->pages.size(); ++i) {
+		const GlyphCache::Page &page = cache->pages[i];
+
+		if (page.last_used == p_frame) {
+			continue;
+		}
+
+		if (oldest == -1 || page.last_used < cache->pages[oldest].last_used) {
+			oldest = i;
+		}
+	}
+
+	if (oldest == -1) {
+		return false;
+	}
+
+	GlyphCache::Page &page = cache->pages[oldest];
+
+	for (uint32_t i = 0; i < page.codepoints.size(); ++i) {
+		cache->glyphs.erase(page.codepoints[i]);
+	}
+
+	page.codepoints.clear();
+	page.shelves.clear();
+	page.next_shelf_y = 0;
+
+	memset(_image->dataw() + page.y * _width, 0, cache->page_height * _width);
+
+	Rect2i rect(0, page.y, _width, cache->page_height);
+	cache->dirty = cache->dirty.has_no_area() ? rect : cache->dirty.merge(rect);
+
+	++cache->version;
+
+	return true;
+}
+
+const Font::TextureOffset *Font::_get_texture_offset(uint32_t p_codepoint) const {
+	if (!_glyph_cache) {
+		return &_texture_offsets[_cp2iter[p_codepoint - _begin]];
+	}
+
+	const GlyphCache::Glyph *g = _glyph_cache->glyphs.getptr(p_codepoint);
+	return g ? &g->offset : NULL;
 }
 
 Vector2 Font::generate_mesh(const String &p_text, Ref<Mesh> &p_into, const Color &p_color) const {
@@ -326,7 +810,9 @@ Vector2 Font::generate_mesh(const String &p_text, Ref<Mesh> &p_into, const Color
 	float L = _ascent * _factor * _scale;
 	float LL = L; // LL=largest linedist
 
-	int mesh_index_offset = p_into->indices.size();
+	cache_glyphs(p_text);
+
+	int mesh_index_offset = p_into->get_vertex_count();
 
 	// parse string
 	for (int i = 0, end = p_text.length(); i < end; ++i) {
@@ -344,25 +830,34 @@ Vector2 Font::generate_mesh(const String &p_text, Ref<Mesh> &p_into, const Color
 			continue;
 		}
 
-		int cp = ch - _begin;
+		const TextureOffset *tp = _get_texture_offset(ch);
+
+		if (!tp) {
+			continue;
+		}
+
+		const TextureOffset &t = *tp;
 
-		const TextureOffset &t = _texture_offsets[_cp2iter[cp]];
+		float x0 = X + t.xoff * _scale;
+		float y0 = Y + t.yoff * _scale;
+		float x1 = X + t.xoff2 * _scale;
+		float y1 = Y + t.yoff2 * _scale;
 
 		p_into->add_uv(t.x0, t.y0);
 		p_into->add_color(p_color);
-		p_into->add_vertex2(X + t.xoff, Y + t.yoff);
+		p_into->add_vertex2(x0, y0);
 
 		p_into->add_uv(t.x1, t.y1);
 		p_into->add_color(p_color);
-		p_into->add_vertex2(X + t.xoff2, Y + t.yoff2);
+		p_into->add_vertex2(x1, y1);
 
 		p_into->add_uv(t.x0, t.y1);
 		p_into->add_color(p_color);
-		p_into->add_vertex2(X + t.xoff, Y + t.yoff2);
+		p_into->add_vertex2(x0, y1);
 
 		p_into->add_uv(t.x1, t.y0);
 		p_into->add_color(p_color);
-		p_into->add_vertex2(X + t.xoff2, Y + t.yoff);
+		p_into->add_vertex2(x1, y0);
 
 		p_into->add_triangle(mesh_index_offset + 1, mesh_index_offset + 0, mesh_index_offset + 2);
 		p_into->add_triangle(mesh_index_offset + 0, mesh_index_offset + 1, mesh_index_offset + 3);
@@ -387,6 +882,9 @@ Vector2 Font::get_string_size(const String &p_text) const {
 	float L = _ascent * _factor * _scale;
 	float LL = L; // LL=largest linedist
 
+	// the advances are only known after rasterizing
+	cache_glyphs(p_text);
+
 	// parse string
 	for (int i = 0, end = p_text.length(); i < end; ++i) {
 		uint32_t ch = p_text[i];
@@ -403,9 +901,11 @@ Vector2 Font::get_string_size(const String &p_text) const {
 			continue;
 		}
 
-		int cp = ch - _begin;
-		const TextureOffset &t = _texture_offsets[_cp2iter[cp]];
-		X += t.xadvance * _scale;
+		const TextureOffset *t = _get_texture_offset(ch);
+
+		if (t) {
+			X += t->xadvance * _scale;
+		}
 	}
 
 	Y += (-_descent + _linegap) * _factor * _scale;
@@ -466,6 +966,11 @@ void Font::unload() {
 	_texture.unref();
 
 	_texture_offsets.clear();
+
+	if (_glyph_cache) {
+		memdelete(_glyph_cache);
+		_glyph_cache = NULL;
+	}
 }
 
 Font::Font() {
@@ -487,6 +992,8 @@ Font::Font() {
 	_linegap = 0;
 	_linedist = 0;
 
+	_glyph_cache = NULL;
+
 	_image.instance();
 	_texture.instance();
 }
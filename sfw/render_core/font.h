@@ -52,6 +52,14 @@ public:
 		FONT_VI = 0x400000, // Vietnamese
 		FONT_CJK = FONT_ZH | FONT_JP | FONT_KR,
 
+		// rasterize glyphs on first use instead of baking the unicode ranges at load time.
+		// the atlas size flag becomes the maximum size of the atlas.
+		FONT_DYNAMIC = 0x800000,
+
+		// store signed distance fields instead of coverage, so a single size stays sharp when scaled up.
+		// needs SDFFontMaterial to render. implies FONT_DYNAMIC, oversampling is ignored.
+		FONT_SDF = 0x1000000,
+
 		// FONT_DEFAULTS = FONT_512 | FONT_NO_OVERSAMPLE | FONT_ASCII,
 	};
 
@@ -76,6 +84,15 @@ public:
 	Vector2 get_string_size(const String &p_text) const;
 	FontMetrics font_metrics() const;
 
+	// FONT_DYNAMIC: rasterizes the glyphs of p_text that are not in the atlas yet, and uploads them.
+	// generate_mesh() does this too, but the atlas texture gets replaced when it grows,
+	// so call this first if get_texture() is needed for the same text.
+	void cache_glyphs(const String &p_text) const;
+	bool is_dynamic() const;
+	bool is_sdf() const;
+	// Changes whenever glyphs get evicted or the atlas grows. Meshes generated before that have to be regenerated.
+	uint32_t get_atlas_version() const;
+
 	int get_atlas_width() const;
 	int get_atlas_height() const;
 
@@ -98,7 +115,7 @@ protected:
 	// font info and data
 	bool _initialized;
 
-	int _height; // bitmap height
+	mutable int _height; // bitmap height, dynamic fonts grow it
 	int _width; // bitmap width
 	float _font_size; // font size in pixels (matches scale[0+1] size below)
 	float _factor; // font factor (font_size / (ascent - descent))
@@ -111,8 +128,9 @@ protected:
 	float _linedist; // distance between the baseline of two lines (ascent - descent + linegap)
 
 	// opengl stuff
-	Ref<Image> _image;
-	Ref<Texture> _texture;
+	// dynamic fonts replace these when the atlas grows
+	mutable Ref<Image> _image;
+	mutable Ref<Texture> _texture;
 
 	struct TextureOffset {
 		float x0;
@@ -133,6 +151,21 @@ protected:
 	};
 
 	Vector<TextureOffset> _texture_offsets;
+
+	friend class TextLayout;
+
+	// FONT_DYNAMIC state, defined in font.cpp
+	struct GlyphCache;
+
+	void _init_glyph_cache(const void *ttf_data, uint32_t ttf_len, uint32_t flags);
+	void _cache_glyph(uint32_t p_codepoint, uint64_t p_frame) const;
+	void _cache_sdf_glyph(uint32_t p_codepoint, int p_glyph, float p_xadvance, uint64_t p_frame) const;
+	bool _allocate_glyph_rect(int p_width, int p_height, uint64_t p_frame, int &r_page, int &r_x, int &r_y) const;
+	bool _grow_atlas() const;
+	bool _evict_page(uint64_t p_frame) const;
+	const TextureOffset *_get_texture_offset(uint32_t p_codepoint) const;
+
+	GlyphCache *_glyph_cache;
 };
 
 //--STRIP
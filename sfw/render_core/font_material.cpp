@@ -90,3 +90,74 @@ FontMaterial::FontMaterial() {
 
 	texture_location = 0;
 }
+
+//SDFFontMaterial
+
+void SDFFontMaterial::bind_uniforms() {
+	FontMaterial::bind_uniforms();
+
+	glUniform1f(smoothing_location, smoothing);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void SDFFontMaterial::setup_uniforms() {
+	FontMaterial::setup_uniforms();
+
+	smoothing_location = get_uniform("u_smoothing");
+}
+
+void SDFFontMaterial::unbind() {
+	glDisable(GL_BLEND);
+
+	FontMaterial::unbind();
+}
+
+String SDFFontMaterial::get_fragment_shader_source() {
+	static const char *fragment_shader_source[] = {
+#ifndef __APPLE__
+		"#version 100\n"
+		"#ifdef GL_OES_standard_derivatives\n"
+		"    #extension GL_OES_standard_derivatives : enable\n"
+		"    #define HAS_FWIDTH\n"
+		"#endif\n"
+		"#ifdef GL_ES\n"
+		"    precision mediump float;\n"
+		"#endif\n"
+#else
+		"#define HAS_FWIDTH\n"
+#endif
+		"\n"
+		"uniform sampler2D u_texture;\n"
+		"uniform float u_smoothing;\n"
+		"\n"
+		"varying vec2 v_uv;\n"
+		"varying vec4 v_color;\n"
+		"\n"
+		"void main() {\n"
+		"  float dist = texture2D(u_texture, v_uv).r;\n"
+		"\n"
+		"#ifdef HAS_FWIDTH\n"
+		"  float w = fwidth(dist) * 0.5;\n"
+		"#else\n"
+		"  float w = u_smoothing;\n"
+		"#endif\n"
+		"\n"
+		"  float alpha = smoothstep(0.5 - w, 0.5 + w, dist);\n"
+		"\n"
+		"  if (alpha <= 0.0) {\n"
+		"    discard;\n"
+		"  }\n"
+		"\n"
+		"  gl_FragColor = vec4(v_color.rgb, v_color.a * alpha);\n"
+		"}"
+	};
+
+	return String(*fragment_shader_source);
+}
+
+SDFFontMaterial::SDFFontMaterial() {
+	smoothing_location = 0;
+	smoothing = 0.05;
+}
@@ -36,6 +36,29 @@ public:
 	Ref<Texture> texture;
 };
 
+// For Font::FONT_SDF fonts. The edge gets antialiased and blended, so it stays sharp at any scale.
+class SDFFontMaterial : public FontMaterial {
+	SFW_OBJECT(SDFFontMaterial, FontMaterial);
+
+public:
+	int get_material_id() {
+		return 9;
+	}
+
+	void bind_uniforms();
+	void setup_uniforms();
+	void unbind();
+
+	String get_fragment_shader_source();
+
+	SDFFontMaterial();
+
+	int32_t smoothing_location;
+
+	// Width of the antialiased edge in distance units, only used if the GPU can't compute it (no fwidth()).
+	float smoothing;
+};
+
 //--STRIP
 #endif // TEXT_MATERIAL_H
 //--STRIP
@@ -171,9 +171,13 @@ uint32_t FrameBuffer::get_gl_texture() {
 }
 
 void FrameBuffer::bind() {
+	RenderState::flush();
+
 	glBindFramebuffer(GL_FRAMEBUFFER, get_gl_fbo());
 }
 void FrameBuffer::unbind() {
+	RenderState::flush();
+
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 void FrameBuffer::update() {
@@ -286,12 +290,16 @@ void FrameBuffer::blit_depth_to(const uint32_t p_destination_framebuffer, const
 }
 
 void FrameBuffer::set_as_viewport() {
+	RenderState::flush();
+
 	RenderState::current_framebuffer = Ref<FrameBuffer>(this);
 	RenderState::render_rect = Rect2i(0, 0, _fbo_width, _fbo_height);
 	RenderState::apply_render_rect();
 }
 
 void FrameBuffer::reset_as_viewport() {
+	RenderState::flush();
+
 	RenderState::current_framebuffer.unref();
 	RenderState::render_rect = Rect2i(0, 0, AppWindow::get_singleton()->get_width(), AppWindow::get_singleton()->get_height());
 	RenderState::apply_render_rect();
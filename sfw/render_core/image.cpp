@@ -11,6 +11,7 @@
 #include "core/memory.h"
 #include "core/vector3.h"
 #include "core/file_access.h"
+#include "core/file_access_mapped.h"
 #include "math.h"
 #include <memory.h>
 #include <stdio.h>
@@ -1413,10 +1414,16 @@ void Image::load_from_file(const String &file_name, Format p_format) {
 
 	int img_n = 4;
 
+	// Decode straight from the mapping, so the file's contents don't need to be loaded into memory first.
 	Error err;
-	Vector<uint8_t> file_data = FileAccess::get_file_as_array(file_name, &err);
+	FileAccessMapped *f = FileAccess::create_mapped(file_name, &err);
 
-	ERR_FAIL_COND(err != OK);
+	ERR_FAIL_COND_MSG(err != OK, "Couldn't open image! " + file_name);
+
+	if (f->get_size() > INT32_MAX) {
+		memdelete(f);
+		ERR_FAIL_MSG("Image file is too big! " + file_name);
+	}
 
 	//case FORMAT_RF:
 	//case FORMAT_RGF:
@@ -1428,7 +1435,9 @@ void Image::load_from_file(const String &file_name, Format p_format) {
 	int y;
 	int n;
 
-	stbi_uc *pixels = stbi_load_from_memory(file_data.ptr(), file_data.size(), &x, &y, &n, img_n);
+	stbi_uc *pixels = stbi_load_from_memory(f->get_data(), f->get_size(), &x, &y, &n, img_n);
+
+	memdelete(f);
 
 	ERR_FAIL_COND_MSG(!pixels, "Couldn't load image! " + file_name);
 
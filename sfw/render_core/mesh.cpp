@@ -4,6 +4,55 @@
 #include "render_core/shader.h"
 //--STRIP
 
+Mesh::BufferUsage Mesh::get_buffer_usage() const {
+	return _buffer_usage;
+}
+void Mesh::set_buffer_usage(const BufferUsage p_usage) {
+	if (_buffer_usage == p_usage) {
+		return;
+	}
+
+	_buffer_usage = p_usage;
+
+	// The buffers will need to be reallocated with the new usage hint
+	_vbo_capacity = 0;
+	_ibo_capacity = 0;
+}
+
+Mesh::VertexLayout Mesh::get_vertex_layout() const {
+	return _vertex_layout;
+}
+void Mesh::set_vertex_layout(const VertexLayout p_layout) {
+	_vertex_layout = p_layout;
+}
+
+Mesh::NormalFormat Mesh::get_normal_format() const {
+	return _normal_format;
+}
+void Mesh::set_normal_format(const NormalFormat p_format) {
+	_normal_format = p_format;
+}
+
+Mesh::ColorFormat Mesh::get_color_format() const {
+	return _color_format;
+}
+void Mesh::set_color_format(const ColorFormat p_format) {
+	_color_format = p_format;
+}
+
+Mesh::UVFormat Mesh::get_uv_format() const {
+	return _uv_format;
+}
+void Mesh::set_uv_format(const UVFormat p_format) {
+	_uv_format = p_format;
+}
+
+void Mesh::set_compact_vertex_format() {
+	_vertex_layout = VERTEX_LAYOUT_INTERLEAVED;
+	_color_format = COLOR_FORMAT_RGBA8;
+	_uv_format = UV_FORMAT_UNORM16;
+}
+
 void Mesh::add_vertex2(float x, float y) {
 	vertices.push_back(x);
 	vertices.push_back(y);
@@ -220,14 +269,26 @@ void Mesh::upload() {
 		glGenBuffers(1, &VBO);
 	}
 
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+	if (_vertex_layout == VERTEX_LAYOUT_INTERLEAVED) {
+		_upload_interleaved();
+		return;
+	}
+
+	_uploaded_vertex_layout = VERTEX_LAYOUT_PLANAR;
+
 	vertices_vbo_size = sizeof(float) * vertices.size();
 	normals_vbo_size = sizeof(float) * normals.size();
 	colors_vbo_size = sizeof(float) * colors.size();
 	uvs_vbo_size = sizeof(float) * uvs.size();
-	indices_vbo_size = sizeof(uint32_t) * indices.size();
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices_vbo_size + normals_vbo_size + colors_vbo_size + uvs_vbo_size, NULL, GL_STATIC_DRAW);
+	if (_buffer_usage == BUFFER_USAGE_STATIC) {
+		_vbo_capacity = vertices_vbo_size + normals_vbo_size + colors_vbo_size + uvs_vbo_size;
+		glBufferData(GL_ARRAY_BUFFER, _vbo_capacity, NULL, GL_STATIC_DRAW);
+	} else {
+		_prepare_buffer(GL_ARRAY_BUFFER, vertices_vbo_size + normals_vbo_size + colors_vbo_size + uvs_vbo_size, _vbo_capacity);
+	}
 
 	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_vbo_size, vertices.ptr());
 
@@ -243,15 +304,73 @@ void Mesh::upload() {
 		glBufferSubData(GL_ARRAY_BUFFER, vertices_vbo_size + normals_vbo_size + colors_vbo_size, uvs_vbo_size, uvs.ptr());
 	}
 
-	if (indices_vbo_size > 0) {
-		if (!IBO) {
-			glGenBuffers(1, &IBO);
+	_upload_indices();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+void Mesh::upload_range(const int p_from_vertex, const int p_to_vertex) {
+	if (_buffer_usage != BUFFER_USAGE_DYNAMIC || !VBO || _uploaded_vertex_layout != _vertex_layout) {
+		upload();
+		return;
+	}
+
+	if (_vertex_layout == VERTEX_LAYOUT_INTERLEAVED) {
+		InterleavedLayout layout = _calculate_interleaved_layout();
+
+		if (!(layout == _uploaded_interleaved_layout) || vertices_vbo_size != (uint32_t)(layout.stride * get_vertex_count())) {
+			upload();
+			return;
 		}
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_vbo_size, indices.ptr(), GL_STATIC_DRAW);
+		int from = MAX(p_from_vertex, 0);
+		int to = MIN(p_to_vertex, get_vertex_count());
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		if (from >= to) {
+			return;
+		}
+
+		_interleaved_data.resize((to - from) * layout.stride);
+		_pack_interleaved(layout, from, to, _interleaved_data.ptrw());
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, from * layout.stride, _interleaved_data.size(), _interleaved_data.ptr());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		return;
+	}
+
+	// If the layout changed, the whole buffer needs to be re-uploaded
+	if (vertices_vbo_size != sizeof(float) * vertices.size() ||
+			normals_vbo_size != sizeof(float) * normals.size() ||
+			colors_vbo_size != sizeof(float) * colors.size() ||
+			uvs_vbo_size != sizeof(float) * uvs.size()) {
+		upload();
+		return;
+	}
+
+	int from = MAX(p_from_vertex, 0);
+	int to = MIN(p_to_vertex, get_vertex_count());
+
+	if (from >= to) {
+		return;
+	}
+
+	int count = to - from;
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * from * vertex_dimesions, sizeof(float) * count * vertex_dimesions, vertices.ptr() + from * vertex_dimesions);
+
+	if (normals_vbo_size > 0) {
+		glBufferSubData(GL_ARRAY_BUFFER, vertices_vbo_size + sizeof(float) * from * 3, sizeof(float) * count * 3, normals.ptr() + from * 3);
+	}
+
+	if (colors_vbo_size > 0) {
+		glBufferSubData(GL_ARRAY_BUFFER, vertices_vbo_size + normals_vbo_size + sizeof(float) * from * 4, sizeof(float) * count * 4, colors.ptr() + from * 4);
+	}
+
+	if (uvs_vbo_size > 0) {
+		glBufferSubData(GL_ARRAY_BUFFER, vertices_vbo_size + normals_vbo_size + colors_vbo_size + sizeof(float) * from * 2, sizeof(float) * count * 2, uvs.ptr() + from * 2);
 	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -266,6 +385,9 @@ void Mesh::destroy() {
 		glDeleteBuffers(1, &IBO);
 		IBO = 0;
 	}
+
+	_vbo_capacity = 0;
+	_ibo_capacity = 0;
 }
 void Mesh::render() {
 	if (!vertices_vbo_size) {
@@ -278,6 +400,11 @@ void Mesh::render() {
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
+	if (_uploaded_vertex_layout == VERTEX_LAYOUT_INTERLEAVED) {
+		_render_interleaved();
+		return;
+	}
+
 	glVertexAttribPointer(Shader::ATTRIBUTE_POSITION, vertex_dimesions, GL_FLOAT, GL_FALSE, 0, 0);
 	glEnableVertexAttribArray(Shader::ATTRIBUTE_POSITION);
 
@@ -326,10 +453,288 @@ int Mesh::get_vertex_count() const {
 	return vertices.size() / vertex_dimesions;
 }
 
+int Mesh::get_vertex_stride() const {
+	if (_vertex_layout == VERTEX_LAYOUT_INTERLEAVED) {
+		return _calculate_interleaved_layout().stride;
+	}
+
+	int stride = sizeof(float) * vertex_dimesions;
+
+	if (normals.size() > 0) {
+		stride += sizeof(float) * 3;
+	}
+
+	if (colors.size() > 0) {
+		stride += sizeof(float) * 4;
+	}
+
+	if (uvs.size() > 0) {
+		stride += sizeof(float) * 2;
+	}
+
+	return stride;
+}
+
+void Mesh::_upload_indices() {
+	indices_vbo_size = sizeof(uint32_t) * indices.size();
+
+	if (indices_vbo_size > 0) {
+		if (!IBO) {
+			glGenBuffers(1, &IBO);
+		}
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+		if (_buffer_usage == BUFFER_USAGE_STATIC) {
+			_ibo_capacity = indices_vbo_size;
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_vbo_size, indices.ptr(), GL_STATIC_DRAW);
+		} else {
+			_prepare_buffer(GL_ELEMENT_ARRAY_BUFFER, indices_vbo_size, _ibo_capacity);
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices_vbo_size, indices.ptr());
+		}
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+}
+
+void Mesh::_upload_interleaved() {
+	InterleavedLayout layout = _calculate_interleaved_layout();
+	int vertex_count = get_vertex_count();
+
+	_interleaved_data.resize(vertex_count * layout.stride);
+	_pack_interleaved(layout, 0, vertex_count, _interleaved_data.ptrw());
+
+	vertices_vbo_size = _interleaved_data.size();
+	normals_vbo_size = 0;
+	colors_vbo_size = 0;
+	uvs_vbo_size = 0;
+
+	if (_buffer_usage == BUFFER_USAGE_STATIC) {
+		_vbo_capacity = vertices_vbo_size;
+		glBufferData(GL_ARRAY_BUFFER, vertices_vbo_size, _interleaved_data.ptr(), GL_STATIC_DRAW);
+	} else {
+		_prepare_buffer(GL_ARRAY_BUFFER, vertices_vbo_size, _vbo_capacity);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_vbo_size, _interleaved_data.ptr());
+	}
+
+	_uploaded_vertex_layout = VERTEX_LAYOUT_INTERLEAVED;
+	_uploaded_interleaved_layout = layout;
+
+	_upload_indices();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Mesh::_render_interleaved() {
+	const InterleavedLayout &layout = _uploaded_interleaved_layout;
+
+	glVertexAttribPointer(Shader::ATTRIBUTE_POSITION, vertex_dimesions, GL_FLOAT, GL_FALSE, layout.stride, 0);
+	glEnableVertexAttribArray(Shader::ATTRIBUTE_POSITION);
+
+	if (layout.normal_offset != -1) {
+		if (layout.normal_format == NORMAL_FORMAT_SNORM16) {
+			glVertexAttribPointer(Shader::ATTRIBUTE_NORMAL, 3, GL_SHORT, GL_TRUE, layout.stride, (void *)(uintptr_t)(layout.normal_offset));
+		} else {
+			glVertexAttribPointer(Shader::ATTRIBUTE_NORMAL, 3, GL_FLOAT, GL_FALSE, layout.stride, (void *)(uintptr_t)(layout.normal_offset));
+		}
+
+		glEnableVertexAttribArray(Shader::ATTRIBUTE_NORMAL);
+	}
+
+	if (layout.color_offset != -1) {
+		if (layout.color_format == COLOR_FORMAT_RGBA8) {
+			glVertexAttribPointer(Shader::ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, layout.stride, (void *)(uintptr_t)(layout.color_offset));
+		} else {
+			glVertexAttribPointer(Shader::ATTRIBUTE_COLOR, 4, GL_FLOAT, GL_FALSE, layout.stride, (void *)(uintptr_t)(layout.color_offset));
+		}
+
+		glEnableVertexAttribArray(Shader::ATTRIBUTE_COLOR);
+	}
+
+	if (layout.uv_offset != -1) {
+		if (layout.uv_format == UV_FORMAT_UNORM16) {
+			glVertexAttribPointer(Shader::ATTRIBUTE_UV, 2, GL_UNSIGNED_SHORT, GL_TRUE, layout.stride, (void *)(uintptr_t)(layout.uv_offset));
+		} else if (layout.uv_format == UV_FORMAT_HALF_FLOAT) {
+			glVertexAttribPointer(Shader::ATTRIBUTE_UV, 2, GL_HALF_FLOAT, GL_FALSE, layout.stride, (void *)(uintptr_t)(layout.uv_offset));
+		} else {
+			glVertexAttribPointer(Shader::ATTRIBUTE_UV, 2, GL_FLOAT, GL_FALSE, layout.stride, (void *)(uintptr_t)(layout.uv_offset));
+		}
+
+		glEnableVertexAttribArray(Shader::ATTRIBUTE_UV);
+	}
+
+	if (indices_vbo_size > 0) {
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (GLvoid *)0);
+	} else {
+		glDrawArrays(GL_TRIANGLES, 0, get_vertex_count());
+	}
+
+	glDisableVertexAttribArray(Shader::ATTRIBUTE_POSITION);
+
+	if (layout.normal_offset != -1) {
+		glDisableVertexAttribArray(Shader::ATTRIBUTE_NORMAL);
+	}
+
+	if (layout.color_offset != -1) {
+		glDisableVertexAttribArray(Shader::ATTRIBUTE_COLOR);
+	}
+
+	if (layout.uv_offset != -1) {
+		glDisableVertexAttribArray(Shader::ATTRIBUTE_UV);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+Mesh::InterleavedLayout Mesh::_calculate_interleaved_layout() const {
+	InterleavedLayout layout;
+
+	int vertex_count = get_vertex_count();
+
+	layout.normal_format = _normal_format;
+	layout.color_format = _color_format;
+	layout.uv_format = _uv_format;
+
+	layout.stride = sizeof(float) * vertex_dimesions;
+
+	// Attributes that don't have data for every vertex are skipped
+	if (normals.size() > 0) {
+		if (normals.size() >= vertex_count * 3) {
+			layout.normal_offset = layout.stride;
+			layout.stride += _normal_format == NORMAL_FORMAT_SNORM16 ? sizeof(int16_t) * 4 : sizeof(float) * 3;
+		} else {
+			ERR_PRINT("Mesh: Not enough normals for an interleaved upload, skipping them!");
+		}
+	}
+
+	if (colors.size() > 0) {
+		if (colors.size() >= vertex_count * 4) {
+			layout.color_offset = layout.stride;
+			layout.stride += _color_format == COLOR_FORMAT_RGBA8 ? sizeof(uint8_t) * 4 : sizeof(float) * 4;
+		} else {
+			ERR_PRINT("Mesh: Not enough colors for an interleaved upload, skipping them!");
+		}
+	}
+
+	if (uvs.size() > 0) {
+		if (uvs.size() >= vertex_count * 2) {
+			layout.uv_offset = layout.stride;
+			layout.stride += _uv_format == UV_FORMAT_FLOAT ? sizeof(float) * 2 : sizeof(uint16_t) * 2;
+		} else {
+			ERR_PRINT("Mesh: Not enough uvs for an interleaved upload, skipping them!");
+		}
+	}
+
+	return layout;
+}
+
+void Mesh::_pack_interleaved(const InterleavedLayout &p_layout, const int p_from_vertex, const int p_to_vertex, uint8_t *r_data) const {
+	const float *vr = vertices.ptr();
+	const float *nr = normals.ptr();
+	const float *cr = colors.ptr();
+	const float *uvr = uvs.ptr();
+
+	const int vertex_size = sizeof(float) * vertex_dimesions;
+
+	for (int i = p_from_vertex; i < p_to_vertex; ++i) {
+		uint8_t *w = r_data + (i - p_from_vertex) * p_layout.stride;
+
+		memcpy(w, vr + i * vertex_dimesions, vertex_size);
+
+		if (p_layout.normal_offset != -1) {
+			const float *n = nr + i * 3;
+
+			if (p_layout.normal_format == NORMAL_FORMAT_SNORM16) {
+				int16_t nv[4];
+
+				for (int j = 0; j < 3; ++j) {
+					nv[j] = (int16_t)Math::fast_ftoi(CLAMP(n[j], -1, 1) * 32767.0f);
+				}
+
+				nv[3] = 0;
+
+				memcpy(w + p_layout.normal_offset, nv, sizeof(int16_t) * 4);
+			} else {
+				memcpy(w + p_layout.normal_offset, n, sizeof(float) * 3);
+			}
+		}
+
+		if (p_layout.color_offset != -1) {
+			const float *c = cr + i * 4;
+
+			if (p_layout.color_format == COLOR_FORMAT_RGBA8) {
+				uint8_t *cw = w + p_layout.color_offset;
+
+				for (int j = 0; j < 4; ++j) {
+					cw[j] = (uint8_t)Math::fast_ftoi(CLAMP(c[j], 0, 1) * 255.0f);
+				}
+			} else {
+				memcpy(w + p_layout.color_offset, c, sizeof(float) * 4);
+			}
+		}
+
+		if (p_layout.uv_offset != -1) {
+			const float *uv = uvr + i * 2;
+
+			if (p_layout.uv_format == UV_FORMAT_UNORM16) {
+				uint16_t uvv[2];
+				uvv[0] = (uint16_t)Math::fast_ftoi(CLAMP(uv[0], 0, 1) * 65535.0f);
+				uvv[1] = (uint16_t)Math::fast_ftoi(CLAMP(uv[1], 0, 1) * 65535.0f);
+
+				memcpy(w + p_layout.uv_offset, uvv, sizeof(uint16_t) * 2);
+			} else if (p_layout.uv_format == UV_FORMAT_HALF_FLOAT) {
+				uint16_t uvv[2];
+				uvv[0] = Math::make_half_float(uv[0]);
+				uvv[1] = Math::make_half_float(uv[1]);
+
+				memcpy(w + p_layout.uv_offset, uvv, sizeof(uint16_t) * 2);
+			} else {
+				memcpy(w + p_layout.uv_offset, uv, sizeof(float) * 2);
+			}
+		}
+	}
+}
+
+void Mesh::_prepare_buffer(const uint32_t p_target, const uint32_t p_size, uint32_t &r_capacity) {
+	GLenum usage = _buffer_usage == BUFFER_USAGE_STREAM ? GL_STREAM_DRAW : GL_DYNAMIC_DRAW;
+
+	if (p_size > r_capacity) {
+		// Grow geometrically, so meshes that get rebuilt often settle on a buffer size quickly
+		uint32_t capacity = MAX(r_capacity, 256);
+
+		while (capacity < p_size) {
+			capacity *= 2;
+		}
+
+		r_capacity = capacity;
+
+		glBufferData(p_target, r_capacity, NULL, usage);
+	} else if (_buffer_usage == BUFFER_USAGE_STREAM) {
+		// Orphan the old storage. The driver can give us a fresh block, instead of waiting
+		// for the draws that still use the old contents to finish.
+		glBufferData(p_target, r_capacity, NULL, usage);
+	}
+}
+
 Mesh::Mesh() {
 	VBO = 0;
 	IBO = 0;
 
+	_buffer_usage = BUFFER_USAGE_STATIC;
+
+	_vertex_layout = VERTEX_LAYOUT_PLANAR;
+	_normal_format = NORMAL_FORMAT_FLOAT;
+	_color_format = COLOR_FORMAT_FLOAT;
+	_uv_format = UV_FORMAT_FLOAT;
+
+	_uploaded_vertex_layout = VERTEX_LAYOUT_PLANAR;
+
+	_vbo_capacity = 0;
+	_ibo_capacity = 0;
+
 	vertex_dimesions = 3;
 
 	vertices_vbo_size = 0;
@@ -342,6 +747,18 @@ Mesh::Mesh(int vert_dim) {
 	VBO = 0;
 	IBO = 0;
 
+	_buffer_usage = BUFFER_USAGE_STATIC;
+
+	_vertex_layout = VERTEX_LAYOUT_PLANAR;
+	_normal_format = NORMAL_FORMAT_FLOAT;
+	_color_format = COLOR_FORMAT_FLOAT;
+	_uv_format = UV_FORMAT_FLOAT;
+
+	_uploaded_vertex_layout = VERTEX_LAYOUT_PLANAR;
+
+	_vbo_capacity = 0;
+	_ibo_capacity = 0;
+
 	vertex_dimesions = vert_dim;
 
 	vertices_vbo_size = 0;
@@ -18,6 +18,62 @@ class Mesh : public Resource {
 	SFW_OBJECT(Mesh, Resource);
 
 public:
+	enum BufferUsage {
+		// The buffer gets reallocated to the exact size on every upload. Best for meshes that rarely change.
+		BUFFER_USAGE_STATIC = 0,
+		// The buffer is kept around and grows geometrically, uploads only write the used range.
+		// Also allows partial updates using upload_range(). Best for meshes that change occasionally.
+		BUFFER_USAGE_DYNAMIC,
+		// Like dynamic, but the buffer's storage gets orphaned before every upload, so the driver
+		// doesn't need to wait for in flight draws. Best for meshes that get rebuilt every frame.
+		BUFFER_USAGE_STREAM,
+	};
+
+	BufferUsage get_buffer_usage() const;
+	void set_buffer_usage(const BufferUsage p_usage);
+
+	// How upload() lays out the data on the gpu.
+	// The arrays below always store floats, the formats are only used for the gpu side copy.
+	// Changes take effect on the next upload().
+	enum VertexLayout {
+		// Every attribute gets it's own block of floats.
+		VERTEX_LAYOUT_PLANAR = 0,
+		// The attributes of a vertex are stored next to each other, using the formats below.
+		VERTEX_LAYOUT_INTERLEAVED,
+	};
+
+	enum NormalFormat {
+		NORMAL_FORMAT_FLOAT = 0, // 12 bytes
+		NORMAL_FORMAT_SNORM16, // 8 bytes (padded)
+	};
+
+	enum ColorFormat {
+		COLOR_FORMAT_FLOAT = 0, // 16 bytes
+		COLOR_FORMAT_RGBA8, // 4 bytes, clamped to [0, 1]
+	};
+
+	enum UVFormat {
+		UV_FORMAT_FLOAT = 0, // 8 bytes
+		UV_FORMAT_HALF_FLOAT, // 4 bytes, lower precision
+		UV_FORMAT_UNORM16, // 4 bytes, clamped to [0, 1]
+	};
+
+	VertexLayout get_vertex_layout() const;
+	void set_vertex_layout(const VertexLayout p_layout);
+
+	NormalFormat get_normal_format() const;
+	void set_normal_format(const NormalFormat p_format);
+
+	ColorFormat get_color_format() const;
+	void set_color_format(const ColorFormat p_format);
+
+	UVFormat get_uv_format() const;
+	void set_uv_format(const UVFormat p_format);
+
+	// Interleaved, RGBA8 colors, UNORM16 uvs. A 2d vertex with color and uv takes 16 bytes this way.
+	// Only for meshes whose uvs and colors are known to be in [0, 1], everything else gets clamped.
+	void set_compact_vertex_format();
+
 	void add_vertex2(float x, float y);
 	void add_vertex2(const Vector2 &v);
 
@@ -47,10 +103,15 @@ public:
 	void clear();
 
 	void upload();
+	// Only re-uploads the vertex data of the vertices in [p_from_vertex, p_to_vertex).
+	// Only works with BUFFER_USAGE_DYNAMIC, and only if the vertex layout didn't change since the last upload(),
+	// otherwise it will just call upload().
+	void upload_range(const int p_from_vertex, const int p_to_vertex);
 	void destroy();
 	void render();
 
 	int get_vertex_count() const;
+	int get_vertex_stride() const;
 
 	Mesh();
 	Mesh(int vert_dim);
@@ -70,6 +131,57 @@ public:
 	AABB aabb;
 
 protected:
+	struct InterleavedLayout {
+		int stride;
+
+		// -1 if not present
+		int normal_offset;
+		int color_offset;
+		int uv_offset;
+
+		NormalFormat normal_format;
+		ColorFormat color_format;
+		UVFormat uv_format;
+
+		bool operator==(const InterleavedLayout &p_other) const {
+			return stride == p_other.stride && normal_offset == p_other.normal_offset && color_offset == p_other.color_offset && uv_offset == p_other.uv_offset &&
+					normal_format == p_other.normal_format && color_format == p_other.color_format && uv_format == p_other.uv_format;
+		}
+
+		InterleavedLayout() {
+			stride = 0;
+			normal_offset = -1;
+			color_offset = -1;
+			uv_offset = -1;
+			normal_format = NORMAL_FORMAT_FLOAT;
+			color_format = COLOR_FORMAT_FLOAT;
+			uv_format = UV_FORMAT_FLOAT;
+		}
+	};
+
+	void _upload_indices();
+	void _upload_interleaved();
+	void _render_interleaved();
+	InterleavedLayout _calculate_interleaved_layout() const;
+	void _pack_interleaved(const InterleavedLayout &p_layout, const int p_from_vertex, const int p_to_vertex, uint8_t *r_data) const;
+
+	void _prepare_buffer(const uint32_t p_target, const uint32_t p_size, uint32_t &r_capacity);
+
+	BufferUsage _buffer_usage;
+
+	VertexLayout _vertex_layout;
+	NormalFormat _normal_format;
+	ColorFormat _color_format;
+	UVFormat _uv_format;
+
+	// The layout that was used by the last upload()
+	VertexLayout _uploaded_vertex_layout;
+	InterleavedLayout _uploaded_interleaved_layout;
+	Vector<uint8_t> _interleaved_data;
+
+	uint32_t _vbo_capacity;
+	uint32_t _ibo_capacity;
+
 	uint32_t vertices_vbo_size;
 	uint32_t normals_vbo_size;
 	uint32_t colors_vbo_size;
@@ -14,6 +14,8 @@ Rect2i RenderState::render_rect;
 
 Ref<FrameBuffer> RenderState::current_framebuffer;
 
+RenderState::FlushCallback RenderState::flush_callback = NULL;
+
 void RenderState::apply_render_rect() {
 	glViewport(render_rect.position.x, render_rect.position.y, render_rect.size.x, render_rect.size.y);
 }
@@ -26,6 +28,12 @@ void RenderState::window_update_render_rect_size(const int p_width, const int p_
 	render_rect = Rect2i(0, 0, p_width, p_height);
 }
 
+void RenderState::flush(const bool p_frame_end) {
+	if (flush_callback) {
+		flush_callback(p_frame_end);
+	}
+}
+
 RenderState::RenderState() {
 }
 RenderState::~RenderState() {
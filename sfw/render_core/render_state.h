@@ -33,6 +33,14 @@ public:
 	
 	static void window_update_render_rect_size(const int p_width, const int p_height);
 
+	// Renderers that queue draws (like the batching 2D Renderer) can register a callback here.
+	// It gets called before the render target changes, and at the end of the frame.
+	typedef void (*FlushCallback)(const bool p_frame_end);
+
+	static FlushCallback flush_callback;
+
+	static void flush(const bool p_frame_end = false);
+
 	RenderState();
 	~RenderState();
 };
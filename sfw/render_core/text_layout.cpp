@@ -0,0 +1,226 @@
+//--STRIP
+#include "render_core/text_layout.h"
+
+#include "render_core/font.h"
+#include "render_core/mesh.h"
+//--STRIP
+
+String TextLayout::get_text() const {
+	return _text;
+}
+void TextLayout::set_text(const String &p_text) {
+	if (_text == p_text) {
+		return;
+	}
+
+	_text = p_text;
+	_text_changed = true;
+}
+
+Ref<Font> TextLayout::get_font() const {
+	return _font;
+}
+void TextLayout::set_font(const Ref<Font> &p_font) {
+	if (_font == p_font) {
+		return;
+	}
+
+	_font = p_font;
+	_font_changed = true;
+}
+
+bool TextLayout::update() {
+	if (!_font.is_valid()) {
+		if (_lines.empty()) {
+			return false;
+		}
+
+		_lines.clear();
+		_size = Vector2();
+		_glyph_count = 0;
+		++_version;
+
+		return true;
+	}
+
+	bool relayout_all = _font_changed || _font->get_scale() != _font_scale || _font->get_atlas_version() != _atlas_version;
+
+	if (!relayout_all && !_text_changed) {
+		if (_font->is_dynamic()) {
+			// Only lookups, but it marks the glyphs as used this frame, so they don't get evicted.
+			_font->cache_glyphs(_text);
+
+			if (_font->get_atlas_version() == _atlas_version) {
+				return false;
+			}
+
+			relayout_all = true;
+		} else {
+			return false;
+		}
+	}
+
+	// The uvs are only known after the glyphs are in the atlas, adding them can move the others.
+	_font->cache_glyphs(_text);
+
+	if (_font->get_atlas_version() != _atlas_version) {
+		relayout_all = true;
+	}
+
+	uint32_t line_count = 0;
+	StrSplitter lines(_text, '\n');
+
+	while (lines.next()) {
+		const StrRange &line_text = lines.get();
+
+		if (line_count == _lines.size()) {
+			_lines.push_back(Line());
+
+			Line &line = _lines[line_count];
+			line.text = line_text.as_string();
+			_layout_line(line);
+		} else {
+			Line &line = _lines[line_count];
+
+			if (relayout_all || StrRange(line.text) != line_text) {
+				line.text = line_text.as_string();
+				_layout_line(line);
+			}
+		}
+
+		++line_count;
+	}
+
+	_lines.resize(line_count);
+
+	Font::FontMetrics m = _font->font_metrics();
+
+	float width = 0;
+	_glyph_count = 0;
+
+	for (uint32_t i = 0; i < _lines.size(); ++i) {
+		width = MAX(width, _lines[i].width);
+		_glyph_count += _lines[i].glyphs.size();
+	}
+
+	// Same as Font::get_string_size()
+	float height = m.linedist * line_count - m.descent + m.linegap;
+	_size = Vector2(width, MAX(height, m.ascent)).abs();
+
+	_text_changed = false;
+	_font_changed = false;
+	_font_scale = _font->get_scale();
+	_atlas_version = _font->get_atlas_version();
+
+	++_version;
+
+	return true;
+}
+
+Vector2 TextLayout::get_size() {
+	update();
+	return _size;
+}
+
+int TextLayout::get_line_count() {
+	update();
+	return _lines.size();
+}
+
+int TextLayout::get_glyph_count() {
+	update();
+	return _glyph_count;
+}
+
+void TextLayout::add_to_mesh(Ref<Mesh> &p_into, const Color &p_color) {
+	ERR_FAIL_COND(!p_into.is_valid());
+
+	update();
+
+	if (_lines.empty()) {
+		return;
+	}
+
+	Font::FontMetrics m = _font->font_metrics();
+
+	int mesh_index_offset = p_into->get_vertex_count();
+
+	for (uint32_t i = 0; i < _lines.size(); ++i) {
+		const Line &line = _lines[i];
+		float Y = m.linedist * (i + 1);
+
+		for (uint32_t j = 0; j < line.glyphs.size(); ++j) {
+			const Glyph &g = line.glyphs[j];
+
+			p_into->add_uv(g.u0, g.v0);
+			p_into->add_color(p_color);
+			p_into->add_vertex2(g.x0, Y + g.y0);
+
+			p_into->add_uv(g.u1, g.v1);
+			p_into->add_color(p_color);
+			p_into->add_vertex2(g.x1, Y + g.y1);
+
+			p_into->add_uv(g.u0, g.v1);
+			p_into->add_color(p_color);
+			p_into->add_vertex2(g.x0, Y + g.y1);
+
+			p_into->add_uv(g.u1, g.v0);
+			p_into->add_color(p_color);
+			p_into->add_vertex2(g.x1, Y + g.y0);
+
+			p_into->add_triangle(mesh_index_offset + 1, mesh_index_offset + 0, mesh_index_offset + 2);
+			p_into->add_triangle(mesh_index_offset + 0, mesh_index_offset + 1, mesh_index_offset + 3);
+
+			mesh_index_offset += 4;
+		}
+	}
+}
+
+TextLayout::TextLayout() {
+	_glyph_count = 0;
+
+	_text_changed = true;
+	_font_changed = true;
+	_font_scale = 1;
+	_atlas_version = 0;
+
+	_version = 0;
+}
+
+TextLayout::~TextLayout() {
+}
+
+void TextLayout::_layout_line(Line &r_line) {
+	r_line.glyphs.clear();
+
+	float scale = _font->get_scale();
+	float X = 0;
+
+	const CharType *text = r_line.text.ptr();
+
+	for (int i = 0, end = r_line.text.length(); i < end; ++i) {
+		const Font::TextureOffset *t = _font->_get_texture_offset(text[i]);
+
+		if (!t) {
+			continue;
+		}
+
+		Glyph g;
+
+		g.x0 = X + t->xoff * scale;
+		g.y0 = t->yoff * scale;
+		g.x1 = X + t->xoff2 * scale;
+		g.y1 = t->yoff2 * scale;
+
+		g.u0 = t->x0;
+		g.v0 = t->y0;
+		g.u1 = t->x1;
+		g.v1 = t->y1;
+
+		r_line.glyphs.push_back(g);
+
+		X += t->xadvance * scale;
+	}
+
+	r_line.width = X;
+}
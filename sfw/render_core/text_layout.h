@@ -0,0 +1,98 @@
+//--STRIP
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+//--STRIP
+
+//--STRIP
+#include "core/color.h"
+#include "core/local_vector.h"
+#include "core/ustring.h"
+#include "core/vector2.h"
+
+#include "object/reference.h"
+//--STRIP
+
+class Font;
+class Mesh;
+
+// Glyph positions of a text, computed once and kept until the text, the font, the font's scale or its atlas changes.
+//
+// Every line is a run of its own, when the text changes only the lines that are different get laid out again.
+// add_to_mesh() emits the same quads as Font::generate_mesh(), without looking at the font.
+//
+// Ref<TextLayout> label;
+// label.instance();
+// label->set_font(font);
+// label->set_text("Score: 0");
+// ...
+// Renderer::get_singleton()->draw_text_layout_2d(label, Vector2(10, 10));
+
+class TextLayout : public Reference {
+	SFW_OBJECT(TextLayout, Reference);
+
+public:
+	String get_text() const;
+	void set_text(const String &p_text);
+
+	Ref<Font> get_font() const;
+	void set_font(const Ref<Font> &p_font);
+
+	// Lays out what changed. Returns true if the glyphs changed, meshes made from them have to be rebuilt.
+	// Dynamic fonts need this to be called every frame the text is drawn, to keep its glyphs in their atlas.
+	bool update();
+
+	// These call update().
+	Vector2 get_size();
+	int get_line_count();
+	int get_glyph_count();
+
+	// Appends the quads to p_into.
+	void add_to_mesh(Ref<Mesh> &p_into, const Color &p_color = Color(1, 1, 1, 1));
+
+	// Incremented every time update() changes the glyphs.
+	_FORCE_INLINE_ uint32_t get_version() const { return _version; }
+
+	TextLayout();
+	~TextLayout();
+
+protected:
+	struct Glyph {
+		// Relative to the line's start on the baseline
+		float x0;
+		float y0;
+		float x1;
+		float y1;
+
+		float u0;
+		float v0;
+		float u1;
+		float v1;
+	};
+
+	struct Line {
+		String text;
+		LocalVector<Glyph> glyphs;
+		float width;
+	};
+
+	void _layout_line(Line &r_line);
+
+	Ref<Font> _font;
+	String _text;
+
+	LocalVector<Line> _lines;
+	Vector2 _size;
+	int _glyph_count;
+
+	// What the current layout was made with
+	bool _text_changed;
+	bool _font_changed;
+	float _font_scale;
+	uint32_t _atlas_version;
+
+	uint32_t _version;
+};
+
+//--STRIP
+#endif
+//--STRIP
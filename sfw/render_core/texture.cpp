@@ -3,6 +3,7 @@
 
 #include "core/memory.h"
 #include <stdio.h>
+#include <string.h>
 
 #include "render_core/app_window.h"
 
@@ -78,6 +79,13 @@ Vector2i Texture::get_size() const {
 	return Vector2i(_texture_width, _texture_height);
 }
 
+int Texture::get_flags() const {
+	return _flags;
+}
+void Texture::set_flags(const int p_flags) {
+	_flags = p_flags;
+}
+
 void Texture::upload() {
 	if (!_image.is_valid()) {
 		return;
@@ -94,9 +102,9 @@ void Texture::upload() {
 		return;
 	}
 
-	_data_size = _image->get_data().size();
-	_texture_format = image_format;
 	Vector<uint8_t> image_data = _image->get_data();
+	_data_size = image_data.size();
+	_texture_format = image_format;
 
 	if (image_data.size() == 0) {
 		return;
@@ -117,7 +125,177 @@ void Texture::upload() {
 
 	int mipmaps = ((_flags & TEXTURE_FLAG_MIP_MAPS) && _image->has_mipmaps()) ? _image->get_mipmap_count() + 1 : 1;
 
+	_setup_parameters(mipmaps);
+
+	_texture_width = _image->get_width();
+	_texture_height = _image->get_height();
+
+	int w = _texture_width;
+	int h = _texture_height;
+
+	int tsize = 0;
+
+	for (int i = 0; i < mipmaps; i++) {
+		int size;
+		int ofs;
+		_image->get_mipmap_offset_and_size(i, ofs, size);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(texture_type, i, gl_internal_format, w, h, 0, gl_format, gl_type, &read[ofs]);
+
+		tsize += size;
+
+		w = MAX(1, w >> 1);
+		h = MAX(1, h >> 1);
+	}
+
 	if (mipmaps > 1) {
+		//generate mipmaps if they were requested and the image does not contain them
+		glGenerateMipmap(texture_type);
+	}
+
+	_mipmaps = mipmaps;
+	_streaming = false;
+
+	glBindTexture(texture_type, 0);
+}
+
+void Texture::update_region(const Rect2i &p_rect) {
+	ERR_FAIL_COND(!_texture);
+	ERR_FAIL_COND(!_image.is_valid());
+	ERR_FAIL_COND_MSG(_image->get_width() != _texture_width || _image->get_height() != _texture_height || _image->get_format() != _texture_format, "The image changed size or format, call upload() instead.");
+
+	Rect2i rect = p_rect.intersection(Rect2i(0, 0, _texture_width, _texture_height));
+
+	if (rect.size.x <= 0 || rect.size.y <= 0) {
+		return;
+	}
+
+	uint32_t gl_format;
+	uint32_t gl_internal_format;
+	uint32_t gl_type;
+	bool supported;
+	_get_gl_format(_texture_format, gl_format, gl_internal_format, gl_type, supported);
+
+	if (!supported) {
+		return;
+	}
+
+	Vector<uint8_t> image_data = _image->get_data();
+	const uint8_t *read = image_data.ptr();
+	ERR_FAIL_COND(!read);
+
+	uint32_t texture_type = GL_TEXTURE_2D;
+
+	glActiveTexture(GL_TEXTURE0 + _texture_index);
+	glBindTexture(texture_type, _texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if (_has_unpack_subimage()) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// The rows are read straight out of the full image.
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, _texture_width);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect.position.x);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS, rect.position.y);
+
+		glTexSubImage2D(texture_type, 0, rect.position.x, rect.position.y, rect.size.x, rect.size.y, gl_format, gl_type, read);
+
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+	} else {
+		// GLES 2 / WebGL 1 can't skip into the image, the whole rows are uploaded instead.
+		int row_size = _texture_width * Image::get_format_pixel_size(_texture_format);
+
+		glTexSubImage2D(texture_type, 0, 0, rect.position.y, _texture_width, rect.size.y, gl_format, gl_type, read + rect.position.y * row_size);
+	}
+
+	if (_mipmaps > 1) {
+		glGenerateMipmap(texture_type);
+	}
+
+	glBindTexture(texture_type, 0);
+}
+
+bool Texture::_has_unpack_subimage() {
+#ifdef __EMSCRIPTEN__
+	return false;
+#else
+	static int supported = -1;
+
+	if (supported == -1) {
+		// Desktop GL always has GL_UNPACK_ROW_LENGTH, GLES only from 3.0.
+		const char *version = (const char *)glGetString(GL_VERSION);
+
+		if (version && strncmp(version, "OpenGL ES", 9) == 0) {
+			supported = version[9] == ' ' && version[10] >= '3';
+		} else {
+			supported = 1;
+		}
+	}
+
+	return supported;
+#endif
+}
+
+bool Texture::_allocate_storage(const Ref<Image> &p_image) {
+	ERR_FAIL_COND_V(!p_image.is_valid(), false);
+
+	uint32_t gl_format;
+	uint32_t gl_internal_format;
+	uint32_t gl_type;
+	bool supported;
+	Image::Format image_format = p_image->get_format();
+	_get_gl_format(image_format, gl_format, gl_internal_format, gl_type, supported);
+
+	if (!supported || p_image->empty()) {
+		return false;
+	}
+
+	_image = p_image;
+	_data_size = p_image->get_data_size();
+	_texture_format = image_format;
+	_texture_width = p_image->get_width();
+	_texture_height = p_image->get_height();
+
+	if (!_texture) {
+		glGenTextures(1, &_texture);
+	}
+
+	glActiveTexture(GL_TEXTURE0 + _texture_index);
+
+	uint32_t texture_type = GL_TEXTURE_2D;
+
+	glBindTexture(texture_type, _texture);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	int mipmaps = ((_flags & TEXTURE_FLAG_MIP_MAPS) && p_image->has_mipmaps()) ? p_image->get_mipmap_count() + 1 : 1;
+
+	_setup_parameters(mipmaps);
+
+	int w = _texture_width;
+	int h = _texture_height;
+
+	for (int i = 0; i < mipmaps; i++) {
+		glTexImage2D(texture_type, i, gl_internal_format, w, h, 0, gl_format, gl_type, NULL);
+
+		w = MAX(1, w >> 1);
+		h = MAX(1, h >> 1);
+	}
+
+	_mipmaps = mipmaps;
+	_streaming = true;
+
+	glBindTexture(texture_type, 0);
+
+	return true;
+}
+
+void Texture::_setup_parameters(int p_mipmaps) {
+	uint32_t texture_type = GL_TEXTURE_2D;
+
+	if (p_mipmaps > 1) {
 		if ((_flags & TEXTURE_FLAG_FILTER)) {
 			glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		} else {
@@ -149,37 +327,6 @@ void Texture::upload() {
 		glTexParameterf(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameterf(texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	}
-
-	_texture_width = _image->get_width();
-	_texture_height = _image->get_height();
-
-	int w = _texture_width;
-	int h = _texture_height;
-
-	int tsize = 0;
-
-	for (int i = 0; i < mipmaps; i++) {
-		int size;
-		int ofs;
-		_image->get_mipmap_offset_and_size(i, ofs, size);
-
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-		glTexImage2D(texture_type, i, gl_internal_format, w, h, 0, gl_format, gl_type, &read[ofs]);
-
-		tsize += size;
-
-		w = MAX(1, w >> 1);
-		h = MAX(1, h >> 1);
-	}
-
-	if (mipmaps > 1) {
-		//generate mipmaps if they were requested and the image does not contain them
-		glGenerateMipmap(texture_type);
-	}
-
-	_mipmaps = mipmaps;
-
-	glBindTexture(texture_type, 0);
 }
 
 void Texture::_get_gl_format(Image::Format p_format, uint32_t &r_gl_format, uint32_t &r_gl_internal_format, uint32_t &r_gl_type, bool &r_supported) const {
@@ -266,6 +413,7 @@ Texture::Texture() {
 	_data_size = 0;
 	_texture_index = 0;
 	_flags = 0;
+	_streaming = false;
 
 	_texture_format = Image::FORMAT_RGBA8;
 }
@@ -4,6 +4,7 @@
 //--STRIP
 
 //--STRIP
+#include "core/rect2i.h"
 #include "core/vector2i.h"
 
 #include "object/resource.h"
@@ -33,12 +34,33 @@ public:
 
 	Vector2i get_size() const;
 
+	// TextureFlags. Applied on the next upload().
+	int get_flags() const;
+	void set_flags(const int p_flags);
+
 	void upload();
 
+	// Re-uploads only p_rect of the image's first level, after its pixels were changed.
+	// Mipmaps (if any) are regenerated.
+	void update_region(const Rect2i &p_rect);
+
+	// False while TextureStreamer is still uploading the texture's pixels.
+	_FORCE_INLINE_ bool is_ready() const {
+		return !_streaming;
+	}
+
 	Texture();
 	virtual ~Texture();
 
 protected:
+	friend class TextureStreamer;
+
+	// Creates the GL texture with storage for every level of p_image, but without uploading the pixels.
+	bool _allocate_storage(const Ref<Image> &p_image);
+	void _setup_parameters(int p_mipmaps);
+	// Whether the context has GL_UNPACK_ROW_LENGTH and GL_UNPACK_SKIP_*.
+	static bool _has_unpack_subimage();
+
 	void _get_gl_format(Image::Format p_format, uint32_t &r_gl_format, uint32_t &r_gl_internal_format, uint32_t &r_gl_type, bool &r_supported) const;
 
 	Ref<Image> _image;
@@ -53,6 +75,7 @@ protected:
 	int _mipmaps;
 
 	uint32_t _texture;
+	bool _streaming;
 };
 
 class RenderTexture : public Texture {
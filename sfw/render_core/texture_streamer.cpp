@@ -0,0 +1,298 @@
+//--STRIP
+#include "render_core/texture_streamer.h"
+
+#include "core/error_macros.h"
+#include "core/memory.h"
+
+#include "render_core/3rd_glad.h"
+
+#include <string.h>
+//--STRIP
+
+TextureStreamer *TextureStreamer::_singleton = NULL;
+
+Ref<Texture> TextureStreamer::load(const String &p_path) {
+	Ref<Texture> texture;
+	texture.instance();
+	texture->_streaming = true;
+
+	Job *job = memnew(Job);
+	job->texture = texture;
+	job->path = p_path;
+	job->started = false;
+	job->mipmap = 0;
+	job->row = 0;
+
+	// Only the decoding happens on the worker, the Image itself is created here.
+	job->image.instance();
+
+	_jobs.push_back(job);
+
+	WorkerPool::get_singleton()->add_task(_decode_task, job, &_decode_group);
+
+	return texture;
+}
+
+void TextureStreamer::load_image(const Ref<Texture> &p_texture, const Ref<Image> &p_image) {
+	ERR_FAIL_COND(!p_texture.is_valid());
+	ERR_FAIL_COND(!p_image.is_valid());
+
+	Job *job = memnew(Job);
+	job->texture = p_texture;
+	job->texture->_streaming = true;
+	job->image = p_image;
+	job->decoded.set();
+	job->started = false;
+	job->mipmap = 0;
+	job->row = 0;
+
+	_jobs.push_back(job);
+}
+
+bool TextureStreamer::update() {
+	return _update(_upload_budget, false);
+}
+
+void TextureStreamer::flush() {
+	_decode_group.wait();
+
+	_update(INT32_MAX, true);
+}
+
+int TextureStreamer::get_upload_budget() const {
+	return _upload_budget;
+}
+void TextureStreamer::set_upload_budget(const int p_bytes) {
+	_upload_budget = MAX(p_bytes, 1);
+}
+
+TextureStreamer *TextureStreamer::get_singleton() {
+	if (!_singleton) {
+		_singleton = memnew(TextureStreamer);
+	}
+
+	return _singleton;
+}
+
+void TextureStreamer::cleanup() {
+	if (_singleton) {
+		memdelete(_singleton);
+		_singleton = NULL;
+	}
+}
+
+TextureStreamer::TextureStreamer() {
+	for (int i = 0; i < BUFFER_COUNT; ++i) {
+		_buffers[i].buffer = 0;
+		_buffers[i].size = 0;
+		_buffers[i].fence = NULL;
+	}
+
+	_current_buffer = 0;
+	_upload_budget = DEFAULT_UPLOAD_BUDGET;
+
+	// GL 2.1 and GLES 2 contexts don't have fences or buffer mapping.
+#ifdef __EMSCRIPTEN__
+	_use_buffers = false;
+#else
+	_use_buffers = GLAD_GL_VERSION_3_0 || (GLAD_GL_ARB_sync && GLAD_GL_ARB_map_buffer_range);
+#endif
+}
+
+TextureStreamer::~TextureStreamer() {
+	// The jobs can't be freed while a worker is still decoding into them.
+	_decode_group.wait();
+
+	for (int i = 0; i < _jobs.size(); ++i) {
+		Job *job = _jobs[i];
+
+		if (job->texture.is_valid()) {
+			job->texture->_streaming = false;
+		}
+
+		memdelete(job);
+	}
+
+	_jobs.clear();
+
+	for (int i = 0; i < BUFFER_COUNT; ++i) {
+		Buffer &b = _buffers[i];
+
+		if (b.fence) {
+			glDeleteSync((GLsync)b.fence);
+		}
+
+		if (b.buffer) {
+			glDeleteBuffers(1, &b.buffer);
+		}
+	}
+}
+
+void TextureStreamer::_decode_task(void *p_userdata) {
+	Job *job = (Job *)p_userdata;
+
+	job->image->load_from_file(job->path);
+
+	// Nothing may touch the job after this.
+	job->decoded.set();
+}
+
+bool TextureStreamer::_update(int p_budget, bool p_wait) {
+	int budget = p_budget;
+	int i = 0;
+
+	glActiveTexture(GL_TEXTURE0);
+
+	while (i < _jobs.size() && budget > 0) {
+		Job *job = _jobs[i];
+
+		if (!job->decoded.is_set()) {
+			// Later ones might be ready already.
+			++i;
+			continue;
+		}
+
+		if (!job->started && !_start_job(job)) {
+			_jobs.remove(i);
+			memdelete(job);
+			continue;
+		}
+
+		int uploaded = _upload_piece(job, MIN(budget, _upload_budget), p_wait);
+
+		if (uploaded < 0) {
+			// Every buffer is still in use by the GPU.
+			break;
+		}
+
+		budget -= uploaded;
+
+		if (job->mipmap == job->texture->_mipmaps) {
+			job->texture->_streaming = false;
+
+			_jobs.remove(i);
+			memdelete(job);
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return !_jobs.empty();
+}
+
+bool TextureStreamer::_start_job(Job *p_job) {
+	p_job->started = true;
+
+	Texture *texture = p_job->texture.ptr();
+
+	if (!texture->_allocate_storage(p_job->image)) {
+		texture->_streaming = false;
+
+		if (p_job->path.empty()) {
+			ERR_PRINT("Couldn't stream image!");
+		} else {
+			ERR_PRINT("Couldn't stream texture! " + p_job->path);
+		}
+
+		return false;
+	}
+
+	p_job->data = p_job->image->get_data();
+
+	return true;
+}
+
+int TextureStreamer::_upload_piece(Job *p_job, int p_budget, bool p_wait) {
+	Texture *texture = p_job->texture.ptr();
+
+	uint32_t gl_format;
+	uint32_t gl_internal_format;
+	uint32_t gl_type;
+	bool supported;
+	texture->_get_gl_format(texture->_texture_format, gl_format, gl_internal_format, gl_type, supported);
+
+	int ofs;
+	int size;
+	p_job->image->get_mipmap_offset_and_size(p_job->mipmap, ofs, size);
+
+	int w = MAX(1, texture->_texture_width >> p_job->mipmap);
+	int h = MAX(1, texture->_texture_height >> p_job->mipmap);
+	int row_size = w * Image::get_format_pixel_size(texture->_texture_format);
+
+	// At least one row, even if it's bigger than the budget.
+	int rows = CLAMP(p_budget / row_size, 1, h - p_job->row);
+	int bytes = rows * row_size;
+
+	const uint8_t *src = p_job->data.ptr() + ofs + p_job->row * row_size;
+
+	glBindTexture(GL_TEXTURE_2D, texture->_texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if (_use_buffers) {
+		if (!_upload_rows_buffered(p_job->mipmap, p_job->row, w, rows, gl_format, gl_type, src, bytes, p_wait)) {
+			return -1;
+		}
+	} else {
+		// No buffer mapping or fences (WebGL, GL 2.1 without the extensions), the rows are uploaded straight from memory.
+		glTexSubImage2D(GL_TEXTURE_2D, p_job->mipmap, 0, p_job->row, w, rows, gl_format, gl_type, src);
+	}
+
+	p_job->row += rows;
+
+	if (p_job->row == h) {
+		p_job->row = 0;
+		p_job->mipmap += 1;
+	}
+
+	return bytes;
+}
+
+bool TextureStreamer::_upload_rows_buffered(int p_mipmap, int p_row, int p_width, int p_rows, uint32_t p_format, uint32_t p_type, const uint8_t *p_src, int p_bytes, bool p_wait) {
+#ifndef __EMSCRIPTEN__
+	Buffer &b = _buffers[_current_buffer];
+
+	if (b.fence) {
+		GLenum res = glClientWaitSync((GLsync)b.fence, p_wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, p_wait ? GL_TIMEOUT_IGNORED : 0);
+
+		if (res == GL_TIMEOUT_EXPIRED) {
+			return false;
+		}
+
+		glDeleteSync((GLsync)b.fence);
+		b.fence = NULL;
+	}
+
+	if (!b.buffer) {
+		glGenBuffers(1, &b.buffer);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, b.buffer);
+
+	if (b.size < (size_t)p_bytes) {
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, p_bytes, NULL, GL_STREAM_DRAW);
+		b.size = p_bytes;
+	}
+
+	// The fence made sure the GPU is done with the previous contents, no need for the driver to sync.
+	void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, p_bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+	if (dst) {
+		memcpy(dst, p_src, p_bytes);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		glTexSubImage2D(GL_TEXTURE_2D, p_mipmap, 0, p_row, p_width, p_rows, p_format, p_type, NULL);
+
+		b.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	} else {
+		// Mapping failed, upload from memory instead.
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexSubImage2D(GL_TEXTURE_2D, p_mipmap, 0, p_row, p_width, p_rows, p_format, p_type, p_src);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	_current_buffer = (_current_buffer + 1) % BUFFER_COUNT;
+#endif
+
+	return true;
+}
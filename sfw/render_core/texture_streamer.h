@@ -0,0 +1,102 @@
+//--STRIP
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+//--STRIP
+
+//--STRIP
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+#include "core/worker_pool.h"
+
+#include "render_core/image.h"
+#include "render_core/texture.h"
+//--STRIP
+
+// Loads textures without stalling the frame.
+//
+// Files are decoded on WorkerPool threads. The decoded pixels are then uploaded from update() a few rows at a time,
+// at most get_upload_budget() bytes per frame, through a small ring of pixel unpack buffers. A buffer is only
+// reused once the GPU is done with it (fence), so neither the copy nor the upload has to wait for the driver.
+// Without GL 3.0 (or ARB_sync and ARB_map_buffer_range) the rows are uploaded straight from memory instead.
+//
+// The returned textures can be used right away, Texture::is_ready() tells whether all of their pixels are there.
+// Textures are finished in the order they were queued.
+//
+// Application calls update() every frame. Everything has to be called from the thread that owns the GL context.
+
+class TextureStreamer {
+public:
+	enum {
+		DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024,
+		BUFFER_COUNT = 3,
+	};
+
+	// Decodes p_path on a worker thread.
+	Ref<Texture> load(const String &p_path);
+	// Streams an already decoded image into p_texture.
+	void load_image(const Ref<Texture> &p_texture, const Ref<Image> &p_image);
+
+	// Uploads the next pieces. Returns true if there is still work left.
+	bool update();
+	// Finishes every queued texture right now.
+	void flush();
+
+	_FORCE_INLINE_ int get_pending_count() const { return _jobs.size(); }
+
+	int get_upload_budget() const;
+	void set_upload_budget(const int p_bytes);
+
+	// Lazily created.
+	static TextureStreamer *get_singleton();
+	_FORCE_INLINE_ static bool has_singleton() { return _singleton != NULL; }
+	static void cleanup();
+
+	TextureStreamer();
+	~TextureStreamer();
+
+protected:
+	struct Job {
+		Ref<Texture> texture;
+		Ref<Image> image;
+		String path;
+		SafeFlag decoded;
+
+		bool started;
+		Vector<uint8_t> data;
+		int mipmap;
+		int row;
+	};
+
+	struct Buffer {
+		uint32_t buffer;
+		size_t size;
+		// GLsync
+		void *fence;
+	};
+
+	static void _decode_task(void *p_userdata);
+
+	bool _update(int p_budget, bool p_wait);
+	bool _start_job(Job *p_job);
+	// Returns the number of bytes uploaded, -1 if no buffer is free yet (unless p_wait).
+	int _upload_piece(Job *p_job, int p_budget, bool p_wait);
+	// Returns false if no buffer is free yet (unless p_wait).
+	bool _upload_rows_buffered(int p_mipmap, int p_row, int p_width, int p_rows, uint32_t p_format, uint32_t p_type, const uint8_t *p_src, int p_bytes, bool p_wait);
+
+	Vector<Job *> _jobs;
+	WorkerPool::TaskGroup _decode_group;
+
+	// Whether the context supports the buffer ring, otherwise rows are uploaded from memory.
+	bool _use_buffers;
+	Buffer _buffers[BUFFER_COUNT];
+	int _current_buffer;
+
+	int _upload_budget;
+
+	static TextureStreamer *_singleton;
+};
+
+//--STRIP
+#endif
+//--STRIP
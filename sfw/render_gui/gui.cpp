@@ -7,6 +7,7 @@
 #include "gui.h"
 
 #include "render_core/app_window.h"
+#include "render_core/render_state.h"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -125,6 +126,9 @@ void GUI::new_frame() {
 }
 
 void GUI::render() {
+	// Submit everything that got queued before the gui
+	RenderState::flush();
+
 	// Rendering
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
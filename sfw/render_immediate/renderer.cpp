@@ -10,6 +10,7 @@
 #include "render_core/font_material.h"
 #include "render_core/material.h"
 #include "render_core/mesh.h"
+#include "render_core/text_layout.h"
 #include "render_core/texture.h"
 #include "render_core/texture_material.h"
 
@@ -20,6 +21,8 @@ bool Renderer::get_depth_buffer_enable() const {
 	return _depth_buffer;
 }
 void Renderer::set_depth_buffer_enable(const bool p_depth_buffer) {
+	flush_2d_batch();
+
 	_depth_buffer = p_depth_buffer;
 }
 
@@ -31,6 +34,8 @@ void Renderer::set_face_culling(const FaceCulling p_face_culling) {
 		return;
 	}
 
+	flush_2d_batch();
+
 	bool were_disabled = _face_culling == FACE_CULLING_OFF;
 
 	_face_culling = p_face_culling;
@@ -71,35 +76,19 @@ void Renderer::draw_point(const Vector2 &p_position, const Color &p_color) {
 	draw_rect(Rect2(p_position, Vector2(1, 1)), p_color);
 }
 void Renderer::draw_line(const Vector2 &p_from, const Vector2 &p_to, const Color &p_color, const real_t p_width) {
-	_2d_mesh->clear();
+	_2d_batch_begin(BATCH_2D_MATERIAL_COLOR);
 
 	Vector2 offset = (p_from - p_to).rotated(Math_PI / 2.0).normalized();
 	offset *= p_width / 2.0;
 
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_from.x - offset.x, p_from.y - offset.y);
-
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_to.x + offset.x, p_to.y + offset.y);
-
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_to.x - offset.x, p_to.y - offset.y);
-
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_from.x + offset.x, p_from.y + offset.y);
-
-	//mesh->add_vertex2(-w2, -h2);
-	//mesh->add_vertex2(w2, h2);
-	//mesh->add_vertex2(-w2, h2);
-	//mesh->add_vertex2(w2, -h2);
+	_2d_batch_add_quad(
+			Vector2(p_from.x - offset.x, p_from.y - offset.y),
+			Vector2(p_to.x + offset.x, p_to.y + offset.y),
+			Vector2(p_to.x - offset.x, p_to.y - offset.y),
+			Vector2(p_from.x + offset.x, p_from.y + offset.y),
+			p_color);
 
-	_2d_mesh->add_triangle(1, 0, 2);
-	_2d_mesh->add_triangle(0, 1, 3);
-
-	_2d_mesh->upload();
-
-	_color_material_2d->bind();
-	_2d_mesh->render();
+	_2d_batch_end();
 }
 void Renderer::draw_line_rect(const Rect2 &p_rect, const Color &p_color, const real_t p_width) {
 	Vector2 rect_end = p_rect.get_end();
@@ -111,63 +100,37 @@ void Renderer::draw_line_rect(const Rect2 &p_rect, const Color &p_color, const r
 	draw_line(rect_end, Vector2(p_rect.position.x, rect_end.y), p_color, p_width);
 }
 void Renderer::draw_rect(const Rect2 &p_rect, const Color &p_color) {
-	_2d_mesh->clear();
+	_2d_batch_begin(BATCH_2D_MATERIAL_COLOR);
 
 	Vector2 rect_end = p_rect.get_end();
 
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_rect.position.x, p_rect.position.y);
+	_2d_batch_add_quad(
+			p_rect.position,
+			rect_end,
+			Vector2(p_rect.position.x, rect_end.y),
+			Vector2(rect_end.x, p_rect.position.y),
+			p_color);
 
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(rect_end.x, rect_end.y);
-
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(p_rect.position.x, rect_end.y);
-
-	_2d_mesh->add_color(p_color);
-	_2d_mesh->add_vertex2(rect_end.x, p_rect.position.y);
-
-	_2d_mesh->add_triangle(1, 0, 2);
-	_2d_mesh->add_triangle(0, 1, 3);
-
-	_2d_mesh->upload();
-
-	_color_material_2d->bind();
-	_2d_mesh->render();
+	_2d_batch_end();
 }
 
 void Renderer::draw_texture(const Ref<Texture> &p_texture, const Rect2 &p_dst_rect, const Color &p_modulate) {
-	_2d_mesh->clear();
+	_2d_batch_begin(BATCH_2D_MATERIAL_TEXTURE, p_texture);
 
 	Vector2 rect_end = p_dst_rect.get_end();
 
-	_2d_mesh->add_uv(0, 0);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(p_dst_rect.position.x, p_dst_rect.position.y);
+	_2d_batch_add_quad_uv(
+			p_dst_rect.position,
+			rect_end,
+			Vector2(p_dst_rect.position.x, rect_end.y),
+			Vector2(rect_end.x, p_dst_rect.position.y),
+			Vector2(0, 0), Vector2(1, 1),
+			p_modulate);
 
-	_2d_mesh->add_uv(1, 1);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(rect_end.x, rect_end.y);
-
-	_2d_mesh->add_uv(0, 1);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(p_dst_rect.position.x, rect_end.y);
-
-	_2d_mesh->add_uv(1, 0);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(rect_end.x, p_dst_rect.position.y);
-
-	_2d_mesh->add_triangle(1, 0, 2);
-	_2d_mesh->add_triangle(0, 1, 3);
-
-	_2d_mesh->upload();
-
-	_texture_material_2d->texture = p_texture;
-	_texture_material_2d->bind();
-	_2d_mesh->render();
+	_2d_batch_end();
 }
 void Renderer::draw_texture_clipped(const Ref<Texture> &p_texture, const Rect2 &p_src_rect, const Rect2 &p_dst_rect, const Color &p_modulate) {
-	_2d_mesh->clear();
+	_2d_batch_begin(BATCH_2D_MATERIAL_TEXTURE, p_texture);
 
 	Rect2 uv = Rect2(0, 0, 1, 1);
 
@@ -185,30 +148,15 @@ void Renderer::draw_texture_clipped(const Ref<Texture> &p_texture, const Rect2 &
 
 	Vector2 rect_end = p_dst_rect.get_end();
 
-	_2d_mesh->add_uv(uv.position.x, uv.position.y);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(p_dst_rect.position.x, p_dst_rect.position.y);
+	_2d_batch_add_quad_uv(
+			p_dst_rect.position,
+			rect_end,
+			Vector2(p_dst_rect.position.x, rect_end.y),
+			Vector2(rect_end.x, p_dst_rect.position.y),
+			uv.position, uv.size,
+			p_modulate);
 
-	_2d_mesh->add_uv(uv.size.x, uv.size.y);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(rect_end.x, rect_end.y);
-
-	_2d_mesh->add_uv(uv.position.x, uv.size.y);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(p_dst_rect.position.x, rect_end.y);
-
-	_2d_mesh->add_uv(uv.size.x, uv.position.y);
-	_2d_mesh->add_color(p_modulate);
-	_2d_mesh->add_vertex2(rect_end.x, p_dst_rect.position.y);
-
-	_2d_mesh->add_triangle(1, 0, 2);
-	_2d_mesh->add_triangle(0, 1, 3);
-
-	_2d_mesh->upload();
-
-	_texture_material_2d->texture = p_texture;
-	_texture_material_2d->bind();
-	_2d_mesh->render();
+	_2d_batch_end();
 }
 
 void Renderer::draw_texture_tr(const Transform2D &p_transform_2d, const Ref<Texture> &p_texture, const Rect2 &p_dst_rect, const Color &p_modulate) {
@@ -225,6 +173,8 @@ void Renderer::draw_texture_clipped_tr(const Transform2D &p_transform_2d, const
 void Renderer::draw_mesh_2d(const Ref<Mesh> &p_mesh, const Ref<Texture> &p_texture, const Vector2 &p_position) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
+	flush_2d_batch();
+
 	_texture_material_2d->texture = p_texture;
 	Ref<Mesh> mesh = p_mesh;
 
@@ -232,11 +182,14 @@ void Renderer::draw_mesh_2d(const Ref<Mesh> &p_mesh, const Ref<Texture> &p_textu
 
 	_texture_material_2d->bind();
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 	camera_2d_pop_model_view_matrix();
 }
 void Renderer::draw_mesh_2d_tr(const Ref<Mesh> &p_mesh, const Ref<Texture> &p_texture, const Transform2D &p_transform_2d) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
+	flush_2d_batch();
+
 	_texture_material_2d->texture = p_texture;
 	Ref<Mesh> mesh = p_mesh;
 
@@ -245,12 +198,15 @@ void Renderer::draw_mesh_2d_tr(const Ref<Mesh> &p_mesh, const Ref<Texture> &p_te
 	_texture_material_2d->bind();
 
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 	camera_2d_pop_model_view_matrix();
 }
 void Renderer::draw_mesh_2d_mat(const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Vector2 &p_position) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 	ERR_FAIL_COND(!p_material.is_valid());
 
+	flush_2d_batch();
+
 	Ref<Material> material = p_material;
 	Ref<Mesh> mesh = p_mesh;
 
@@ -259,12 +215,15 @@ void Renderer::draw_mesh_2d_mat(const Ref<Mesh> &p_mesh, const Ref<Material> &p_
 	material->bind();
 
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 	camera_2d_pop_model_view_matrix();
 }
 void Renderer::draw_mesh_2d_mat_tr(const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Transform2D &p_transform_2d) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 	ERR_FAIL_COND(!p_material.is_valid());
 
+	flush_2d_batch();
+
 	Ref<Material> material = p_material;
 	Ref<Mesh> mesh = p_mesh;
 
@@ -273,52 +232,73 @@ void Renderer::draw_mesh_2d_mat_tr(const Ref<Mesh> &p_mesh, const Ref<Material>
 	material->bind();
 
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 	camera_2d_pop_model_view_matrix();
 }
 
 void Renderer::draw_text_2d(const String &p_text, const Ref<Font> &p_font, const Vector2 &p_position, const Color &p_color) {
 	ERR_FAIL_COND(!p_font.is_valid());
 
-	_font_mesh->clear();
-	p_font->generate_mesh(p_text, _font_mesh, p_color);
-	_font_mesh->upload();
+	// Dynamic fonts might replace their texture while adding the glyphs
+	p_font->cache_glyphs(p_text);
 
-	_font_material->texture = p_font->get_texture();
+	_2d_batch_begin(p_font->is_sdf() ? BATCH_2D_MATERIAL_FONT_SDF : BATCH_2D_MATERIAL_FONT, p_font->get_texture());
 
-	camera_2d_push_model_view_matrix(Transform2D().translated(p_position));
+	int vertex_start = _2d_mesh->get_vertex_count();
+	p_font->generate_mesh(p_text, _2d_mesh, p_color);
+	_2d_batch_transform_vertices(vertex_start, _camera_2d_model_view_matrix * Transform2D().translated(p_position));
 
-	_font_material->bind();
-
-	_font_mesh->render();
-	camera_2d_pop_model_view_matrix();
+	_2d_batch_end();
 }
 void Renderer::draw_text_2d_tf(const String &p_text, const Ref<Font> &p_font, const Transform2D &p_transform_2d, const Color &p_color) {
 	camera_2d_push_model_view_matrix(p_transform_2d);
 	draw_text_2d(p_text, p_font, Vector2(), p_color);
 	camera_2d_pop_model_view_matrix();
 }
-void Renderer::draw_text_2d_tf_material(const String &p_text, const Ref<Font> &p_font, const Ref<Material> &p_material, const Transform2D &p_transform_2d, const Color &p_color) {
-	ERR_FAIL_COND(!p_font.is_valid());
-	ERR_FAIL_COND(!p_material.is_valid());
+void Renderer::draw_text_layout_2d(const Ref<TextLayout> &p_layout, const Vector2 &p_position, const Color &p_color) {
+	ERR_FAIL_COND(!p_layout.is_valid());
 
-	_font_mesh->clear();
-	p_font->generate_mesh(p_text, _font_mesh, p_color);
-	_font_mesh->upload();
+	Ref<TextLayout> layout = p_layout;
+	layout->update();
 
-	Ref<Material> material = p_material;
+	Ref<Font> font = layout->get_font();
 
-	camera_2d_push_model_view_matrix(p_transform_2d);
+	if (!font.is_valid()) {
+		return;
+	}
 
-	material->bind();
+	_2d_batch_begin(font->is_sdf() ? BATCH_2D_MATERIAL_FONT_SDF : BATCH_2D_MATERIAL_FONT, font->get_texture());
 
-	_font_mesh->render();
+	int vertex_start = _2d_mesh->get_vertex_count();
+	layout->add_to_mesh(_2d_mesh, p_color);
+	_2d_batch_transform_vertices(vertex_start, _camera_2d_model_view_matrix * Transform2D().translated(p_position));
+
+	_2d_batch_end();
+}
+void Renderer::draw_text_layout_2d_tf(const Ref<TextLayout> &p_layout, const Transform2D &p_transform_2d, const Color &p_color) {
+	camera_2d_push_model_view_matrix(p_transform_2d);
+	draw_text_layout_2d(p_layout, Vector2(), p_color);
 	camera_2d_pop_model_view_matrix();
 }
+void Renderer::draw_text_2d_tf_material(const String &p_text, const Ref<Font> &p_font, const Ref<Material> &p_material, const Transform2D &p_transform_2d, const Color &p_color) {
+	ERR_FAIL_COND(!p_font.is_valid());
+	ERR_FAIL_COND(!p_material.is_valid());
+
+	_2d_batch_begin(BATCH_2D_MATERIAL_CUSTOM, Ref<Texture>(), p_material);
+
+	int vertex_start = _2d_mesh->get_vertex_count();
+	p_font->generate_mesh(p_text, _2d_mesh, p_color);
+	_2d_batch_transform_vertices(vertex_start, _camera_2d_model_view_matrix * p_transform_2d);
+
+	_2d_batch_end();
+}
 
 void Renderer::draw_mesh_3d(const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Transform &p_transform) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 	ERR_FAIL_COND(!p_material.is_valid());
 
+	flush_2d_batch();
+
 	Ref<Mesh> mesh = p_mesh;
 	Ref<Material> material = p_material;
 
@@ -326,12 +306,15 @@ void Renderer::draw_mesh_3d(const Ref<Mesh> &p_mesh, const Ref<Material> &p_mate
 
 	material->bind();
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 
 	camera_3d_pop_model_view_matrix();
 }
 void Renderer::draw_mesh_3d_colored(const Ref<Mesh> &p_mesh, const Color &p_color, const Transform &p_transform) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
+	flush_2d_batch();
+
 	Ref<Mesh> mesh = p_mesh;
 	_colored_material_3d->color = p_color;
 
@@ -339,18 +322,22 @@ void Renderer::draw_mesh_3d_colored(const Ref<Mesh> &p_mesh, const Color &p_colo
 
 	_colored_material_3d->bind();
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 
 	camera_3d_pop_model_view_matrix();
 }
 void Renderer::draw_mesh_3d_vertex_colored(const Ref<Mesh> &p_mesh, const Transform &p_transform) {
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
+	flush_2d_batch();
+
 	Ref<Mesh> mesh = p_mesh;
 
 	camera_3d_push_model_view_matrix(p_transform);
 
 	_color_material_3d->bind();
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 
 	camera_3d_pop_model_view_matrix();
 }
@@ -358,6 +345,8 @@ void Renderer::draw_mesh_3d_textured(const Ref<Mesh> &p_mesh, const Ref<Texture>
 	ERR_FAIL_COND(!p_mesh.is_valid());
 	ERR_FAIL_COND(!p_texture.is_valid());
 
+	flush_2d_batch();
+
 	_texture_material_3d->texture = p_texture;
 	Ref<Mesh> mesh = p_mesh;
 
@@ -365,15 +354,94 @@ void Renderer::draw_mesh_3d_textured(const Ref<Mesh> &p_mesh, const Ref<Texture>
 
 	_texture_material_3d->bind();
 	mesh->render();
+	++_current_batch_stats.draw_calls;
 
 	camera_3d_pop_model_view_matrix();
 }
 
+bool Renderer::get_2d_batching_enable() const {
+	return _2d_batching_enabled;
+}
+void Renderer::set_2d_batching_enable(const bool p_enable) {
+	if (_2d_batching_enabled == p_enable) {
+		return;
+	}
+
+	flush_2d_batch();
+
+	_2d_batching_enabled = p_enable;
+}
+
+void Renderer::flush_2d_batch() {
+	if (_2d_batch_material_type == BATCH_2D_MATERIAL_NONE) {
+		return;
+	}
+
+	if (_2d_mesh->vertices.size() == 0) {
+		_2d_batch_material_type = BATCH_2D_MATERIAL_NONE;
+		_2d_batch_texture.unref();
+		_2d_batch_custom_material.unref();
+		return;
+	}
+
+	_2d_mesh->upload();
+
+	// Vertices are already in model view space
+	Transform2D model_view_matrix = RenderState::model_view_matrix_2d;
+	RenderState::model_view_matrix_2d = Transform2D();
+
+	switch (_2d_batch_material_type) {
+		case BATCH_2D_MATERIAL_COLOR:
+			_color_material_2d->bind();
+			break;
+		case BATCH_2D_MATERIAL_TEXTURE:
+			_texture_material_2d->texture = _2d_batch_texture;
+			_texture_material_2d->bind();
+			break;
+		case BATCH_2D_MATERIAL_FONT:
+			_font_material->texture = _2d_batch_texture;
+			_font_material->bind();
+			break;
+		case BATCH_2D_MATERIAL_FONT_SDF:
+			_font_sdf_material->texture = _2d_batch_texture;
+			_font_sdf_material->bind();
+			break;
+		case BATCH_2D_MATERIAL_CUSTOM:
+			_2d_batch_custom_material->bind();
+			break;
+		default:
+			break;
+	}
+
+	_2d_mesh->render();
+
+	RenderState::model_view_matrix_2d = model_view_matrix;
+
+	++_current_batch_stats.batches;
+	++_current_batch_stats.draw_calls;
+
+	_2d_mesh->clear();
+	_2d_batch_material_type = BATCH_2D_MATERIAL_NONE;
+	_2d_batch_texture.unref();
+	_2d_batch_custom_material.unref();
+}
+
+Renderer::BatchStats Renderer::get_batch_stats() const {
+	return _batch_stats;
+}
+Renderer::BatchStats Renderer::get_current_batch_stats() const {
+	return _current_batch_stats;
+}
+
 void Renderer::camera_2d_bind() {
+	flush_2d_batch();
+
 	RenderState::model_view_matrix_2d = _camera_2d_model_view_matrix;
 	RenderState::projection_matrix_2d = _camera_2d_projection_matrix;
 }
 void Renderer::camera_2d_reset() {
+	flush_2d_batch();
+
 	RenderState::model_view_matrix_2d = Transform2D();
 	RenderState::projection_matrix_2d = Transform();
 
@@ -388,6 +456,8 @@ Transform Renderer::camera_2d_get_current_projection_matrix() const {
 	return _camera_2d_projection_matrix;
 }
 void Renderer::camera_2d_push_projection_matrix(const Transform &p_transform) {
+	flush_2d_batch();
+
 	_camera_2d_projection_matrix_stack.push_back(_camera_2d_projection_matrix);
 
 	_camera_2d_projection_matrix *= p_transform;
@@ -395,6 +465,8 @@ void Renderer::camera_2d_push_projection_matrix(const Transform &p_transform) {
 	RenderState::projection_matrix_2d = _camera_2d_projection_matrix;
 }
 void Renderer::camera_2d_pop_projection_matrix() {
+	flush_2d_batch();
+
 	if (_camera_2d_projection_matrix_stack.empty()) {
 		return;
 	}
@@ -409,6 +481,8 @@ int Renderer::get_camera_2d_projection_matrix_stack_size() const {
 	return _camera_2d_projection_matrix_stack.size();
 }
 void Renderer::camera_2d_projection_matrix_stack_clear() {
+	flush_2d_batch();
+
 	_camera_2d_projection_matrix_stack.clear();
 
 	_camera_2d_projection_matrix = Transform();
@@ -449,6 +523,8 @@ void Renderer::camera_2d_model_view_matrix_stack_clear() {
 }
 
 void Renderer::camera_2d_projection_set_to_window() {
+	flush_2d_batch();
+
 	Vector2 size = get_window_size();
 
 	Transform canvas_transform;
@@ -462,6 +538,8 @@ void Renderer::camera_2d_projection_set_to_window() {
 }
 
 void Renderer::camera_2d_projection_set_to_size(const Size2i &p_size) {
+	flush_2d_batch();
+
 	Transform canvas_transform;
 	canvas_transform.translate_local(-(p_size.x / 2.0f), -(p_size.y / 2.0f), 0.0f);
 	//canvas_transform.scale(Vector3(2.0f / size.x, 2.0f / size.y, 1.0f));
@@ -473,6 +551,8 @@ void Renderer::camera_2d_projection_set_to_size(const Size2i &p_size) {
 }
 
 void Renderer::camera_2d_projection_set_to_render_target() {
+	flush_2d_batch();
+
 	Vector2 size = RenderState::render_rect.size;
 
 	Transform canvas_transform;
@@ -486,6 +566,8 @@ void Renderer::camera_2d_projection_set_to_render_target() {
 }
 
 void Renderer::camera_2d_projection_set_to_transform(const Transform &p_transform) {
+	flush_2d_batch();
+
 	RenderState::projection_matrix_2d = p_transform;
 	_camera_2d_projection_matrix_stack.clear();
 	_camera_2d_projection_matrix = p_transform;
@@ -760,6 +842,8 @@ Vector3 Renderer::camera_3d_project_position(const Point2 &p_point, float p_z_de
 }
 
 void Renderer::clear_screen(const Color &p_color) {
+	flush_2d_batch();
+
 	glClearColor(p_color.r, p_color.g, p_color.b, p_color.a);
 
 	if (!_depth_buffer) {
@@ -796,19 +880,30 @@ Renderer::Renderer() {
 
 	_2d_mesh.instance();
 	_2d_mesh->vertex_dimesions = 2;
+	_2d_mesh->set_buffer_usage(Mesh::BUFFER_USAGE_STREAM);
+	// Floats are kept, draw_texture*() callers can use repeating uvs and overbright modulate colors
+	_2d_mesh->set_vertex_layout(Mesh::VERTEX_LAYOUT_INTERLEAVED);
 	_3d_mesh.instance();
-	_font_mesh.instance();
-	_font_mesh->vertex_dimesions = 2;
+
+	_2d_batching_enabled = false;
+	_2d_batch_material_type = BATCH_2D_MATERIAL_NONE;
 
 	_texture_material_2d.instance();
 	_font_material.instance();
+	_font_sdf_material.instance();
 	_color_material_2d.instance();
 
 	_texture_material_3d.instance();
 	_color_material_3d.instance();
 	_colored_material_3d.instance();
+
+	RenderState::flush_callback = &Renderer::_render_state_flush_callback;
 }
 Renderer::~Renderer() {
+	if (RenderState::flush_callback == &Renderer::_render_state_flush_callback) {
+		RenderState::flush_callback = NULL;
+	}
+
 	_singleton = NULL;
 }
 
@@ -816,4 +911,91 @@ Renderer *Renderer::get_singleton() {
 	return _singleton;
 }
 
+void Renderer::_2d_batch_begin(const Batch2DMaterial p_material_type, const Ref<Texture> &p_texture, const Ref<Material> &p_custom_material) {
+	if (_2d_batch_material_type == p_material_type && _2d_batch_texture == p_texture && _2d_batch_custom_material == p_custom_material) {
+		return;
+	}
+
+	flush_2d_batch();
+
+	_2d_batch_material_type = p_material_type;
+	_2d_batch_texture = p_texture;
+	_2d_batch_custom_material = p_custom_material;
+}
+
+void Renderer::_2d_batch_add_quad(const Vector2 &p_p0, const Vector2 &p_p1, const Vector2 &p_p2, const Vector2 &p_p3, const Color &p_color) {
+	uint32_t vertex_start = _2d_mesh->get_vertex_count();
+
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p0));
+
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p1));
+
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p2));
+
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p3));
+
+	_2d_mesh->add_triangle(vertex_start + 1, vertex_start + 0, vertex_start + 2);
+	_2d_mesh->add_triangle(vertex_start + 0, vertex_start + 1, vertex_start + 3);
+}
+
+void Renderer::_2d_batch_add_quad_uv(const Vector2 &p_p0, const Vector2 &p_p1, const Vector2 &p_p2, const Vector2 &p_p3, const Vector2 &p_uv_from, const Vector2 &p_uv_to, const Color &p_color) {
+	uint32_t vertex_start = _2d_mesh->get_vertex_count();
+
+	_2d_mesh->add_uv(p_uv_from.x, p_uv_from.y);
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p0));
+
+	_2d_mesh->add_uv(p_uv_to.x, p_uv_to.y);
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p1));
+
+	_2d_mesh->add_uv(p_uv_from.x, p_uv_to.y);
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p2));
+
+	_2d_mesh->add_uv(p_uv_to.x, p_uv_from.y);
+	_2d_mesh->add_color(p_color);
+	_2d_mesh->add_vertex2(_camera_2d_model_view_matrix.xform(p_p3));
+
+	_2d_mesh->add_triangle(vertex_start + 1, vertex_start + 0, vertex_start + 2);
+	_2d_mesh->add_triangle(vertex_start + 0, vertex_start + 1, vertex_start + 3);
+}
+
+void Renderer::_2d_batch_transform_vertices(const int p_from_vertex, const Transform2D &p_transform) {
+	int size = _2d_mesh->vertices.size();
+	float *w = _2d_mesh->vertices.ptrw();
+
+	for (int i = p_from_vertex * 2; i < size; i += 2) {
+		Vector2 v = p_transform.xform(Vector2(w[i], w[i + 1]));
+
+		w[i] = v.x;
+		w[i + 1] = v.y;
+	}
+}
+
+void Renderer::_2d_batch_end() {
+	++_current_batch_stats.draw_commands;
+
+	if (!_2d_batching_enabled) {
+		flush_2d_batch();
+	}
+}
+
+void Renderer::_render_state_flush_callback(const bool p_frame_end) {
+	if (!_singleton) {
+		return;
+	}
+
+	_singleton->flush_2d_batch();
+
+	if (p_frame_end) {
+		_singleton->_batch_stats = _singleton->_current_batch_stats;
+		_singleton->_current_batch_stats = BatchStats();
+	}
+}
+
 Renderer *Renderer::_singleton = NULL;
@@ -19,6 +19,8 @@ class Material;
 class Texture;
 class Font;
 class FontMaterial;
+class SDFFontMaterial;
+class TextLayout;
 class TextureMaterial2D;
 class ColorMaterial2D;
 class TextureMaterial;
@@ -61,12 +63,43 @@ public:
 	void draw_text_2d(const String &p_text, const Ref<Font> &p_font, const Vector2 &p_position, const Color &p_color = Color(1, 1, 1));
 	void draw_text_2d_tf(const String &p_text, const Ref<Font> &p_font, const Transform2D &p_transform_2d, const Color &p_color = Color(1, 1, 1));
 	void draw_text_2d_tf_material(const String &p_text, const Ref<Font> &p_font, const Ref<Material> &p_material, const Transform2D &p_transform_2d, const Color &p_color = Color(1, 1, 1));
+	// The layout is only recomputed when its text or font changed, use these for text that is drawn every frame.
+	void draw_text_layout_2d(const Ref<TextLayout> &p_layout, const Vector2 &p_position, const Color &p_color = Color(1, 1, 1));
+	void draw_text_layout_2d_tf(const Ref<TextLayout> &p_layout, const Transform2D &p_transform_2d, const Color &p_color = Color(1, 1, 1));
 
 	void draw_mesh_3d(const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Transform &p_transform = Transform());
 	void draw_mesh_3d_colored(const Ref<Mesh> &p_mesh, const Color &p_color, const Transform &p_transform = Transform());
 	void draw_mesh_3d_vertex_colored(const Ref<Mesh> &p_mesh, const Transform &p_transform = Transform());
 	void draw_mesh_3d_textured(const Ref<Mesh> &p_mesh, const Ref<Texture> &p_texture, const Transform &p_transform = Transform());
 
+	// 2D Batching API
+
+	// When enabled, consecutive 2D draws (points, lines, rects, textures, text) that use the same
+	// material and texture are collected into one vertex buffer, and get drawn with a single draw call.
+	// Queued draws are submitted when the material or texture changes, when the 2d projection changes,
+	// when a non batchable draw happens, when the render target changes, and at the end of the frame.
+	bool get_2d_batching_enable() const;
+	void set_2d_batching_enable(const bool p_enable);
+
+	void flush_2d_batch();
+
+	struct BatchStats {
+		int draw_commands; // Number of batchable 2d draw calls received
+		int batches; // Number of 2d batches submitted
+		int draw_calls; // Number of actual draw calls issued
+
+		BatchStats() {
+			draw_commands = 0;
+			batches = 0;
+			draw_calls = 0;
+		}
+	};
+
+	// Stats of the last finished frame
+	BatchStats get_batch_stats() const;
+	// Stats of the frame that is currently being rendered
+	BatchStats get_current_batch_stats() const;
+
 	//2D Camera API
 
 	void camera_2d_bind();
@@ -147,10 +180,38 @@ private:
 
 	Ref<Mesh> _2d_mesh;
 	Ref<Mesh> _3d_mesh;
-	Ref<Mesh> _font_mesh;
+
+	enum Batch2DMaterial {
+		BATCH_2D_MATERIAL_NONE = 0,
+		BATCH_2D_MATERIAL_COLOR,
+		BATCH_2D_MATERIAL_TEXTURE,
+		BATCH_2D_MATERIAL_FONT,
+		BATCH_2D_MATERIAL_FONT_SDF,
+		BATCH_2D_MATERIAL_CUSTOM,
+	};
+
+	// All batchable 2d draws go through these. _2d_mesh holds the batch's vertices, already transformed into
+	// model view space, so model view matrix changes don't break batches.
+	void _2d_batch_begin(const Batch2DMaterial p_material_type, const Ref<Texture> &p_texture = Ref<Texture>(), const Ref<Material> &p_custom_material = Ref<Material>());
+	void _2d_batch_add_quad(const Vector2 &p_p0, const Vector2 &p_p1, const Vector2 &p_p2, const Vector2 &p_p3, const Color &p_color);
+	void _2d_batch_add_quad_uv(const Vector2 &p_p0, const Vector2 &p_p1, const Vector2 &p_p2, const Vector2 &p_p3, const Vector2 &p_uv_from, const Vector2 &p_uv_to, const Color &p_color);
+	void _2d_batch_transform_vertices(const int p_from_vertex, const Transform2D &p_transform);
+	void _2d_batch_end();
+
+	static void _render_state_flush_callback(const bool p_frame_end);
+
+	bool _2d_batching_enabled;
+
+	Batch2DMaterial _2d_batch_material_type;
+	Ref<Texture> _2d_batch_texture;
+	Ref<Material> _2d_batch_custom_material;
+
+	BatchStats _batch_stats;
+	BatchStats _current_batch_stats;
 
 	Ref<ColoredTextureMaterial2D> _texture_material_2d;
 	Ref<FontMaterial> _font_material;
+	Ref<SDFFontMaterial> _font_sdf_material;
 	Ref<ColorMaterial2D> _color_material_2d;
 
 	Transform _camera_2d_projection_matrix;
@@ -0,0 +1,58 @@
+//--STRIP
+#ifndef FILE_ACCESS_MAPPED_H
+#define FILE_ACCESS_MAPPED_H
+//--STRIP
+
+//--STRIP
+#include "core/file_access.h"
+//--STRIP
+
+// Read only FileAccess, that maps the whole file into memory.
+// Everything can be read through the normal get_* api, or directly through get_data().
+// Use FileAccess::create_mapped() to create one.
+
+class FileAccessMapped : public FileAccess {
+public:
+	// Only valid while the file is open.
+	_FORCE_INLINE_ const uint8_t *get_data() const { return _data; }
+	_FORCE_INLINE_ uint64_t get_size() const { return _size; }
+
+	virtual void close();
+	virtual bool is_open() const;
+
+	virtual void seek(uint64_t p_position);
+	virtual void seek_end(int64_t p_position = 0);
+	virtual uint64_t get_position() const;
+	virtual uint64_t get_len() const;
+
+	virtual bool eof_reached() const;
+
+	virtual uint8_t get_8() const;
+	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+
+	// The mapping is the buffer
+	virtual void set_read_buffer_size(uint32_t p_size) {}
+
+	virtual void flush();
+	virtual void store_8(uint8_t p_dest);
+	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length);
+
+	FileAccessMapped();
+	virtual ~FileAccessMapped();
+
+protected:
+	virtual Error _open(const String &p_path, int p_mode_flags);
+	virtual bool _fill_read_buffer() const;
+
+	// The inherited read buffer is used as a window into the mapping, so the buffered fast paths
+	// (get_line(), get_token(), get_32() etc.) work without copying. Its length is 32 bit, hence the windows.
+	void _set_window(uint64_t p_position) const;
+
+	const uint8_t *_data;
+	uint64_t _size;
+	bool _opened;
+};
+
+//--STRIP
+#endif
+//--STRIP
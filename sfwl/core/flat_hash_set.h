@@ -0,0 +1,311 @@
+//--STRIP
+#ifndef FLAT_HASH_SET_H
+#define FLAT_HASH_SET_H
+//--STRIP
+
+//--STRIP
+#include "core/error_macros.h"
+#include "core/flat_hash_map.h"
+#include "core/hashfuncs.h"
+#include "core/memory.h"
+#include "core/typedefs.h"
+//--STRIP
+
+/**
+ * Set version of FlatHashMap, see the notes there.
+ * Inserting invalidates iterators, erasing doesn't.
+ */
+
+template <class TKey, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashSet {
+public:
+	class Iterator {
+	public:
+		_FORCE_INLINE_ const TKey &operator*() const { return _set->_keys[_index]; }
+		_FORCE_INLINE_ const TKey *operator->() const { return &_set->_keys[_index]; }
+
+		_FORCE_INLINE_ Iterator &operator++() {
+			_index = _set->_next_full(_index + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &p_other) const { return _index == p_other._index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &p_other) const { return _index != p_other._index; }
+
+		Iterator(const FlatHashSet *p_set, uint32_t p_index) {
+			_set = p_set;
+			_index = p_index;
+		}
+
+	private:
+		friend class FlatHashSet;
+
+		const FlatHashSet *_set;
+		uint32_t _index;
+	};
+
+	_FORCE_INLINE_ uint32_t size() const { return _size; }
+	_FORCE_INLINE_ bool empty() const { return _size == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return _capacity; }
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return _find(p_key, Hasher::hash(p_key)) >= 0;
+	}
+
+	Iterator find(const TKey &p_key) const {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+		return Iterator(this, pos < 0 ? _capacity : pos);
+	}
+
+	// Returns false, if the key was already in the set.
+	bool insert(const TKey &p_key) {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (_find(p_key, hash) >= 0) {
+			return false;
+		}
+
+		_insert_new(p_key, hash);
+		return true;
+	}
+
+	bool erase(const TKey &p_key) {
+		int32_t pos = _find(p_key, Hasher::hash(p_key));
+
+		if (pos < 0) {
+			return false;
+		}
+
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Erases the element at p_iter, it can be incremented after.
+	void erase(const Iterator &p_iter) {
+		_erase_pos(p_iter._index);
+	}
+
+	// Makes room for p_count elements in total, so that many can be inserted without rehashing.
+	void reserve(uint32_t p_count) {
+		if (p_count <= FlatHashGroup::max_load(_capacity)) {
+			return;
+		}
+
+		_rehash(FlatHashGroup::capacity_for(p_count));
+	}
+
+	// Keeps the capacity.
+	void clear() {
+		if (_capacity == 0) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < _capacity; ++i) {
+			if (_ctrl[i] >= 0) {
+				_keys[i].~TKey();
+			}
+		}
+
+		memset(_ctrl, FlatHashGroup::CTRL_EMPTY, _capacity);
+		_size = 0;
+		_growth_left = FlatHashGroup::max_load(_capacity);
+	}
+
+	// Frees the memory too.
+	void reset() {
+		clear();
+		_free();
+	}
+
+	_FORCE_INLINE_ Iterator begin() const { return Iterator(this, _next_full(0)); }
+	_FORCE_INLINE_ Iterator end() const { return Iterator(this, _capacity); }
+
+	void operator=(const FlatHashSet &p_other) {
+		if (this == &p_other) {
+			return;
+		}
+
+		clear();
+		reserve(p_other._size);
+
+		for (uint32_t i = 0; i < p_other._capacity; ++i) {
+			if (p_other._ctrl[i] >= 0) {
+				_insert_new(p_other._keys[i], p_other._hashes[i]);
+			}
+		}
+	}
+
+	FlatHashSet(const FlatHashSet &p_other) {
+		*this = p_other;
+	}
+
+	FlatHashSet(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+
+	FlatHashSet() {}
+
+	~FlatHashSet() {
+		clear();
+		_free();
+	}
+
+private:
+	friend class Iterator;
+
+	int8_t *_ctrl = nullptr;
+	uint32_t *_hashes = nullptr;
+	TKey *_keys = nullptr;
+
+	uint32_t _capacity = 0;
+	uint32_t _size = 0;
+	uint32_t _growth_left = 0;
+
+	_FORCE_INLINE_ int32_t _find(const TKey &p_key, uint32_t p_hash) const {
+		if (_size == 0) {
+			return -1;
+		}
+
+		const uint32_t group_mask = _capacity / FlatHashGroup::WIDTH - 1;
+		const int8_t h2 = FlatHashGroup::h2(p_hash);
+		uint32_t group = FlatHashGroup::h1(p_hash) & group_mask;
+
+		for (uint32_t step = 1;; ++step) {
+			const uint32_t base = group * FlatHashGroup::WIDTH;
+			const FlatHashGroup g(_ctrl + base);
+
+			for (uint64_t m = g.match(h2); m; m &= m - 1) {
+				const uint32_t pos = base + FlatHashGroup::lowest(m);
+
+				if (_hashes[pos] == p_hash && Comparator::compare(_keys[pos], p_key)) {
+					return pos;
+				}
+			}
+
+			if (g.match_empty()) {
+				return -1;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _find_free(uint32_t p_hash) const {
+		const uint32_t group_mask = _capacity / FlatHashGroup::WIDTH - 1;
+		uint32_t group = FlatHashGroup::h1(p_hash) & group_mask;
+
+		for (uint32_t step = 1;; ++step) {
+			const uint32_t base = group * FlatHashGroup::WIDTH;
+			const uint64_t m = FlatHashGroup(_ctrl + base).match_empty_or_deleted();
+
+			if (m) {
+				return base + FlatHashGroup::lowest(m);
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	uint32_t _insert_new(const TKey &p_key, uint32_t p_hash) {
+		if (_capacity == 0) {
+			_rehash(FlatHashGroup::capacity_for(1));
+		}
+
+		uint32_t pos = _find_free(p_hash);
+
+		if (_growth_left == 0 && _ctrl[pos] != FlatHashGroup::CTRL_DELETED) {
+			if (_size < FlatHashGroup::max_load(_capacity) / 2) {
+				_rehash(_capacity);
+			} else {
+				_rehash(_capacity * 2);
+			}
+
+			pos = _find_free(p_hash);
+		}
+
+		if (_ctrl[pos] == FlatHashGroup::CTRL_EMPTY) {
+			--_growth_left;
+		}
+
+		_ctrl[pos] = FlatHashGroup::h2(p_hash);
+		_hashes[pos] = p_hash;
+		memnew_placement(&_keys[pos], TKey(p_key));
+		++_size;
+
+		return pos;
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		_keys[p_pos].~TKey();
+		--_size;
+
+		const uint32_t base = p_pos & ~(uint32_t)(FlatHashGroup::WIDTH - 1);
+
+		if (FlatHashGroup(_ctrl + base).match_empty()) {
+			_ctrl[p_pos] = FlatHashGroup::CTRL_EMPTY;
+			++_growth_left;
+		} else {
+			_ctrl[p_pos] = FlatHashGroup::CTRL_DELETED;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _next_full(uint32_t p_from) const {
+		while (p_from < _capacity && _ctrl[p_from] < 0) {
+			++p_from;
+		}
+
+		return p_from;
+	}
+
+	void _rehash(uint32_t p_capacity) {
+		int8_t *old_ctrl = _ctrl;
+		uint32_t *old_hashes = _hashes;
+		TKey *old_keys = _keys;
+		uint32_t old_capacity = _capacity;
+
+		_ctrl = (int8_t *)memalloc(p_capacity);
+		_hashes = (uint32_t *)memalloc(sizeof(uint32_t) * p_capacity);
+		_keys = (TKey *)memalloc(sizeof(TKey) * p_capacity);
+		memset(_ctrl, FlatHashGroup::CTRL_EMPTY, p_capacity);
+
+		_capacity = p_capacity;
+		_growth_left = FlatHashGroup::max_load(p_capacity) - _size;
+
+		for (uint32_t i = 0; i < old_capacity; ++i) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+
+			uint32_t pos = _find_free(old_hashes[i]);
+
+			_ctrl[pos] = old_ctrl[i];
+			_hashes[pos] = old_hashes[i];
+			memnew_placement(&_keys[pos], TKey(old_keys[i]));
+			old_keys[i].~TKey();
+		}
+
+		if (old_ctrl) {
+			memfree(old_ctrl);
+			memfree(old_hashes);
+			memfree(old_keys);
+		}
+	}
+
+	void _free() {
+		if (_ctrl) {
+			memfree(_ctrl);
+			memfree(_hashes);
+			memfree(_keys);
+		}
+
+		_ctrl = nullptr;
+		_hashes = nullptr;
+		_keys = nullptr;
+		_capacity = 0;
+		_growth_left = 0;
+	}
+};
+
+//--STRIP
+#endif // FLAT_HASH_SET_H
+//--STRIP
@@ -19,6 +19,8 @@
 #define PAD_ALIGN 16 //must always be greater than this at much
 #endif
 
+class MemoryArena;
+
 class Memory {
 #ifdef DEBUG_ENABLED
 	static SafeNumeric<uint64_t> mem_usage;
@@ -28,18 +30,46 @@ class Memory {
 	static SafeNumeric<uint64_t> alloc_count;
 
 public:
-	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
-	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
+	// p_description is the tag MemoryProfiler records the allocation under (usually MEMORY_CALLSITE).
+	static void *alloc_static(size_t p_bytes, bool p_pad_align = false, const char *p_description = "");
+	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false, const char *p_description = "");
 	static void free_static(void *p_ptr, bool p_pad_align = false);
 
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// While set, the calling thread's allocations come from p_arena. Use MemoryArenaScope instead of calling this directly.
+	static void set_thread_redirect_arena(MemoryArena *p_arena);
+	static MemoryArena *get_thread_redirect_arena();
+};
+
+// Turns off the calling thread's arena redirect (if any) while it's alive.
+// Everything that can outlive a redirecting MemoryArenaScope (ObjectDB, StringName, ...) has to be allocated under one.
+class MemoryHeapScope {
+public:
+	_FORCE_INLINE_ MemoryHeapScope() {
+		_prev_redirect = Memory::get_thread_redirect_arena();
+
+		if (unlikely(_prev_redirect != nullptr)) {
+			Memory::set_thread_redirect_arena(nullptr);
+		}
+	}
+
+	_FORCE_INLINE_ ~MemoryHeapScope() {
+		if (unlikely(_prev_redirect != nullptr)) {
+			Memory::set_thread_redirect_arena(_prev_redirect);
+		}
+	}
+
+protected:
+	MemoryArena *_prev_redirect;
 };
 
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return Memory::realloc_static(p_ptr, p_memory, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
@@ -56,8 +86,16 @@ void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size));
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description);
 #endif
 
-#define memalloc(m_size) Memory::alloc_static(m_size)
-#define memrealloc(m_mem, m_size) Memory::realloc_static(m_mem, m_size)
+// File and line of the allocation, for MemoryProfiler. Only compiled in with MEMORY_PROFILER_ENABLED,
+// so the strings don't end up in every build.
+#ifdef MEMORY_PROFILER_ENABLED
+#define MEMORY_CALLSITE __FILE__ ":" _MKSTR(__LINE__)
+#else
+#define MEMORY_CALLSITE ""
+#endif
+
+#define memalloc(m_size) Memory::alloc_static(m_size, false, MEMORY_CALLSITE)
+#define memrealloc(m_mem, m_size) Memory::realloc_static(m_mem, m_size, false, MEMORY_CALLSITE)
 #define memfree(m_mem) Memory::free_static(m_mem)
 
 _ALWAYS_INLINE_ void postinitialize_handler(void *) {}
@@ -68,7 +106,7 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 	return p_obj;
 }
 
-#define memnew(m_class) _post_initialize(new ("") m_class)
+#define memnew(m_class) _post_initialize(new (MEMORY_CALLSITE) m_class)
 
 _ALWAYS_INLINE_ void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description) {
 	//void *failptr=0;
@@ -114,7 +152,7 @@ void memdelete_allocator(T *p_class) {
 			memdelete(m_v);    \
 	}
 
-#define memnew_arr(m_class, m_count) memnew_arr_template<m_class>(m_count)
+#define memnew_arr(m_class, m_count) memnew_arr_template<m_class>(m_count, MEMORY_CALLSITE)
 
 template <typename T>
 T *memnew_arr_template(size_t p_elements, const char *p_descr = "") {
@@ -125,7 +163,7 @@ T *memnew_arr_template(size_t p_elements, const char *p_descr = "") {
 	same strategy used by std::vector, and the PoolVector class, so it should be safe.*/
 
 	size_t len = sizeof(T) * p_elements;
-	uint64_t *mem = (uint64_t *)Memory::alloc_static(len, true);
+	uint64_t *mem = (uint64_t *)Memory::alloc_static(len, true, p_descr);
 	T *failptr = nullptr; //get rid of a warning
 	ERR_FAIL_COND_V(!mem, failptr);
 	*(mem - 1) = p_elements;
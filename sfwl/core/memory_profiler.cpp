@@ -0,0 +1,463 @@
+//--STRIP
+#include "core/memory_profiler.h"
+
+#include "core/logger.h"
+#include "core/mutex.h"
+#include "core/sfw_time.h"
+
+#include <stdlib.h>
+#include <string.h>
+//--STRIP
+
+// The tables below use malloc directly, going through Memory from inside its own hooks would recurse.
+
+struct MemoryProfilerRecord {
+	void *ptr;
+	uint64_t size;
+	uint64_t time;
+	uint32_t tag;
+};
+
+#define MEMORY_PROFILER_TOMBSTONE ((void *)1)
+
+static Mutex _memory_profiler_mutex;
+static thread_local const char *_memory_profiler_scope = NULL;
+
+// Live allocations, open addressing on the pointer.
+static MemoryProfilerRecord *_memory_profiler_records = NULL;
+static uint32_t _memory_profiler_record_capacity = 0;
+// Including tombstones.
+static uint32_t _memory_profiler_record_used = 0;
+
+static MemoryProfiler::TagStats *_memory_profiler_tags = NULL;
+static uint32_t _memory_profiler_tag_count = 0;
+static uint32_t _memory_profiler_tag_capacity = 0;
+// Open addressing on (scope, site) pointers, holds tag index + 1.
+static uint32_t *_memory_profiler_tag_index = NULL;
+static uint32_t _memory_profiler_tag_index_capacity = 0;
+
+SafeFlag MemoryProfiler::_active;
+
+static _FORCE_INLINE_ uint32_t _memory_profiler_hash_ptr(const void *p_ptr) {
+	uint64_t v = (uint64_t)(uintptr_t)p_ptr;
+	v ^= v >> 33;
+	v *= 0xff51afd7ed558ccdULL;
+	v ^= v >> 33;
+	return (uint32_t)v;
+}
+
+static uint32_t _memory_profiler_get_tag(const char *p_scope, const char *p_site) {
+	uint32_t mask = _memory_profiler_tag_index_capacity - 1;
+	uint32_t h = (_memory_profiler_hash_ptr(p_scope) ^ (_memory_profiler_hash_ptr(p_site) * 31)) & mask;
+
+	while (_memory_profiler_tag_index[h]) {
+		MemoryProfiler::TagStats &t = _memory_profiler_tags[_memory_profiler_tag_index[h] - 1];
+
+		if (t.scope == p_scope && t.site == p_site) {
+			return _memory_profiler_tag_index[h] - 1;
+		}
+
+		h = (h + 1) & mask;
+	}
+
+	if (_memory_profiler_tag_count == _memory_profiler_tag_capacity) {
+		uint32_t capacity = _memory_profiler_tag_capacity ? _memory_profiler_tag_capacity * 2 : 64;
+		MemoryProfiler::TagStats *tags = (MemoryProfiler::TagStats *)realloc(_memory_profiler_tags, capacity * sizeof(MemoryProfiler::TagStats));
+		CRASH_COND_MSG(!tags, "Out of memory");
+
+		_memory_profiler_tags = tags;
+		_memory_profiler_tag_capacity = capacity;
+	}
+
+	uint32_t index = _memory_profiler_tag_count++;
+
+	MemoryProfiler::TagStats &t = _memory_profiler_tags[index];
+	memset(&t, 0, sizeof(MemoryProfiler::TagStats));
+	t.scope = p_scope;
+	t.site = p_site;
+
+	_memory_profiler_tag_index[h] = index + 1;
+
+	if (_memory_profiler_tag_count * 2 > _memory_profiler_tag_index_capacity) {
+		// Grow the index.
+		uint32_t capacity = _memory_profiler_tag_index_capacity * 2;
+		uint32_t *tag_index = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+		CRASH_COND_MSG(!tag_index, "Out of memory");
+
+		for (uint32_t i = 0; i < _memory_profiler_tag_count; ++i) {
+			const MemoryProfiler::TagStats &ti = _memory_profiler_tags[i];
+			uint32_t hi = (_memory_profiler_hash_ptr(ti.scope) ^ (_memory_profiler_hash_ptr(ti.site) * 31)) & (capacity - 1);
+
+			while (tag_index[hi]) {
+				hi = (hi + 1) & (capacity - 1);
+			}
+
+			tag_index[hi] = i + 1;
+		}
+
+		free(_memory_profiler_tag_index);
+		_memory_profiler_tag_index = tag_index;
+		_memory_profiler_tag_index_capacity = capacity;
+	}
+
+	return index;
+}
+
+static MemoryProfilerRecord *_memory_profiler_find_record(void *p_ptr) {
+	uint32_t mask = _memory_profiler_record_capacity - 1;
+	uint32_t h = _memory_profiler_hash_ptr(p_ptr) & mask;
+
+	while (_memory_profiler_records[h].ptr) {
+		if (_memory_profiler_records[h].ptr == p_ptr) {
+			return &_memory_profiler_records[h];
+		}
+
+		h = (h + 1) & mask;
+	}
+
+	return NULL;
+}
+
+static void _memory_profiler_insert_record(const MemoryProfilerRecord &p_record);
+
+static void _memory_profiler_grow_records() {
+	MemoryProfilerRecord *old = _memory_profiler_records;
+	uint32_t old_capacity = _memory_profiler_record_capacity;
+
+	// Only grow if it's full of live records, otherwise rehashing gets rid of the tombstones.
+	uint32_t live = 0;
+	for (uint32_t i = 0; i < old_capacity; ++i) {
+		if (old[i].ptr && old[i].ptr != MEMORY_PROFILER_TOMBSTONE) {
+			live++;
+		}
+	}
+
+	uint32_t capacity = old_capacity;
+	while (live * 4 >= capacity) {
+		capacity *= 2;
+	}
+
+	_memory_profiler_records = (MemoryProfilerRecord *)calloc(capacity, sizeof(MemoryProfilerRecord));
+	CRASH_COND_MSG(!_memory_profiler_records, "Out of memory");
+
+	_memory_profiler_record_capacity = capacity;
+	_memory_profiler_record_used = 0;
+
+	for (uint32_t i = 0; i < old_capacity; ++i) {
+		if (old[i].ptr && old[i].ptr != MEMORY_PROFILER_TOMBSTONE) {
+			_memory_profiler_insert_record(old[i]);
+		}
+	}
+
+	free(old);
+}
+
+static void _memory_profiler_insert_record(const MemoryProfilerRecord &p_record) {
+	if ((_memory_profiler_record_used + 1) * 2 > _memory_profiler_record_capacity) {
+		_memory_profiler_grow_records();
+	}
+
+	uint32_t mask = _memory_profiler_record_capacity - 1;
+	uint32_t h = _memory_profiler_hash_ptr(p_record.ptr) & mask;
+
+	while (_memory_profiler_records[h].ptr && _memory_profiler_records[h].ptr != MEMORY_PROFILER_TOMBSTONE) {
+		h = (h + 1) & mask;
+	}
+
+	if (!_memory_profiler_records[h].ptr) {
+		_memory_profiler_record_used++;
+	}
+
+	_memory_profiler_records[h] = p_record;
+}
+
+static MemoryProfiler::Lifetime _memory_profiler_get_lifetime(uint64_t p_usec) {
+	uint64_t limit = 100;
+
+	for (int i = 0; i < MemoryProfiler::LIFETIME_LONGER; ++i) {
+		if (p_usec < limit) {
+			return (MemoryProfiler::Lifetime)i;
+		}
+
+		limit *= 10;
+	}
+
+	return MemoryProfiler::LIFETIME_LONGER;
+}
+
+static void _memory_profiler_clear() {
+	free(_memory_profiler_records);
+	free(_memory_profiler_tags);
+	free(_memory_profiler_tag_index);
+
+	_memory_profiler_record_capacity = 1024;
+	_memory_profiler_record_used = 0;
+	_memory_profiler_records = (MemoryProfilerRecord *)calloc(_memory_profiler_record_capacity, sizeof(MemoryProfilerRecord));
+
+	_memory_profiler_tags = NULL;
+	_memory_profiler_tag_count = 0;
+	_memory_profiler_tag_capacity = 0;
+
+	_memory_profiler_tag_index_capacity = 256;
+	_memory_profiler_tag_index = (uint32_t *)calloc(_memory_profiler_tag_index_capacity, sizeof(uint32_t));
+
+	CRASH_COND_MSG(!_memory_profiler_records || !_memory_profiler_tag_index, "Out of memory");
+}
+
+void MemoryProfiler::start() {
+	MutexLock lock(_memory_profiler_mutex);
+
+	_memory_profiler_clear();
+	_active.set();
+}
+
+void MemoryProfiler::stop() {
+	MutexLock lock(_memory_profiler_mutex);
+
+	_active.clear();
+}
+
+void MemoryProfiler::clear() {
+	MutexLock lock(_memory_profiler_mutex);
+
+	_memory_profiler_clear();
+}
+
+struct _MemoryProfilerNameComparator {
+	static int compare(const char *p_a, const char *p_b) {
+		return strcmp(p_a ? p_a : "", p_b ? p_b : "");
+	}
+
+	_FORCE_INLINE_ bool operator()(const MemoryProfiler::TagStats &p_a, const MemoryProfiler::TagStats &p_b) const {
+		int c = compare(p_a.scope, p_b.scope);
+
+		if (c != 0) {
+			return c < 0;
+		}
+
+		return compare(p_a.site, p_b.site) < 0;
+	}
+};
+
+struct _MemoryProfilerBytesComparator {
+	_FORCE_INLINE_ bool operator()(const MemoryProfiler::TagStats &p_a, const MemoryProfiler::TagStats &p_b) const {
+		return p_a.total_bytes > p_b.total_bytes;
+	}
+};
+
+Vector<MemoryProfiler::TagStats> MemoryProfiler::get_snapshot() {
+	// Copied with malloc while locked. Allocating the Vector in there would record into the tables while they are read.
+	uint32_t count = 0;
+	TagStats *copy = NULL;
+
+	{
+		MutexLock lock(_memory_profiler_mutex);
+
+		count = _memory_profiler_tag_count;
+
+		if (count) {
+			copy = (TagStats *)malloc(count * sizeof(TagStats));
+			ERR_FAIL_COND_V(!copy, Vector<TagStats>());
+
+			memcpy(copy, _memory_profiler_tags, count * sizeof(TagStats));
+		}
+	}
+
+	Vector<TagStats> ret;
+	ret.resize(count);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		ret.write[i] = copy[i];
+	}
+
+	free(copy);
+
+	if (ret.size() > 1) {
+		// The same call site can have more than one copy of its string (e.g. inline functions in different
+		// translation units), these get merged.
+		ret.sort_custom<_MemoryProfilerNameComparator>();
+
+		int j = 0;
+		for (int i = 1; i < ret.size(); ++i) {
+			TagStats &a = ret.write[j];
+			const TagStats &b = ret[i];
+
+			if (_MemoryProfilerNameComparator::compare(a.scope, b.scope) == 0 && _MemoryProfilerNameComparator::compare(a.site, b.site) == 0) {
+				a.alloc_count += b.alloc_count;
+				a.realloc_count += b.realloc_count;
+				a.free_count += b.free_count;
+				a.total_bytes += b.total_bytes;
+				a.live_count += b.live_count;
+				a.live_bytes += b.live_bytes;
+				// Not exact, the peaks might not have been at the same time.
+				a.peak_bytes = MAX(a.peak_bytes, b.peak_bytes);
+
+				for (int k = 0; k < LIFETIME_MAX; ++k) {
+					a.lifetimes[k] += b.lifetimes[k];
+				}
+			} else {
+				ret.write[++j] = b;
+			}
+		}
+
+		ret.resize(j + 1);
+		ret.sort_custom<_MemoryProfilerBytesComparator>();
+	}
+
+	return ret;
+}
+
+String MemoryProfiler::get_report(int p_max_entries) {
+	static const char *lifetime_names[LIFETIME_MAX] = { "<100us", "<1ms", "<10ms", "<100ms", "<1s", "<10s", ">10s" };
+
+	Vector<TagStats> stats = get_snapshot();
+
+	uint64_t total_allocs = 0;
+	uint64_t total_bytes = 0;
+	uint64_t live_bytes = 0;
+
+	for (int i = 0; i < stats.size(); ++i) {
+		total_allocs += stats[i].alloc_count;
+		total_bytes += stats[i].total_bytes;
+		live_bytes += stats[i].live_bytes;
+	}
+
+	String r;
+	r += "Memory profile: " + itos(total_allocs) + " allocations, " + String::humanize_size(total_bytes) + " total, " + String::humanize_size(live_bytes) + " live, " + itos(stats.size()) + " tags\n";
+
+	int count = stats.size();
+	if (p_max_entries >= 0 && p_max_entries < count) {
+		count = p_max_entries;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		const TagStats &t = stats[i];
+
+		String name = t.scope ? String(t.scope) : String("-");
+		name += " | ";
+		name += (t.site && t.site[0]) ? String(t.site) : String("?");
+
+		r += name + "\n";
+		r += "    allocs " + itos(t.alloc_count) + ", reallocs " + itos(t.realloc_count) + ", frees " + itos(t.free_count);
+		r += ", total " + String::humanize_size(t.total_bytes);
+		r += ", live " + itos(t.live_count) + " (" + String::humanize_size(t.live_bytes) + ")";
+		r += ", peak " + String::humanize_size(t.peak_bytes) + "\n";
+		r += "    lifetimes";
+
+		for (int k = 0; k < LIFETIME_MAX; ++k) {
+			r += String(" ") + lifetime_names[k] + ": " + itos(t.lifetimes[k]);
+		}
+
+		r += "\n";
+	}
+
+	if (count < stats.size()) {
+		r += "... " + itos(stats.size() - count) + " more tags\n";
+	}
+
+	return r;
+}
+
+void MemoryProfiler::print_report(int p_max_entries) {
+	RLogger::print_message(get_report(p_max_entries));
+}
+
+const char *MemoryProfiler::set_scope(const char *p_tag) {
+	const char *prev = _memory_profiler_scope;
+	_memory_profiler_scope = p_tag;
+	return prev;
+}
+
+const char *MemoryProfiler::get_scope() {
+	return _memory_profiler_scope;
+}
+
+void MemoryProfiler::_on_alloc(void *p_ptr, size_t p_bytes, const char *p_site) {
+	if (!p_ptr) {
+		return;
+	}
+
+	uint64_t time = SFWTime::time_us();
+
+	MutexLock lock(_memory_profiler_mutex);
+
+	if (!_active.is_set()) {
+		return;
+	}
+
+	uint32_t tag = _memory_profiler_get_tag(_memory_profiler_scope, p_site ? p_site : "");
+
+	TagStats &t = _memory_profiler_tags[tag];
+	t.alloc_count++;
+	t.total_bytes += p_bytes;
+	t.live_count++;
+	t.live_bytes += p_bytes;
+	t.peak_bytes = MAX(t.peak_bytes, t.live_bytes);
+
+	MemoryProfilerRecord record;
+	record.ptr = p_ptr;
+	record.size = p_bytes;
+	record.time = time;
+	record.tag = tag;
+
+	_memory_profiler_insert_record(record);
+}
+
+void MemoryProfiler::_on_realloc(void *p_old_ptr, void *p_new_ptr, size_t p_bytes) {
+	MutexLock lock(_memory_profiler_mutex);
+
+	if (!_active.is_set()) {
+		return;
+	}
+
+	MemoryProfilerRecord *record = _memory_profiler_find_record(p_old_ptr);
+
+	if (!record) {
+		// Allocated before the profiler was started.
+		return;
+	}
+
+	TagStats &t = _memory_profiler_tags[record->tag];
+	t.realloc_count++;
+
+	if (p_bytes > record->size) {
+		t.total_bytes += p_bytes - record->size;
+	}
+
+	t.live_bytes = t.live_bytes - record->size + p_bytes;
+	t.peak_bytes = MAX(t.peak_bytes, t.live_bytes);
+
+	record->size = p_bytes;
+
+	if (p_new_ptr != p_old_ptr) {
+		MemoryProfilerRecord moved = *record;
+		moved.ptr = p_new_ptr;
+
+		record->ptr = MEMORY_PROFILER_TOMBSTONE;
+		_memory_profiler_insert_record(moved);
+	}
+}
+
+void MemoryProfiler::_on_free(void *p_ptr) {
+	uint64_t time = SFWTime::time_us();
+
+	MutexLock lock(_memory_profiler_mutex);
+
+	if (!_active.is_set()) {
+		return;
+	}
+
+	MemoryProfilerRecord *record = _memory_profiler_find_record(p_ptr);
+
+	if (!record) {
+		return;
+	}
+
+	TagStats &t = _memory_profiler_tags[record->tag];
+	t.free_count++;
+	t.live_count--;
+	t.live_bytes -= record->size;
+	t.lifetimes[_memory_profiler_get_lifetime(time - record->time)]++;
+
+	record->ptr = MEMORY_PROFILER_TOMBSTONE;
+}
@@ -4,6 +4,7 @@
 
 #include "core/pool_vector.h"
 #include "core/string_name.h"
+#include "core/worker_pool.h"
 //--STRIP
 
 void SFWCore::setup() {
@@ -24,6 +25,7 @@ void SFWCore::cleanup() {
 
 	_initialized = false;
 
+	WorkerPool::cleanup();
 	StringName::cleanup();
 	MemoryPool::cleanup();
 }
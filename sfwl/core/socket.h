@@ -23,8 +23,21 @@
 #include "inet_address.h"
 //--STRIP
 
+class FileAccess;
+
 class Socket {
 public:
+	// Same as iovec
+	struct IOBuffer {
+		void *data;
+		uint64_t size;
+	};
+
+	// At most SOCKET_IO_BUFFER_MAX buffers are used per call.
+	enum {
+		SOCKET_IO_BUFFER_MAX = 64,
+	};
+
 	void create_net_socket();
 	void create(int family);
 	void close_socket();
@@ -39,6 +52,17 @@ public:
 	int read(char *buffer, uint64_t len);
 	int send(const char *buffer, uint64_t len);
 
+	// Scatter / gather versions of read() and send(), e.g. a header and a payload in one syscall.
+	// Return the number of bytes transferred, which can be less than the total on non blocking sockets.
+	int readv(const IOBuffer *p_buffers, int p_count);
+	int writev(const IOBuffer *p_buffers, int p_count);
+
+	// Sends p_len bytes starting at p_offset of the file, without copying them through user space where
+	// the platform supports it (sendfile()). The position of the file is not changed.
+	// Returns the number of bytes sent (can be less than p_len on non blocking sockets), or -1.
+	int64_t send_file(int p_fd, uint64_t p_offset, uint64_t p_len);
+	int64_t send_file(FileAccess *p_file, uint64_t p_offset, uint64_t p_len);
+
 	bool is_self_connect();
 
 	void set_tcp_nodelay(bool on);
@@ -0,0 +1,706 @@
+//--STRIP
+#include "socket_event_loop.h"
+
+#include "core/error_macros.h"
+#include "core/memory.h"
+#include "core/sfw_time.h"
+#include "core/sort_array.h"
+//--STRIP
+
+#include <cerrno>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <winsock2.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef SOCKET_EVENT_LOOP_EPOLL
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+#endif
+
+static bool _socket_event_loop_would_block() {
+#if defined(_WIN64) || defined(_WIN32)
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+static bool _socket_event_loop_interrupted() {
+#if defined(_WIN64) || defined(_WIN32)
+	return WSAGetLastError() == WSAEINTR;
+#else
+	return errno == EINTR;
+#endif
+}
+
+Error SocketEventLoop::add_socket(Socket *p_socket, ReadCallback p_read_callback, WriteCallback p_write_callback, CloseCallback p_close_callback, void *p_userdata) {
+	ERR_FAIL_COND_V(!p_socket, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(p_socket->_socket == 0, ERR_INVALID_PARAMETER, "The socket is not open.");
+	ERR_FAIL_COND_V_MSG(_entries.has(p_socket), ERR_ALREADY_EXISTS, "The socket is already in this loop.");
+
+	p_socket->set_non_block();
+
+#ifdef SO_NOSIGPIPE
+	// No MSG_NOSIGNAL on these platforms, a peer closing the connection shouldn't kill the process.
+	int on = 1;
+	::setsockopt(p_socket->_socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+	Entry *e = memnew(Entry);
+	e->socket = p_socket;
+	e->fd = p_socket->_socket;
+	e->read_callback = p_read_callback;
+	e->write_callback = p_write_callback;
+	e->close_callback = p_close_callback;
+	e->userdata = p_userdata;
+
+	if (!_backend_add(e)) {
+		memdelete(e);
+		ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Couldn't register the socket.");
+	}
+
+	_entries.insert(p_socket, e);
+
+	return OK;
+}
+
+void SocketEventLoop::remove_socket(Socket *p_socket) {
+	Entry *e = _get_entry(p_socket);
+	ERR_FAIL_COND(!e);
+
+	_remove_entry(e, false);
+}
+
+bool SocketEventLoop::has_socket(Socket *p_socket) const {
+	return _entries.has(p_socket);
+}
+
+void SocketEventLoop::close_socket(Socket *p_socket, bool p_flush_output) {
+	Entry *e = _get_entry(p_socket);
+	ERR_FAIL_COND(!e);
+
+	if (p_flush_output && e->output_position < e->output.size()) {
+		// Write interest is already on, _flush_output() will finish it.
+		e->close_after_flush = true;
+		return;
+	}
+
+	_remove_entry(e, true);
+}
+
+Error SocketEventLoop::send(Socket *p_socket, const char *p_data, uint64_t p_len) {
+	Entry *e = _get_entry(p_socket);
+	ERR_FAIL_COND_V(!e, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(e->close_after_flush, ERR_UNAVAILABLE, "The socket is being closed.");
+
+	if (e->broken) {
+		return ERR_CONNECTION_ERROR;
+	}
+
+	uint32_t size = e->output.size();
+
+	// Checked before anything is written, so a rejected send doesn't leave half a message on the wire.
+	ERR_FAIL_COND_V_MSG(p_len > UINT32_MAX - size, ERR_OUT_OF_MEMORY, "Too much pending output.");
+
+	const uint8_t *data = (const uint8_t *)p_data;
+
+	// Nothing is queued, so try to skip the buffer entirely.
+	if (e->output_position == size) {
+		int64_t written = _write(e, data, p_len);
+
+		if (written < 0) {
+			// Removing it here would close the socket under the caller, which can be one of our own callbacks.
+			e->broken = true;
+			e->output.clear();
+			e->output_position = 0;
+			_broken_sockets.push_back(p_socket);
+			return ERR_CONNECTION_ERROR;
+		}
+
+		data += written;
+		p_len -= written;
+	}
+
+	if (p_len == 0) {
+		return OK;
+	}
+
+	e->output.resize(size + p_len);
+	memcpy(e->output.ptr() + size, data, p_len);
+
+	_update_write_interest(e);
+
+	return OK;
+}
+
+uint64_t SocketEventLoop::get_pending_output_size(Socket *p_socket) const {
+	Entry *e = _get_entry(p_socket);
+	ERR_FAIL_COND_V(!e, 0);
+
+	return e->output.size() - e->output_position;
+}
+
+void SocketEventLoop::notify_writable(Socket *p_socket) {
+	Entry *e = _get_entry(p_socket);
+	ERR_FAIL_COND(!e);
+
+	e->notify_writable = true;
+	_update_write_interest(e);
+}
+
+uint64_t SocketEventLoop::add_timer(uint64_t p_delay_msec, TimerCallback p_callback, void *p_userdata, bool p_repeat) {
+	ERR_FAIL_COND_V(!p_callback, 0);
+	ERR_FAIL_COND_V_MSG(p_repeat && p_delay_msec == 0, 0, "Repeating timers need a delay.");
+
+	Timer timer;
+	timer.callback = p_callback;
+	timer.userdata = p_userdata;
+	timer.interval_usec = p_delay_msec * 1000;
+	timer.repeat = p_repeat;
+
+	uint64_t id = ++_last_timer_id;
+
+	_timers.insert(id, timer);
+	_push_timer(SFWTime::time_us() + timer.interval_usec, id);
+
+	return id;
+}
+
+void SocketEventLoop::remove_timer(uint64_t p_timer_id) {
+	if (!_timers.erase(p_timer_id)) {
+		return;
+	}
+
+	// Heap items of removed timers are only dropped when they come up.
+	// Rebuild the heap if they pile up (e.g. idle timeouts that get re-added on every packet).
+	if (_timer_heap.size() > 64 && _timer_heap.size() > _timers.size() * 2) {
+		uint32_t count = 0;
+
+		for (uint32_t i = 0; i < _timer_heap.size(); ++i) {
+			if (_timers.has(_timer_heap[i].id)) {
+				_timer_heap[count++] = _timer_heap[i];
+			}
+		}
+
+		_timer_heap.resize(count);
+
+		SortArray<TimerHeapItem, TimerHeapComparator> sorter;
+		sorter.make_heap(0, count, _timer_heap.ptr());
+	}
+}
+
+bool SocketEventLoop::has_timer(uint64_t p_timer_id) const {
+	return _timers.has(p_timer_id);
+}
+
+void SocketEventLoop::poll(int p_timeout_msec) {
+	_process_broken_entries();
+	_backend_wait(_get_timer_timeout_msec(p_timeout_msec));
+	_process_timers();
+	_process_removed_entries();
+}
+
+void SocketEventLoop::run() {
+	while (!_exit.is_set()) {
+		poll();
+	}
+
+	_exit.clear();
+}
+
+void SocketEventLoop::stop() {
+	_exit.set();
+	_wake_up();
+}
+
+SocketEventLoop::SocketEventLoop() {
+	_last_timer_id = 0;
+	_wake_up_fds[0] = -1;
+	_wake_up_fds[1] = -1;
+
+#if !defined(_WIN64) && !defined(_WIN32)
+	if (::pipe(_wake_up_fds) == 0) {
+		for (int i = 0; i < 2; ++i) {
+			fcntl(_wake_up_fds[i], F_SETFL, fcntl(_wake_up_fds[i], F_GETFL) | O_NONBLOCK);
+			fcntl(_wake_up_fds[i], F_SETFD, FD_CLOEXEC);
+		}
+	} else {
+		_wake_up_fds[0] = -1;
+		_wake_up_fds[1] = -1;
+		ERR_PRINT("Couldn't create the wake up pipe, stop() won't interrupt poll().");
+	}
+#endif
+
+#ifdef SOCKET_EVENT_LOOP_EPOLL
+	_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+	if (_epoll_fd < 0) {
+		ERR_PRINT("epoll_create1() failed.");
+	} else if (_wake_up_fds[0] >= 0) {
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = NULL;
+
+		epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_up_fds[0], &ev);
+	}
+#else
+#if !defined(_WIN64) && !defined(_WIN32)
+	if (_wake_up_fds[0] >= 0) {
+		struct pollfd pfd;
+		pfd.fd = _wake_up_fds[0];
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+
+		_poll_fds.push_back(pfd);
+		_poll_entries.push_back(NULL);
+	}
+#endif
+#endif
+}
+
+SocketEventLoop::~SocketEventLoop() {
+	for (HashMap<Socket *, Entry *>::Element *E = _entries.front(); E; E = E->next) {
+		memdelete(E->value());
+	}
+
+	for (uint32_t i = 0; i < _removed_entries.size(); ++i) {
+		memdelete(_removed_entries[i]);
+	}
+
+#ifdef SOCKET_EVENT_LOOP_EPOLL
+	if (_epoll_fd >= 0) {
+		::close(_epoll_fd);
+	}
+#endif
+
+#if !defined(_WIN64) && !defined(_WIN32)
+	for (int i = 0; i < 2; ++i) {
+		if (_wake_up_fds[i] >= 0) {
+			::close(_wake_up_fds[i]);
+		}
+	}
+#endif
+}
+
+SocketEventLoop::Entry *SocketEventLoop::_get_entry(Socket *p_socket) const {
+	Entry *const *e = _entries.getptr(p_socket);
+
+	if (!e) {
+		return NULL;
+	}
+
+	return *e;
+}
+
+void SocketEventLoop::_handle_events(Entry *p_entry, bool p_readable, bool p_writable, bool p_error) {
+	if (p_error || p_entry->broken) {
+		_remove_entry(p_entry, true);
+		return;
+	}
+
+	if (p_readable && p_entry->read_callback) {
+		p_entry->read_callback(this, p_entry->socket, p_entry->userdata);
+
+		if (p_entry->removed || p_entry->broken) {
+			return;
+		}
+	}
+
+	if (p_writable) {
+		_flush_output(p_entry);
+	}
+}
+
+void SocketEventLoop::_flush_output(Entry *p_entry) {
+	bool drained = false;
+
+	if (p_entry->output_position < p_entry->output.size()) {
+		int64_t written = _write(p_entry, p_entry->output.ptr() + p_entry->output_position, p_entry->output.size() - p_entry->output_position);
+
+		if (written < 0) {
+			_remove_entry(p_entry, true);
+			return;
+		}
+
+		p_entry->output_position += written;
+
+		if (p_entry->output_position < p_entry->output.size()) {
+			// Drop the sent part, once it's worth the copy.
+			if (p_entry->output_position >= 65536 && p_entry->output_position * 2 >= p_entry->output.size()) {
+				uint32_t remaining = p_entry->output.size() - p_entry->output_position;
+				memmove(p_entry->output.ptr(), p_entry->output.ptr() + p_entry->output_position, remaining);
+				p_entry->output.resize(remaining);
+				p_entry->output_position = 0;
+			}
+
+			return;
+		}
+
+		// Don't let a single burst pin a big buffer for the lifetime of the connection.
+		if (p_entry->output.get_capacity() > 65536) {
+			p_entry->output.reset();
+		} else {
+			p_entry->output.clear();
+		}
+
+		p_entry->output_position = 0;
+
+		if (p_entry->close_after_flush) {
+			_remove_entry(p_entry, true);
+			return;
+		}
+
+		drained = true;
+	}
+
+	bool notify = drained || p_entry->notify_writable;
+	p_entry->notify_writable = false;
+
+	_update_write_interest(p_entry);
+
+	if (notify && p_entry->write_callback) {
+		p_entry->write_callback(this, p_entry->socket, p_entry->userdata);
+	}
+}
+
+int64_t SocketEventLoop::_write(Entry *p_entry, const uint8_t *p_data, uint64_t p_len) {
+	uint64_t written = 0;
+
+	while (written < p_len) {
+		// Socket::send() takes an int sized length on windows.
+		uint64_t chunk = MIN(p_len - written, (uint64_t)1 << 30);
+
+		int n = p_entry->socket->send((const char *)p_data + written, chunk);
+
+		if (n > 0) {
+			written += n;
+			continue;
+		}
+
+		if (n < 0 && _socket_event_loop_interrupted()) {
+			continue;
+		}
+
+		if (n < 0 && !_socket_event_loop_would_block()) {
+			return -1;
+		}
+
+		break;
+	}
+
+	return written;
+}
+
+void SocketEventLoop::_update_write_interest(Entry *p_entry) {
+	bool want_write = p_entry->output_position < p_entry->output.size() || p_entry->notify_writable;
+
+	if (want_write != p_entry->write_registered) {
+		_backend_set_write(p_entry, want_write);
+		p_entry->write_registered = want_write;
+	}
+}
+
+void SocketEventLoop::_remove_entry(Entry *p_entry, bool p_close) {
+	if (p_entry->removed) {
+		return;
+	}
+
+	p_entry->removed = true;
+	p_entry->closed = p_close;
+
+	_backend_remove(p_entry);
+	_entries.erase(p_entry->socket);
+
+	if (p_close) {
+		p_entry->socket->close_socket();
+	}
+
+	_removed_entries.push_back(p_entry);
+}
+
+void SocketEventLoop::_process_removed_entries() {
+	// Close callbacks can close other sockets, those are appended.
+	for (uint32_t i = 0; i < _removed_entries.size(); ++i) {
+		Entry *e = _removed_entries[i];
+
+		if (e->closed && e->close_callback) {
+			e->close_callback(this, e->socket, e->userdata);
+		}
+
+		memdelete(e);
+	}
+
+	_removed_entries.clear();
+}
+
+void SocketEventLoop::_process_broken_entries() {
+	for (uint32_t i = 0; i < _broken_sockets.size(); ++i) {
+		// It could have been removed (and even re-added) since.
+		Entry *e = _get_entry(_broken_sockets[i]);
+
+		if (e && e->broken) {
+			_remove_entry(e, true);
+		}
+	}
+
+	_broken_sockets.clear();
+}
+
+void SocketEventLoop::_push_timer(uint64_t p_due_usec, uint64_t p_id) {
+	TimerHeapItem item;
+	item.due_usec = p_due_usec;
+	item.id = p_id;
+
+	_timer_heap.push_back(item);
+
+	SortArray<TimerHeapItem, TimerHeapComparator> sorter;
+	sorter.push_heap(0, _timer_heap.size() - 1, 0, item, _timer_heap.ptr());
+}
+
+int SocketEventLoop::_get_timer_timeout_msec(int p_timeout_msec) const {
+	if (_timer_heap.size() == 0) {
+		return p_timeout_msec;
+	}
+
+	uint64_t now = SFWTime::time_us();
+	uint64_t due = _timer_heap[0].due_usec;
+
+	int timer_timeout = 0;
+
+	if (due > now) {
+		// Round up, waking up early would just mean another wait.
+		timer_timeout = (int)MIN((due - now + 999) / 1000, (uint64_t)0x7FFFFFFF);
+	}
+
+	if (p_timeout_msec < 0) {
+		return timer_timeout;
+	}
+
+	return MIN(p_timeout_msec, timer_timeout);
+}
+
+void SocketEventLoop::_process_timers() {
+	if (_timer_heap.size() == 0) {
+		return;
+	}
+
+	uint64_t now = SFWTime::time_us();
+
+	SortArray<TimerHeapItem, TimerHeapComparator> sorter;
+
+	while (_timer_heap.size() > 0 && _timer_heap[0].due_usec <= now) {
+		TimerHeapItem item = _timer_heap[0];
+
+		sorter.pop_heap(0, _timer_heap.size(), _timer_heap.ptr());
+		_timer_heap.resize(_timer_heap.size() - 1);
+
+		Timer *t = _timers.getptr(item.id);
+
+		if (!t) {
+			// Removed
+			continue;
+		}
+
+		// The callback can add and remove timers, so it needs a copy.
+		Timer timer = *t;
+
+		if (timer.repeat) {
+			uint64_t due = item.due_usec + timer.interval_usec;
+
+			// Don't try to catch up after a stall, that would fire it in a burst.
+			if (due <= now) {
+				due = now + timer.interval_usec;
+			}
+
+			_push_timer(due, item.id);
+		} else {
+			_timers.erase(item.id);
+		}
+
+		timer.callback(this, timer.userdata);
+	}
+}
+
+void SocketEventLoop::_wake_up() {
+#if !defined(_WIN64) && !defined(_WIN32)
+	if (_wake_up_fds[1] >= 0) {
+		char c = 0;
+		// If the pipe is full, the loop is going to wake up anyway.
+		ssize_t ret = ::write(_wake_up_fds[1], &c, 1);
+		(void)ret;
+	}
+#endif
+}
+
+#ifdef SOCKET_EVENT_LOOP_EPOLL
+
+bool SocketEventLoop::_backend_add(Entry *p_entry) {
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = p_entry;
+
+	return epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, p_entry->fd, &ev) == 0;
+}
+
+void SocketEventLoop::_backend_set_write(Entry *p_entry, bool p_enabled) {
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | (p_enabled ? EPOLLOUT : 0);
+	ev.data.ptr = p_entry;
+
+	epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, p_entry->fd, &ev);
+}
+
+void SocketEventLoop::_backend_remove(Entry *p_entry) {
+	// Pre 2.6.9 kernels need a non NULL event.
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+
+	epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, p_entry->fd, &ev);
+}
+
+void SocketEventLoop::_backend_wait(int p_timeout_msec) {
+	struct epoll_event events[128];
+
+	int count = epoll_wait(_epoll_fd, events, 128, p_timeout_msec);
+
+	if (count < 0) {
+		if (errno != EINTR) {
+			ERR_PRINT("epoll_wait() failed.");
+		}
+
+		return;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		Entry *e = (Entry *)events[i].data.ptr;
+
+		if (!e) {
+			char buf[64];
+
+			while (::read(_wake_up_fds[0], buf, sizeof(buf)) > 0) {
+				;
+			}
+
+			continue;
+		}
+
+		// Removed by an earlier callback in this batch. It's only freed after the batch.
+		if (e->removed) {
+			continue;
+		}
+
+		uint32_t ev = events[i].events;
+
+		// On a hangup, let the read callback see the remaining data, and the 0 read.
+		bool error = (ev & EPOLLERR) || ((ev & EPOLLHUP) && !(ev & EPOLLIN));
+
+		_handle_events(e, ev & EPOLLIN, ev & EPOLLOUT, error);
+	}
+}
+
+#else
+
+#if defined(_WIN64) || defined(_WIN32)
+#define SOCKET_EVENT_LOOP_POLL WSAPoll
+#else
+#define SOCKET_EVENT_LOOP_POLL ::poll
+#endif
+
+bool SocketEventLoop::_backend_add(Entry *p_entry) {
+	struct pollfd pfd;
+	pfd.fd = p_entry->fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	p_entry->poll_index = _poll_fds.size();
+
+	_poll_fds.push_back(pfd);
+	_poll_entries.push_back(p_entry);
+
+	return true;
+}
+
+void SocketEventLoop::_backend_set_write(Entry *p_entry, bool p_enabled) {
+	_poll_fds[p_entry->poll_index].events = POLLIN | (p_enabled ? POLLOUT : 0);
+}
+
+void SocketEventLoop::_backend_remove(Entry *p_entry) {
+	int index = p_entry->poll_index;
+	int last = _poll_fds.size() - 1;
+
+	// If this happens while the events are dispatched, the moved socket's event is either handled
+	// later in the same batch, or the next time, as everything is level triggered.
+	if (index != last) {
+		_poll_fds[index] = _poll_fds[last];
+		_poll_entries[index] = _poll_entries[last];
+		_poll_entries[index]->poll_index = index;
+	}
+
+	_poll_fds.resize(last);
+	_poll_entries.resize(last);
+
+	p_entry->poll_index = -1;
+}
+
+void SocketEventLoop::_backend_wait(int p_timeout_msec) {
+	if (_poll_fds.size() == 0) {
+		// WSAPoll() fails with an empty set.
+		SFWTime::sleep_ms(p_timeout_msec < 0 ? 10 : p_timeout_msec);
+		return;
+	}
+
+	int count = SOCKET_EVENT_LOOP_POLL(_poll_fds.ptr(), _poll_fds.size(), p_timeout_msec);
+
+	if (count < 0) {
+		if (!_socket_event_loop_interrupted()) {
+			ERR_PRINT("poll() failed.");
+		}
+
+		return;
+	}
+
+	uint32_t size = _poll_fds.size();
+
+	for (uint32_t i = 0; i < size && i < _poll_fds.size(); ++i) {
+		short revents = _poll_fds[i].revents;
+
+		if (!revents) {
+			continue;
+		}
+
+		_poll_fds[i].revents = 0;
+
+		Entry *e = _poll_entries[i];
+
+		if (!e) {
+#if !defined(_WIN64) && !defined(_WIN32)
+			char buf[64];
+
+			while (::read(_wake_up_fds[0], buf, sizeof(buf)) > 0) {
+				;
+			}
+#endif
+
+			continue;
+		}
+
+		if (e->removed) {
+			continue;
+		}
+
+		bool error = (revents & (POLLERR | POLLNVAL)) || ((revents & POLLHUP) && !(revents & POLLIN));
+
+		_handle_events(e, revents & POLLIN, revents & POLLOUT, error);
+	}
+}
+
+#undef SOCKET_EVENT_LOOP_POLL
+
+#endif
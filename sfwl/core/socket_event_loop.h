@@ -0,0 +1,190 @@
+//--STRIP
+#ifndef SOCKET_EVENT_LOOP_H
+#define SOCKET_EVENT_LOOP_H
+//--STRIP
+
+//--STRIP
+#include "core/error_list.h"
+#include "core/hash_map.h"
+#include "core/int_types.h"
+#include "core/local_vector.h"
+#include "core/safe_refcount.h"
+#include "core/socket.h"
+#include "core/typedefs.h"
+//--STRIP
+
+#if defined(__linux__) && !defined(NO_EPOLL)
+#define SOCKET_EVENT_LOOP_EPOLL
+#else
+struct pollfd;
+#endif
+
+// Single threaded readiness multiplexer for non blocking Sockets, with timers.
+// Uses epoll on linux, and poll() (WSAPoll() on windows) everywhere else, or when NO_EPOLL is defined.
+//
+// Writes should go through send(). Whatever the kernel doesn't accept right away is kept in a per socket
+// output buffer, and gets flushed when the socket becomes writable again.
+//
+// Close callbacks are always called from poll(), after every event got dispatched, so it's safe to
+// delete the Socket in there.
+//
+// Not thread safe, except for stop().
+
+class SocketEventLoop {
+public:
+	// Data (or a connection for listening sockets) is available. Read until it would block, or just once,
+	// it's level triggered. If read() returns 0 the peer closed the connection, call close_socket().
+	typedef void (*ReadCallback)(SocketEventLoop *p_loop, Socket *p_socket, void *p_userdata);
+	// The output buffer got empty, or a notify_writable() request fired (e.g. a non blocking connect() finished).
+	typedef void (*WriteCallback)(SocketEventLoop *p_loop, Socket *p_socket, void *p_userdata);
+	// The socket got removed from the loop, and it's already closed.
+	typedef void (*CloseCallback)(SocketEventLoop *p_loop, Socket *p_socket, void *p_userdata);
+	typedef void (*TimerCallback)(SocketEventLoop *p_loop, void *p_userdata);
+
+	// Also makes the socket non blocking. The loop doesn't take ownership of p_socket.
+	Error add_socket(Socket *p_socket, ReadCallback p_read_callback, WriteCallback p_write_callback, CloseCallback p_close_callback, void *p_userdata);
+	// Removes the socket without closing it. Pending output is dropped, no callbacks are called.
+	void remove_socket(Socket *p_socket);
+	bool has_socket(Socket *p_socket) const;
+	_FORCE_INLINE_ int get_socket_count() const { return _entries.size(); }
+
+	// Closes the socket and calls the close callback. With p_flush_output, pending output is sent first.
+	void close_socket(Socket *p_socket, bool p_flush_output = false);
+
+	// Writes as much as possible right away, the rest is buffered. At most UINT32_MAX bytes can be pending.
+	// Returns ERR_CONNECTION_ERROR if the connection is broken. The socket is still in the loop until the next poll(),
+	// that closes it and calls the close callback, so this is safe to call from any callback.
+	Error send(Socket *p_socket, const char *p_data, uint64_t p_len);
+	// Can be used for back pressure.
+	uint64_t get_pending_output_size(Socket *p_socket) const;
+
+	// The write callback is called once, the next time the socket is writable and the output buffer is empty.
+	void notify_writable(Socket *p_socket);
+
+	// Returns an id, that can be used with remove_timer(). Ids are never 0.
+	uint64_t add_timer(uint64_t p_delay_msec, TimerCallback p_callback, void *p_userdata, bool p_repeat = false);
+	void remove_timer(uint64_t p_timer_id);
+	bool has_timer(uint64_t p_timer_id) const;
+
+	// Waits for events at most p_timeout_msec (-1 means until something happens), and dispatches them.
+	void poll(int p_timeout_msec = -1);
+
+	// Calls poll() until stop() is called.
+	void run();
+	// Can be called from any thread. On windows it only takes effect, when the current wait returns.
+	void stop();
+
+	SocketEventLoop();
+	~SocketEventLoop();
+
+protected:
+	struct Entry {
+		Socket *socket;
+		int fd;
+		ReadCallback read_callback;
+		WriteCallback write_callback;
+		CloseCallback close_callback;
+		void *userdata;
+
+		LocalVector<uint8_t> output;
+		uint32_t output_position;
+
+		bool write_registered;
+		bool notify_writable;
+		bool close_after_flush;
+		// A send() failed, it gets removed in the next poll().
+		bool broken;
+		bool removed;
+		// Call the close callback, when it gets freed.
+		bool closed;
+
+#ifndef SOCKET_EVENT_LOOP_EPOLL
+		int poll_index;
+#endif
+
+		Entry() {
+			socket = NULL;
+			fd = 0;
+			read_callback = NULL;
+			write_callback = NULL;
+			close_callback = NULL;
+			userdata = NULL;
+			output_position = 0;
+			write_registered = false;
+			notify_writable = false;
+			close_after_flush = false;
+			broken = false;
+			removed = false;
+			closed = false;
+#ifndef SOCKET_EVENT_LOOP_EPOLL
+			poll_index = -1;
+#endif
+		}
+	};
+
+	struct Timer {
+		TimerCallback callback;
+		void *userdata;
+		uint64_t interval_usec;
+		bool repeat;
+	};
+
+	struct TimerHeapItem {
+		uint64_t due_usec;
+		uint64_t id;
+	};
+
+	// SortArray's heap functions build a max heap, this turns it into a min heap.
+	struct TimerHeapComparator {
+		_FORCE_INLINE_ bool operator()(const TimerHeapItem &p_a, const TimerHeapItem &p_b) const { return p_a.due_usec > p_b.due_usec; }
+	};
+
+	Entry *_get_entry(Socket *p_socket) const;
+
+	void _handle_events(Entry *p_entry, bool p_readable, bool p_writable, bool p_error);
+	void _flush_output(Entry *p_entry);
+	// Returns how much got written, or -1 if the connection is broken.
+	int64_t _write(Entry *p_entry, const uint8_t *p_data, uint64_t p_len);
+	void _update_write_interest(Entry *p_entry);
+
+	// Unregisters the entry. It's freed (and the close callback is called) in _process_removed_entries().
+	void _remove_entry(Entry *p_entry, bool p_close);
+	void _process_removed_entries();
+	void _process_broken_entries();
+
+	void _push_timer(uint64_t p_due_usec, uint64_t p_id);
+	int _get_timer_timeout_msec(int p_timeout_msec) const;
+	void _process_timers();
+
+	bool _backend_add(Entry *p_entry);
+	void _backend_set_write(Entry *p_entry, bool p_enabled);
+	void _backend_remove(Entry *p_entry);
+	void _backend_wait(int p_timeout_msec);
+	void _wake_up();
+
+	HashMap<Socket *, Entry *> _entries;
+	LocalVector<Entry *> _removed_entries;
+	// Sockets, not entries, the entries can be freed before the next poll().
+	LocalVector<Socket *> _broken_sockets;
+
+	HashMap<uint64_t, Timer> _timers;
+	LocalVector<TimerHeapItem> _timer_heap;
+	uint64_t _last_timer_id;
+
+	SafeFlag _exit;
+
+	// Written by stop() to interrupt the wait. Not available on windows.
+	int _wake_up_fds[2];
+
+#ifdef SOCKET_EVENT_LOOP_EPOLL
+	int _epoll_fd;
+#else
+	LocalVector<struct pollfd> _poll_fds;
+	// Same indices as _poll_fds, NULL is the wake up pipe.
+	LocalVector<Entry *> _poll_entries;
+#endif
+};
+
+//--STRIP
+#endif // SOCKET_EVENT_LOOP_H
+//--STRIP
@@ -227,6 +227,8 @@ StringName::StringName(const char *p_name, bool p_static) {
 		}
 	}
 
+	// Entries are shared by every StringName with the same name, they can outlive any arena scope.
+	MemoryHeapScope heap_scope;
 	_data = memnew(_Data);
 	_data->name = p_name;
 	_data->refcount.init();
@@ -295,6 +297,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 		}
 	}
 
+	MemoryHeapScope heap_scope;
 	_data = memnew(_Data);
 
 	_data->refcount.init();
@@ -365,8 +368,10 @@ StringName::StringName(const String &p_name, bool p_static) {
 		}
 	}
 
+	MemoryHeapScope heap_scope;
 	_data = memnew(_Data);
-	_data->name = p_name;
+	// Not a shared copy, p_name's buffer can come from a redirecting arena.
+	_data->name = String(p_name.ptr(), p_name.length());
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
 	_data->hash = hash;
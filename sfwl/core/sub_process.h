@@ -16,18 +16,11 @@
 #include "core/typedefs.h"
 #include "core/ustring.h"
 #include "core/error_list.h"
+#include "core/local_vector.h"
 
 #include <stdio.h>
 //--STRIP
 
-#if defined(_WIN64) || defined(_WIN32)
-
-//--STRIP
-#include "core/local_vector.h"
-//--STRIP
-
-#endif
-
 /**
  * Multi-Platform abstraction for running and communicating with sub processes
  */
@@ -60,16 +53,29 @@ public:
 	bool get_read_std_err() const;
 	void set_read_std_err(const bool p_value);
 
+	// Read stderr into get_error_data(), instead of mixing it into get_data(). Needs read_std_err. Unix only.
+	bool get_separate_std_err() const;
+	void set_separate_std_err(const bool p_value);
+
+	// Open a pipe to the process' stdin, that can be written with send_data(). Non blocking mode only. Unix only.
+	bool get_write_std() const;
+	void set_write_std(const bool p_value);
+
 	bool get_use_pipe_mutex() const;
 	void set_use_pipe_mutex(const bool p_value);
 
 	bool get_open_console() const;
 	void set_open_console(const bool p_value);
 
+	// In non blocking mode these only contain what the last poll() read.
 	String get_data() const {
 		return _pipe;
 	}
 
+	String get_error_data() const {
+		return _pipe_err;
+	}
+
 	int get_process_id() const {
 		return _process_id;
 	}
@@ -79,10 +85,17 @@ public:
 	}
 
 	virtual Error start();
+	// If the output is read, closes the pipes and waits for the process to exit, otherwise it's killed.
 	virtual Error stop();
-	virtual Error poll();
+	// Non blocking mode. Waits at most p_timeout_msec (-1 means until something happens) for output, then reads
+	// everything that's available, and writes pending stdin data.
+	// Returns ERR_FILE_EOF once the process finished, get_data() still has it's last output then.
+	virtual Error poll(int p_timeout_msec = -1);
 	virtual Error send_signal(const int p_signal);
+	// Queued, and written as the process consumes it, see set_write_std().
 	virtual Error send_data(const String &p_data);
+	// Closes stdin once everything sent with send_data() got written, so the process gets an EOF.
+	virtual void close_write_std();
 	virtual bool is_process_running() const;
 
 	Error run(const String &p_executable_path, const Vector<String> &p_arguments = Vector<String>(), bool p_output = true, bool p_blocking = true, bool p_read_std_err = false, bool p_use_pipe_mutex = false, bool p_open_console = false);
@@ -102,8 +115,11 @@ protected:
 
 	bool _read_std;
 	bool _read_std_err;
+	bool _separate_std_err;
+	bool _write_std;
 
 	String _pipe;
+	String _pipe_err;
 
 	bool _use_pipe_mutex;
 
@@ -125,8 +141,19 @@ protected:
 	SubProcessWindowsData *_data;
 
 #else
-	FILE *_process_fp;
-	char _process_buf[65535];
+	// Returns false, when every output pipe got closed.
+	bool _drain_pipes(int p_timeout_msec);
+	void _read_pipe(int p_index);
+	void _flush_std_in();
+	void _append_output(int p_index, const char *p_data, int p_size, bool p_eof);
+	void _close_pipes();
+
+	// Parent side, indexed like the process' fds (stdin, stdout, stderr), -1 when not used.
+	int _pipe_fds[3];
+	// Bytes that are not converted yet, like a utf8 sequence that got split between two reads.
+	LocalVector<char> _pipe_bytes[3];
+	LocalVector<char> _std_in_data;
+	bool _close_std_in;
 #endif
 };
 
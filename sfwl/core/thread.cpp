@@ -71,6 +71,10 @@ Error Thread::set_name(const String &p_name) {
 	return ERR_UNAVAILABLE;
 }
 
+void Thread::yield() {
+	SwitchToThread();
+}
+
 void Thread::start(Thread::Callback p_callback, void *p_user, const Settings &p_settings) {
 	ERR_FAIL_COND_MSG(_handle != NULL, "A Thread cannot be started without wait_to_finish() having been called on it. Please do so to ensure correct cleanup of the thread.");
 
@@ -131,6 +135,8 @@ void Thread::setup_main_thread_id(Thread::ID p_main_thread_id) {
 #include <pthread_np.h>
 #endif
 
+#include <sched.h>
+
 static void _thread_id_key_destr_callback(void *p_value) {
 	memdelete(static_cast<Thread::ID *>(p_value));
 }
@@ -208,6 +214,10 @@ Error Thread::set_name(const String &p_name) {
 #endif // PTHREAD_NO_RENAME
 }
 
+void Thread::yield() {
+	sched_yield();
+}
+
 void Thread::start(Thread::Callback p_callback, void *p_user, const Settings &p_settings) {
 	ERR_FAIL_COND_MSG(_pthread != 0, "A Thread cannot be started without wait_to_finish() having been called on it. Please do so to ensure correct cleanup of the thread.");
 
@@ -61,6 +61,9 @@ public:
 
 	static Error set_name(const String &p_name);
 
+	// Lets the OS run another thread, for short busy waits.
+	static void yield();
+
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings());
 
 	bool is_started() const;
@@ -89,6 +92,8 @@ public:
 
 	static Error set_name(const String &p_name) { return ERR_UNAVAILABLE; }
 
+	static void yield() {}
+
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings()) {}
 	bool is_started() const { return false; }
 	void wait_to_finish() {}
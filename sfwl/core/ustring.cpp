@@ -24,6 +24,23 @@
 #endif
 //--STRIP
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USTRING_SSE2
+#include <emmintrin.h>
+#endif
+
+// Only when the whole build targets AVX2 (-mavx2, /arch:AVX2), the SSE2 path is used otherwise.
+#if defined(__AVX2__)
+#define USTRING_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 #define PRINT_UNICODE_ERRORS 0
 
 #if defined(MINGW_ENABLED) || defined(_MSC_VER)
@@ -2403,16 +2420,13 @@ Vector<float> String::split_floats(const String &p_splitter, bool p_allow_empty)
 	int from = 0;
 	int len = length();
 
-	String buffer = *this;
 	while (true) {
 		int end = find(p_splitter, from);
 		if (end < 0) {
 			end = len;
 		}
 		if (p_allow_empty || (end > from)) {
-			buffer[end] = 0;
-			ret.push_back(String::to_double(&buffer.get_data()[from]));
-			buffer[end] = _cowdata.get(end);
+			ret.push_back(StrRange(&get_data()[from], end - from).to_double());
 		}
 
 		if (end == len) {
@@ -2430,7 +2444,6 @@ Vector<float> String::split_floats_mk(const Vector<String> &p_splitters, bool p_
 	int from = 0;
 	int len = length();
 
-	String buffer = *this;
 	while (true) {
 		int idx;
 		int end = findmk(p_splitters, from, &idx);
@@ -2442,9 +2455,7 @@ Vector<float> String::split_floats_mk(const Vector<String> &p_splitters, bool p_
 		}
 
 		if (p_allow_empty || (end > from)) {
-			buffer[end] = 0;
-			ret.push_back(String::to_double(&buffer.get_data()[from]));
-			buffer[end] = _cowdata.get(end);
+			ret.push_back(StrRange(&get_data()[from], end - from).to_double());
 		}
 
 		if (end == len) {
@@ -2830,6 +2841,175 @@ CharString String::ascii(bool p_allow_extended) const {
 	return cs;
 }
 
+// ASCII fast paths for the UTF-8 conversions.
+// Text is mostly ASCII, so runs of it are checked (and widened / narrowed) in blocks,
+// everything else goes through the byte by byte code.
+
+static _FORCE_INLINE_ int _ustring_ctz(uint32_t p_mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	_BitScanForward(&index, p_mask);
+	return (int)index;
+#else
+	return __builtin_ctz(p_mask);
+#endif
+}
+
+// Returns the length of the run of ASCII bytes at the start of p_utf8, that can be copied as is.
+// NUL and (with p_skip_cr) '\r' end the run, the same as non ASCII bytes.
+// If r_dst is not NULL the run also gets widened into it.
+static int _utf8_ascii_run(const uint8_t *p_utf8, int p_len, bool p_skip_cr, CharType *r_dst) {
+	int i = 0;
+
+#ifdef USTRING_AVX2
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		// Compares against NUL twice if CRs are not skipped.
+		const __m256i cr = _mm256_set1_epi8(p_skip_cr ? '\r' : 0);
+
+		for (; i + 32 <= p_len; i += 32) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(p_utf8 + i));
+			__m256i special = _mm256_or_si256(v, _mm256_or_si256(_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, cr)));
+			uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+
+			if (mask) {
+				int n = _ustring_ctz(mask);
+
+				if (r_dst) {
+					for (int j = 0; j < n; ++j) {
+						r_dst[i + j] = p_utf8[i + j];
+					}
+				}
+
+				return i + n;
+			}
+
+			if (r_dst) {
+				for (int j = 0; j < 32; j += 8) {
+					_mm256_storeu_si256((__m256i *)(r_dst + i + j), _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p_utf8 + i + j))));
+				}
+			}
+		}
+	}
+#endif
+
+#ifdef USTRING_SSE2
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i cr = _mm_set1_epi8(p_skip_cr ? '\r' : 0);
+
+		for (; i + 16 <= p_len; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(p_utf8 + i));
+			__m128i special = _mm_or_si128(v, _mm_or_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(v, cr)));
+			uint32_t mask = (uint32_t)_mm_movemask_epi8(special);
+
+			if (mask) {
+				int n = _ustring_ctz(mask);
+
+				if (r_dst) {
+					for (int j = 0; j < n; ++j) {
+						r_dst[i + j] = p_utf8[i + j];
+					}
+				}
+
+				return i + n;
+			}
+
+			if (r_dst) {
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+				_mm_storeu_si128((__m128i *)(r_dst + i), _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(r_dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(r_dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128((__m128i *)(r_dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+			}
+		}
+	}
+#else
+	// 8 bytes at a time. Only finds whether a block has a byte that ends the run, the rest is done below.
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t highs = 0x8080808080808080ULL;
+	const uint64_t crs = p_skip_cr ? 0x0d0d0d0d0d0d0d0dULL : 0;
+
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t v;
+		memcpy(&v, p_utf8 + i, 8);
+
+		uint64_t c = v ^ crs;
+		// High bits, zero bytes, CRs.
+		if ((v & highs) || ((v - ones) & ~v & highs) || ((c - ones) & ~c & highs)) {
+			break;
+		}
+
+		if (r_dst) {
+			for (int j = 0; j < 8; ++j) {
+				r_dst[i + j] = p_utf8[i + j];
+			}
+		}
+	}
+#endif
+
+	for (; i < p_len; ++i) {
+		uint8_t c = p_utf8[i];
+
+		if (c == 0 || c > 0x7f || (p_skip_cr && c == '\r')) {
+			break;
+		}
+
+		if (r_dst) {
+			r_dst[i] = c;
+		}
+	}
+
+	return i;
+}
+
+// Returns the number of characters at the start of p_str that are ASCII, these are encoded as single bytes.
+// If r_dst is not NULL they also get narrowed into it.
+static int _utf8_ascii_encode_run(const CharType *p_str, int p_len, uint8_t *r_dst) {
+	int i = 0;
+
+#ifdef USTRING_SSE2
+	{
+		const __m128i high = _mm_set1_epi32(~0x7f);
+		const __m128i zero = _mm_setzero_si128();
+
+		for (; i + 16 <= p_len; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i *)(p_str + i));
+			__m128i b = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+			__m128i c = _mm_loadu_si128((const __m128i *)(p_str + i + 8));
+			__m128i d = _mm_loadu_si128((const __m128i *)(p_str + i + 12));
+
+			__m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, high), zero)) != 0xffff) {
+				break;
+			}
+
+			if (r_dst) {
+				// Everything is below 128, so the saturating packs don't change anything.
+				__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+				_mm_storeu_si128((__m128i *)(r_dst + i), bytes);
+			}
+		}
+	}
+#endif
+
+	for (; i < p_len; ++i) {
+		uint32_t c = p_str[i];
+
+		if (c > 0x7f) {
+			break;
+		}
+
+		if (r_dst) {
+			r_dst[i] = c;
+		}
+	}
+
+	return i;
+}
+
 String String::utf8(const char *p_utf8, int p_len) {
 	String ret;
 	ret.parse_utf8(p_utf8, p_len);
@@ -2859,6 +3039,11 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 		}
 	}
 
+	if (p_len < 0) {
+		// The loops below stop at the first NUL anyway, this way the ASCII runs can be checked in blocks.
+		p_len = strlen(p_utf8);
+	}
+
 	bool decode_error = false;
 	bool decode_failed = false;
 	{
@@ -2870,6 +3055,17 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 			uint8_t c = *ptrtmp >= 0 ? *ptrtmp : uint8_t(256 + *ptrtmp);
 
 			if (skip == 0) {
+				if (c < 0x80) {
+					int n = _utf8_ascii_run((const uint8_t *)ptrtmp, ptrtmp_limit - ptrtmp, p_skip_cr, NULL);
+
+					if (n) {
+						ptrtmp += n;
+						cstr_size += n;
+						str_size += n;
+						continue;
+					}
+				}
+
 				if (p_skip_cr && c == '\r') {
 					ptrtmp++;
 					continue;
@@ -2938,6 +3134,18 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 		uint8_t c = *p_utf8 >= 0 ? *p_utf8 : uint8_t(256 + *p_utf8);
 
 		if (skip == 0) {
+			if (c < 0x80) {
+				// No CRs or NULs in the run, so it's all characters.
+				int n = _utf8_ascii_run((const uint8_t *)p_utf8, cstr_size, p_skip_cr, dst);
+
+				if (n) {
+					dst += n;
+					p_utf8 += n;
+					cstr_size -= n;
+					continue;
+				}
+			}
+
 			if (p_skip_cr && c == '\r') {
 				p_utf8++;
 				continue;
@@ -3009,6 +3217,47 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 	}
 }
 
+int String::utf8_encode_char(uint32_t p_char, char *r_dst) {
+	uint8_t *cdst = (uint8_t *)r_dst;
+
+#define APPEND_CHAR(m_c) *(cdst++) = m_c
+
+	if (p_char <= 0x7f) { // 7 bits.
+		APPEND_CHAR(p_char);
+	} else if (p_char <= 0x7ff) { // 11 bits
+		APPEND_CHAR(uint32_t(0xc0 | ((p_char >> 6) & 0x1f))); // Top 5 bits.
+		APPEND_CHAR(uint32_t(0x80 | (p_char & 0x3f))); // Bottom 6 bits.
+	} else if (p_char <= 0xffff) { // 16 bits
+		APPEND_CHAR(uint32_t(0xe0 | ((p_char >> 12) & 0x0f))); // Top 4 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 6) & 0x3f))); // Middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | (p_char & 0x3f))); // Bottom 6 bits.
+	} else if (p_char <= 0x001fffff) { // 21 bits
+		APPEND_CHAR(uint32_t(0xf0 | ((p_char >> 18) & 0x07))); // Top 3 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 12) & 0x3f))); // Upper middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 6) & 0x3f))); // Lower middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | (p_char & 0x3f))); // Bottom 6 bits.
+	} else if (p_char <= 0x03ffffff) { // 26 bits
+		APPEND_CHAR(uint32_t(0xf8 | ((p_char >> 24) & 0x03))); // Top 2 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 18) & 0x3f))); // Upper middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 12) & 0x3f))); // middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 6) & 0x3f))); // Lower middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | (p_char & 0x3f))); // Bottom 6 bits.
+	} else if (p_char <= 0x7fffffff) { // 31 bits
+		APPEND_CHAR(uint32_t(0xfc | ((p_char >> 30) & 0x01))); // Top 1 bit.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 24) & 0x3f))); // Upper upper middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 18) & 0x3f))); // Lower upper middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 12) & 0x3f))); // Upper lower middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | ((p_char >> 6) & 0x3f))); // Lower lower middle 6 bits.
+		APPEND_CHAR(uint32_t(0x80 | (p_char & 0x3f))); // Bottom 6 bits.
+	} else {
+		APPEND_CHAR(0x20);
+	}
+
+#undef APPEND_CHAR
+
+	return cdst - (uint8_t *)r_dst;
+}
+
 CharString String::utf8() const {
 	int l = length();
 	if (!l) {
@@ -3020,7 +3269,10 @@ CharString String::utf8() const {
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
-			fl += 1;
+			// The whole ASCII run, at least 1.
+			int n = _utf8_ascii_encode_run(d + i, l - i, NULL);
+			fl += n;
+			i += n - 1;
 		} else if (c <= 0x7ff) { // 11 bits
 			fl += 2;
 		} else if (c <= 0xffff) { // 16 bits
@@ -3047,43 +3299,17 @@ CharString String::utf8() const {
 	utf8s.resize(fl + 1);
 	uint8_t *cdst = (uint8_t *)utf8s.get_data();
 
-#define APPEND_CHAR(m_c) *(cdst++) = m_c
-
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
-			APPEND_CHAR(c);
-		} else if (c <= 0x7ff) { // 11 bits
-			APPEND_CHAR(uint32_t(0xc0 | ((c >> 6) & 0x1f))); // Top 5 bits.
-			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
-		} else if (c <= 0xffff) { // 16 bits
-			APPEND_CHAR(uint32_t(0xe0 | ((c >> 12) & 0x0f))); // Top 4 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 6) & 0x3f))); // Middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
-		} else if (c <= 0x001fffff) { // 21 bits
-			APPEND_CHAR(uint32_t(0xf0 | ((c >> 18) & 0x07))); // Top 3 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 12) & 0x3f))); // Upper middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 6) & 0x3f))); // Lower middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
-		} else if (c <= 0x03ffffff) { // 26 bits
-			APPEND_CHAR(uint32_t(0xf8 | ((c >> 24) & 0x03))); // Top 2 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 18) & 0x3f))); // Upper middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 12) & 0x3f))); // middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 6) & 0x3f))); // Lower middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
-		} else if (c <= 0x7fffffff) { // 31 bits
-			APPEND_CHAR(uint32_t(0xfc | ((c >> 30) & 0x01))); // Top 1 bit.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 24) & 0x3f))); // Upper upper middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 18) & 0x3f))); // Lower upper middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 12) & 0x3f))); // Upper lower middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | ((c >> 6) & 0x3f))); // Lower lower middle 6 bits.
-			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
+			int n = _utf8_ascii_encode_run(d + i, l - i, cdst);
+			cdst += n;
+			i += n - 1;
 		} else {
-			APPEND_CHAR(0x20);
+			cdst += utf8_encode_char(c, (char *)cdst);
 		}
 	}
-#undef APPEND_CHAR
 	*cdst = 0; //trailing zero
 
 	return utf8s;
@@ -3100,7 +3326,10 @@ int String::utf8_byte_length() const {
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
-			fl += 1;
+			// The whole ASCII run, at least 1.
+			int n = _utf8_ascii_encode_run(d + i, l - i, NULL);
+			fl += n;
+			i += n - 1;
 		} else if (c <= 0x7ff) { // 11 bits
 			fl += 2;
 		} else if (c <= 0xffff) { // 16 bits
@@ -5432,6 +5661,309 @@ String rtoss(double p_val) {
 	return String::num_scientific(p_val);
 }
 
+StrRange StrRange::substr(int p_from, int p_chars) const {
+	if (p_chars == -1) {
+		p_chars = len - p_from;
+	}
+
+	if (len == 0 || p_from < 0 || p_from >= len || p_chars <= 0) {
+		return StrRange();
+	}
+
+	if ((p_from + p_chars) > len) {
+		p_chars = len - p_from;
+	}
+
+	return StrRange(c_str + p_from, p_chars);
+}
+
+StrRange StrRange::strip_edges(bool p_left, bool p_right) const {
+	int beg = 0;
+	int end = len;
+
+	if (p_left) {
+		while (beg < end && c_str[beg] <= 32) {
+			beg++;
+		}
+	}
+
+	if (p_right) {
+		while (end > beg && c_str[end - 1] <= 32) {
+			end--;
+		}
+	}
+
+	return StrRange(c_str + beg, end - beg);
+}
+
+int StrRange::find(const StrRange &p_str, int p_from) const {
+	if (p_from < 0 || p_str.len == 0 || len == 0) {
+		return -1; // won't find anything!
+	}
+
+	const CharType first = p_str.c_str[0];
+
+	for (int i = p_from; i <= len - p_str.len; i++) {
+		if (c_str[i] != first) {
+			continue;
+		}
+
+		int j = 1;
+		while (j < p_str.len && c_str[i + j] == p_str.c_str[j]) {
+			j++;
+		}
+
+		if (j == p_str.len) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int StrRange::find_char(CharType p_char, int p_from) const {
+	if (p_from < 0) {
+		return -1;
+	}
+
+	for (int i = p_from; i < len; i++) {
+		if (c_str[i] == p_char) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int StrRange::rfind_char(CharType p_char, int p_from) const {
+	if (p_from < 0 || p_from >= len) {
+		p_from = len - 1;
+	}
+
+	for (int i = p_from; i >= 0; i--) {
+		if (c_str[i] == p_char) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool StrRange::begins_with(const StrRange &p_str) const {
+	if (p_str.len > len) {
+		return false;
+	}
+
+	for (int i = 0; i < p_str.len; i++) {
+		if (c_str[i] != p_str.c_str[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StrRange::begins_with(const char *p_str) const {
+	if (!p_str) {
+		return true;
+	}
+
+	for (int i = 0; p_str[i]; i++) {
+		if (i >= len || c_str[i] != (uint8_t)p_str[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StrRange::ends_with(const StrRange &p_str) const {
+	if (p_str.len > len) {
+		return false;
+	}
+
+	const CharType *src = c_str + (len - p_str.len);
+
+	for (int i = 0; i < p_str.len; i++) {
+		if (src[i] != p_str.c_str[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StrRange::operator==(const StrRange &p_str) const {
+	if (len != p_str.len) {
+		return false;
+	}
+
+	if (c_str == p_str.c_str) {
+		return true;
+	}
+
+	for (int i = 0; i < len; i++) {
+		if (c_str[i] != p_str.c_str[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StrRange::operator==(const char *p_str) const {
+	if (!p_str) {
+		return len == 0;
+	}
+
+	int i = 0;
+	for (; i < len; i++) {
+		// A shorter p_str ends in a 0, which never matches here.
+		if (c_str[i] != (uint8_t)p_str[i] || p_str[i] == 0) {
+			return false;
+		}
+	}
+
+	return p_str[i] == 0;
+}
+
+bool StrRange::operator<(const StrRange &p_str) const {
+	int l = MIN(len, p_str.len);
+
+	for (int i = 0; i < l; i++) {
+		if (c_str[i] != p_str.c_str[i]) {
+			return c_str[i] < p_str.c_str[i];
+		}
+	}
+
+	return len < p_str.len;
+}
+
+int64_t StrRange::to_int() const {
+	if (len <= 0) {
+		return 0;
+	}
+
+	return String::to_int(c_str, len);
+}
+
+double StrRange::to_double() const {
+	if (len <= 0) {
+		return 0;
+	}
+
+	// The parser needs a null terminator. Numbers are short, so a copy on the stack is usually enough.
+	CharType buf[64];
+
+	if (len < 64) {
+		memcpy(buf, c_str, len * sizeof(CharType));
+		buf[len] = 0;
+
+		return String::to_double(buf);
+	}
+
+	return as_string().to_double();
+}
+
+uint32_t StrRange::hash() const {
+	return String::hash(c_str, len);
+}
+
+String StrRange::as_string() const {
+	return String(*this);
+}
+
+bool StrSplitter::next() {
+	while (_pos >= 0) {
+		int from = _pos;
+		int end;
+
+		if (_delimiter.len == 1) {
+			end = _str.find_char(_delimiter_char, from);
+		} else {
+			end = _str.find(_delimiter, from);
+		}
+
+		if (end < 0) {
+			end = _str.len;
+			_pos = -1;
+		} else {
+			_pos = end + _delimiter.len;
+		}
+
+		if (_allow_empty || end > from) {
+			_field = StrRange(_str.c_str + from, end - from);
+			return true;
+		}
+	}
+
+	_field = StrRange();
+	return false;
+}
+
+StrRange StrSplitter::get_rest() const {
+	if (_pos < 0) {
+		return StrRange(_str.c_str + _str.len, 0);
+	}
+
+	return StrRange(_str.c_str + _pos, _str.len - _pos);
+}
+
+StrSplitter::StrSplitter(const StrRange &p_str, const StrRange &p_delimiter, bool p_allow_empty) {
+	_str = p_str;
+	_delimiter = p_delimiter;
+	_delimiter_char = p_delimiter.len > 0 ? p_delimiter.c_str[0] : 0;
+	_allow_empty = p_allow_empty;
+	_pos = 0;
+}
+
+StrSplitter::StrSplitter(const StrRange &p_str, CharType p_delimiter, bool p_allow_empty) {
+	_str = p_str;
+	// Only the length is used, the character is compared directly.
+	_delimiter = StrRange(nullptr, 1);
+	_delimiter_char = p_delimiter;
+	_allow_empty = p_allow_empty;
+	_pos = 0;
+}
+
+bool StrTokenizer::next() {
+	int i = _pos;
+
+	while (i < _str.len && _is_delimiter(_str.c_str[i])) {
+		i++;
+	}
+
+	if (i >= _str.len) {
+		_pos = _str.len;
+		_token = StrRange();
+		return false;
+	}
+
+	int from = i;
+
+	while (i < _str.len && !_is_delimiter(_str.c_str[i])) {
+		i++;
+	}
+
+	_token = StrRange(_str.c_str + from, i - from);
+	_pos = i;
+
+	return true;
+}
+
+StrTokenizer::StrTokenizer(const StrRange &p_str) {
+	_str = p_str;
+	_split_spaces = true;
+	_pos = 0;
+}
+
+StrTokenizer::StrTokenizer(const StrRange &p_str, const StrRange &p_delimiters) {
+	_str = p_str;
+	_delimiters = p_delimiters;
+	_split_spaces = false;
+	_pos = 0;
+}
+
 #ifdef TOOLS_ENABLED
 String TTR(const String &p_text, const String &p_context) {
 	return p_text;
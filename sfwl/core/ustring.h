@@ -166,14 +166,58 @@ protected:
 
 typedef char32_t CharType;
 
+class String;
+
+// Non owning view of a run of CharTypes, e.g. a part of a String. Nothing is copied, so the viewed data
+// has to outlive it. Not null terminated.
+// Together with StrSplitter and StrTokenizer below it lets parsers work on Strings without allocating.
 struct StrRange {
 	const CharType *c_str;
 	int len;
 
+	_FORCE_INLINE_ int length() const { return len; }
+	_FORCE_INLINE_ bool empty() const { return len == 0; }
+	_FORCE_INLINE_ const CharType &operator[](int p_index) const { return c_str[p_index]; }
+
+	// Clamped to the range, like String::substr().
+	StrRange substr(int p_from, int p_chars = -1) const;
+	// Removes characters below 33, like String::strip_edges().
+	StrRange strip_edges(bool p_left = true, bool p_right = true) const;
+
+	// These return -1 if not found.
+	int find(const StrRange &p_str, int p_from = 0) const;
+	int find_char(CharType p_char, int p_from = 0) const;
+	int rfind_char(CharType p_char, int p_from = -1) const;
+
+	bool begins_with(const StrRange &p_str) const;
+	bool begins_with(const char *p_str) const;
+	bool ends_with(const StrRange &p_str) const;
+
+	bool operator==(const StrRange &p_str) const;
+	bool operator!=(const StrRange &p_str) const { return !(*this == p_str); }
+	// p_str is Latin-1, like String::operator==(const char *).
+	bool operator==(const char *p_str) const;
+	bool operator!=(const char *p_str) const { return !(*this == p_str); }
+	bool operator<(const StrRange &p_str) const;
+
+	// Same as String::to_int(const CharType *, int).
+	int64_t to_int() const;
+	// Same as String::to_double(). Only copies the range if it's very long.
+	double to_double() const;
+
+	// Same as String::hash().
+	uint32_t hash() const;
+
+	String as_string() const;
+
 	StrRange(const CharType *p_c_str = nullptr, int p_len = 0) {
 		c_str = p_c_str;
 		len = p_len;
 	}
+
+	// Views p_str, so it has to outlive the range. Temporaries are rejected at compile time.
+	StrRange(const String &p_str);
+	StrRange(String &&p_str) = delete;
 };
 
 class String {
@@ -452,6 +496,8 @@ public:
 	Error parse_utf8(const char *p_utf8, int p_len = -1, bool p_skip_cr = false); //return true on error
 	static String utf8(const char *p_utf8, int p_len = -1);
 	int utf8_byte_length() const;
+	// Writes the UTF-8 encoding of p_char to r_dst (at most 6 bytes), the same way utf8() does. Returns the byte count.
+	static int utf8_encode_char(uint32_t p_char, char *r_dst);
 
 	Char16String utf16() const;
 	Error parse_utf16(const char16_t *p_utf16, int p_len = -1);
@@ -568,6 +614,80 @@ private:
 	int _count(const String &p_string, int p_from, int p_to, bool p_case_insensitive) const;
 };
 
+_FORCE_INLINE_ StrRange::StrRange(const String &p_str) {
+	c_str = p_str.ptr();
+	len = p_str.length();
+}
+
+// Splits a string lazily, one field at a time, without allocating:
+//
+// StrSplitter s(line, ',');
+// while (s.next()) {
+//     int64_t v = s.get().to_int();
+// }
+//
+// The fields are the same as the elements of String::split(). An empty delimiter doesn't split.
+// The delimiter given as a StrRange has to outlive the splitter.
+class StrSplitter {
+public:
+	// Moves to the next field. Returns false when there are no more.
+	bool next();
+
+	_FORCE_INLINE_ const StrRange &get() const { return _field; }
+	// Everything after the current field's delimiter, like the last element of split() with p_maxsplit.
+	StrRange get_rest() const;
+
+	StrSplitter(const StrRange &p_str, const StrRange &p_delimiter, bool p_allow_empty = true);
+	StrSplitter(const StrRange &p_str, CharType p_delimiter, bool p_allow_empty = true);
+
+protected:
+	StrRange _str;
+	StrRange _delimiter;
+	CharType _delimiter_char;
+	bool _allow_empty;
+
+	StrRange _field;
+	// Start of the next field, -1 once the string is done.
+	int _pos;
+};
+
+// Splits at runs of delimiter characters, so there are no empty tokens.
+// The one argument constructor splits at whitespace (characters below 33), like String::split_spaces().
+// An empty delimiter set doesn't split at all, the whole string is one token.
+class StrTokenizer {
+public:
+	// Moves to the next token. Returns false when there are no more.
+	bool next();
+
+	_FORCE_INLINE_ const StrRange &get() const { return _token; }
+
+	StrTokenizer(const StrRange &p_str);
+	// p_delimiters is a set of characters, it has to outlive the tokenizer.
+	StrTokenizer(const StrRange &p_str, const StrRange &p_delimiters);
+
+protected:
+	_FORCE_INLINE_ bool _is_delimiter(CharType p_char) const {
+		if (_split_spaces) {
+			return p_char < 33;
+		}
+
+		for (int i = 0; i < _delimiters.len; ++i) {
+			if (_delimiters.c_str[i] == p_char) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	StrRange _str;
+	StrRange _delimiters;
+	bool _split_spaces;
+
+	StrRange _token;
+	int _pos;
+};
+
 bool operator==(const char *p_chr, const String &p_str);
 bool operator==(const wchar_t *p_chr, const String &p_str);
 bool operator!=(const char *p_chr, const String &p_str);
@@ -0,0 +1,408 @@
+//--STRIP
+#include "core/utf8_string.h"
+
+#include "core/error_macros.h"
+#include "core/memory.h"
+//--STRIP
+
+int Utf8String::length() const {
+	if (_ascii) {
+		return _size;
+	}
+
+	const char *d = get_data();
+	int l = 0;
+
+	for (int i = 0; i < _size; ++i) {
+		// Every byte except the continuation bytes starts a character.
+		if ((d[i] & 0xC0) != 0x80) {
+			++l;
+		}
+	}
+
+	return l;
+}
+
+String Utf8String::to_string() const {
+	if (_size == 0) {
+		return String();
+	}
+
+	if (!_ascii) {
+		return String::utf8(get_data(), _size);
+	}
+
+	String s;
+	s.resize(_size + 1);
+
+	const uint8_t *src = (const uint8_t *)get_data();
+	CharType *dst = s.ptrw();
+
+	for (int i = 0; i < _size; ++i) {
+		dst[i] = src[i];
+	}
+
+	dst[_size] = 0;
+
+	return s;
+}
+
+void Utf8String::clear() {
+	_unref();
+
+	_size = 0;
+	_ascii = true;
+	_inline[0] = '\0';
+}
+
+void Utf8String::append(const char *p_utf8, int p_len) {
+	if (!p_utf8) {
+		return;
+	}
+
+	if (p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
+
+	if (p_len == 0) {
+		return;
+	}
+
+	const char *d = get_data();
+
+	if (p_utf8 >= d && p_utf8 <= d + _size) {
+		// Appending a part of itself, the source might get reallocated.
+		Utf8String tmp(p_utf8, p_len);
+		append(tmp.get_data(), tmp.size());
+		return;
+	}
+
+	int old_size = _size;
+	char *dst = _resize(old_size + p_len, old_size);
+	ERR_FAIL_COND(!dst);
+
+	memcpy(dst + old_size, p_utf8, p_len);
+
+	_ascii = _ascii && _is_ascii(p_utf8, p_len);
+}
+
+void Utf8String::append(const String &p_str) {
+	int l = p_str.length();
+
+	if (l == 0) {
+		return;
+	}
+
+	int old_size = _size;
+	char *dst = _resize(old_size + p_str.utf8_byte_length(), old_size);
+	ERR_FAIL_COND(!dst);
+
+	dst += old_size;
+
+	const CharType *src = p_str.ptr();
+	bool ascii = true;
+
+	for (int i = 0; i < l; ++i) {
+		uint32_t c = src[i];
+
+		if (c <= 0x7f) {
+			*(dst++) = c;
+		} else {
+			dst += String::utf8_encode_char(c, dst);
+			ascii = false;
+		}
+	}
+
+	_ascii = _ascii && ascii;
+}
+
+Utf8String &Utf8String::operator+=(const Utf8String &p_str) {
+	if (p_str._size == 0) {
+		return *this;
+	}
+
+	if (_size == 0) {
+		*this = p_str;
+		return *this;
+	}
+
+	append(p_str.get_data(), p_str._size);
+	return *this;
+}
+
+Utf8String &Utf8String::operator+=(const char *p_utf8) {
+	append(p_utf8);
+	return *this;
+}
+
+Utf8String &Utf8String::operator+=(const String &p_str) {
+	append(p_str);
+	return *this;
+}
+
+bool Utf8String::operator==(const Utf8String &p_str) const {
+	if (_size != p_str._size) {
+		return false;
+	}
+
+	if (!_is_inline() && _buffer == p_str._buffer) {
+		return true;
+	}
+
+	return memcmp(get_data(), p_str.get_data(), _size) == 0;
+}
+
+bool Utf8String::operator==(const char *p_utf8) const {
+	if (!p_utf8) {
+		return _size == 0;
+	}
+
+	return strcmp(get_data(), p_utf8) == 0;
+}
+
+bool Utf8String::operator==(const String &p_str) const {
+	int l = p_str.length();
+
+	if (_ascii && l != _size) {
+		return false;
+	}
+
+	// A character is at least one byte.
+	if (l > _size) {
+		return false;
+	}
+
+	const CharType *src = p_str.ptr();
+	const char *d = get_data();
+	const char *end = d + _size;
+
+	// Encodes p_str on the fly and compares it with the bytes.
+	for (int i = 0; i < l; ++i) {
+		uint32_t c = src[i];
+
+		if (c <= 0x7f) {
+			if (d == end || *d != (char)c) {
+				return false;
+			}
+
+			++d;
+		} else {
+			char enc[6];
+			int n = String::utf8_encode_char(c, enc);
+
+			if (end - d < n || memcmp(d, enc, n) != 0) {
+				return false;
+			}
+
+			d += n;
+		}
+	}
+
+	return d == end;
+}
+
+bool Utf8String::operator<(const Utf8String &p_str) const {
+	int n = MIN(_size, p_str._size);
+	int c = memcmp(get_data(), p_str.get_data(), n);
+
+	if (c != 0) {
+		return c < 0;
+	}
+
+	return _size < p_str._size;
+}
+
+uint32_t Utf8String::hash() const {
+	return String::hash(get_data(), _size);
+}
+
+void Utf8String::operator=(const Utf8String &p_str) {
+	if (this == &p_str) {
+		return;
+	}
+
+	if (p_str._is_inline()) {
+		_unref();
+		memcpy(_inline, p_str._inline, p_str._size + 1);
+	} else {
+		if (!_is_inline() && _buffer == p_str._buffer) {
+			return;
+		}
+
+		p_str._buffer->refcount.ref();
+		_unref();
+		_buffer = p_str._buffer;
+	}
+
+	_size = p_str._size;
+	_ascii = p_str._ascii;
+}
+
+void Utf8String::operator=(const char *p_utf8) {
+	_set(p_utf8, p_utf8 ? strlen(p_utf8) : 0);
+}
+
+void Utf8String::operator=(const String &p_str) {
+	clear();
+	append(p_str);
+}
+
+Utf8String::Utf8String() {
+	_size = 0;
+	_ascii = true;
+	_inline[0] = '\0';
+}
+
+Utf8String::Utf8String(const Utf8String &p_str) {
+	_size = p_str._size;
+	_ascii = p_str._ascii;
+
+	if (p_str._is_inline()) {
+		memcpy(_inline, p_str._inline, p_str._size + 1);
+	} else {
+		_buffer = p_str._buffer;
+		_buffer->refcount.ref();
+	}
+}
+
+Utf8String::Utf8String(const char *p_utf8) {
+	_size = 0;
+	_ascii = true;
+	_inline[0] = '\0';
+
+	_set(p_utf8, p_utf8 ? strlen(p_utf8) : 0);
+}
+
+Utf8String::Utf8String(const char *p_utf8, int p_len) {
+	_size = 0;
+	_ascii = true;
+	_inline[0] = '\0';
+
+	if (p_utf8 && p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
+
+	_set(p_utf8, p_utf8 ? p_len : 0);
+}
+
+Utf8String::Utf8String(const String &p_str) {
+	_size = 0;
+	_ascii = true;
+	_inline[0] = '\0';
+
+	append(p_str);
+}
+
+Utf8String::~Utf8String() {
+	_unref();
+}
+
+Utf8String::Buffer *Utf8String::_alloc_buffer(int p_capacity) {
+	Buffer *buffer = (Buffer *)memalloc(offsetof(Buffer, data) + p_capacity + 1);
+	ERR_FAIL_COND_V(!buffer, NULL);
+
+	memnew_placement(&buffer->refcount, SafeRefCount);
+	buffer->refcount.init();
+	buffer->capacity = p_capacity;
+
+	return buffer;
+}
+
+void Utf8String::_unref() {
+	if (_is_inline()) {
+		return;
+	}
+
+	if (_buffer->refcount.unref()) {
+		memfree(_buffer);
+	}
+
+	// Back to inline mode.
+	_size = 0;
+	_inline[0] = '\0';
+}
+
+char *Utf8String::_resize(int p_size, int p_keep) {
+	if (p_size <= INLINE_CAPACITY) {
+		if (!_is_inline()) {
+			char tmp[INLINE_CAPACITY + 1];
+			memcpy(tmp, _buffer->data, p_keep);
+			_unref();
+			memcpy(_inline, tmp, p_keep);
+		}
+
+		_size = p_size;
+		_inline[p_size] = '\0';
+
+		return _inline;
+	}
+
+	if (!_is_inline() && _buffer->refcount.get() == 1 && _buffer->capacity >= p_size) {
+		_size = p_size;
+		_buffer->data[p_size] = '\0';
+
+		return _buffer->data;
+	}
+
+	// Growing strings get some room, so appending in a loop isn't quadratic.
+	int capacity = p_keep > 0 ? MAX(p_size, p_keep + (p_keep >> 1)) : p_size;
+
+	Buffer *buffer = _alloc_buffer(capacity);
+	ERR_FAIL_COND_V(!buffer, NULL);
+
+	memcpy(buffer->data, get_data(), p_keep);
+
+	_unref();
+
+	_buffer = buffer;
+	_size = p_size;
+	_buffer->data[p_size] = '\0';
+
+	return _buffer->data;
+}
+
+void Utf8String::_set(const char *p_utf8, int p_len) {
+	if (p_len <= 0) {
+		clear();
+		return;
+	}
+
+	const char *d = get_data();
+
+	if (p_utf8 >= d && p_utf8 <= d + _size) {
+		// A part of itself.
+		Utf8String tmp(p_utf8, p_len);
+		*this = tmp;
+		return;
+	}
+
+	char *dst = _resize(p_len, 0);
+	ERR_FAIL_COND(!dst);
+
+	memcpy(dst, p_utf8, p_len);
+
+	_ascii = _is_ascii(p_utf8, p_len);
+}
+
+bool Utf8String::_is_ascii(const char *p_utf8, int p_len) {
+	const uint8_t *s = (const uint8_t *)p_utf8;
+	int i = 0;
+
+	// 8 bytes at a time.
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t v;
+		memcpy(&v, s + i, 8);
+
+		if (v & 0x8080808080808080ULL) {
+			return false;
+		}
+	}
+
+	for (; i < p_len; ++i) {
+		if (s[i] & 0x80) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,100 @@
+//--STRIP
+#ifndef UTF8_STRING_H
+#define UTF8_STRING_H
+//--STRIP
+
+//--STRIP
+#include "core/safe_refcount.h"
+#include "core/typedefs.h"
+#include "core/ustring.h"
+//--STRIP
+
+// Compact string that stores UTF-8 instead of CharTypes.
+//
+// Strings up to INLINE_CAPACITY bytes are stored inside the object itself, they never allocate.
+// Longer ones live in a shared, reference counted buffer, so copying them doesn't allocate either.
+// Meant for keys, identifiers and I/O, where most strings are short and are never edited character by character.
+// Conversion to String only happens on request (to_string()), comparisons with Strings and C strings don't need it.
+
+class Utf8String {
+public:
+	enum {
+		INLINE_CAPACITY = 23,
+	};
+
+	// Null terminated.
+	_FORCE_INLINE_ const char *get_data() const { return _is_inline() ? _inline : _buffer->data; }
+	_FORCE_INLINE_ const char *ptr() const { return get_data(); }
+	// In bytes.
+	_FORCE_INLINE_ int size() const { return _size; }
+	_FORCE_INLINE_ bool empty() const { return _size == 0; }
+	// True if every character is below 128, so bytes and characters are the same.
+	_FORCE_INLINE_ bool is_ascii() const { return _ascii; }
+	_FORCE_INLINE_ bool is_inline() const { return _is_inline(); }
+
+	// In characters.
+	int length() const;
+
+	String to_string() const;
+
+	void clear();
+
+	void append(const char *p_utf8, int p_len = -1);
+	void append(const String &p_str);
+	Utf8String &operator+=(const Utf8String &p_str);
+	Utf8String &operator+=(const char *p_utf8);
+	Utf8String &operator+=(const String &p_str);
+
+	bool operator==(const Utf8String &p_str) const;
+	bool operator!=(const Utf8String &p_str) const { return !(*this == p_str); }
+	bool operator==(const char *p_utf8) const;
+	bool operator!=(const char *p_utf8) const { return !(*this == p_utf8); }
+	bool operator==(const String &p_str) const;
+	bool operator!=(const String &p_str) const { return !(*this == p_str); }
+	// Byte wise, which is the same as ordering by code points.
+	bool operator<(const Utf8String &p_str) const;
+
+	// Same as String::hash(const char *, int) on the bytes. ASCII strings hash the same as the equivalent String.
+	uint32_t hash() const;
+
+	void operator=(const Utf8String &p_str);
+	void operator=(const char *p_utf8);
+	void operator=(const String &p_str);
+
+	Utf8String();
+	Utf8String(const Utf8String &p_str);
+	Utf8String(const char *p_utf8);
+	Utf8String(const char *p_utf8, int p_len);
+	Utf8String(const String &p_str);
+	~Utf8String();
+
+protected:
+	struct Buffer {
+		SafeRefCount refcount;
+		// In bytes, without the null terminator.
+		int capacity;
+		char data[1];
+	};
+
+	_FORCE_INLINE_ bool _is_inline() const { return _size <= INLINE_CAPACITY; }
+
+	static Buffer *_alloc_buffer(int p_capacity);
+	void _unref();
+	// Makes room for p_size bytes, keeping the first p_keep, and sets the size. The data is unique afterwards.
+	char *_resize(int p_size, int p_keep);
+	void _set(const char *p_utf8, int p_len);
+
+	static bool _is_ascii(const char *p_utf8, int p_len);
+
+	union {
+		char _inline[INLINE_CAPACITY + 1];
+		Buffer *_buffer;
+	};
+
+	int _size;
+	bool _ascii;
+};
+
+//--STRIP
+#endif
+//--STRIP
@@ -0,0 +1,425 @@
+
+//--STRIP
+#include "worker_pool.h"
+
+#include "core/memory.h"
+#include "core/os.h"
+//--STRIP
+
+static thread_local void *_current_worker = NULL;
+
+void WorkerPool::TaskGroup::wait() {
+	while (!is_done()) {
+		if (_pool && _pool->run_pending_task()) {
+			continue;
+		}
+
+		_waiters.increment();
+
+		if (!is_done()) {
+			_semaphore.wait();
+		}
+
+		_waiters.decrement();
+	}
+
+	// Only the few instructions after the last _pending decrement in _task_done() are left.
+	// The poster can't touch the semaphore after that, so this can't be folded into the wait above.
+	while (_busy.get() > 0) {
+		Thread::yield();
+	}
+}
+
+WorkerPool::TaskGroup::TaskGroup() {
+	_pool = NULL;
+}
+
+WorkerPool::TaskGroup::~TaskGroup() {
+	wait();
+}
+
+void WorkerPool::TaskGroup::_task_done() {
+	_busy.increment();
+
+	if (_pending.decrement() == 0) {
+		_mutex.lock();
+		LocalVector<Continuation> continuations = _continuations;
+		_continuations.clear();
+		_mutex.unlock();
+
+		for (uint32_t i = 0; i < continuations.size(); ++i) {
+			const Continuation &c = continuations[i];
+
+			Task task;
+			task.callback = c.callback;
+			task.userdata = c.userdata;
+			task.group = c.group;
+
+			_pool->_push_task(task);
+		}
+
+		uint32_t waiters = _waiters.get();
+
+		for (uint32_t i = 0; i < waiters; ++i) {
+			_semaphore.post();
+		}
+	}
+
+	_busy.decrement();
+}
+
+void WorkerPool::add_task(TaskCallback p_callback, void *p_userdata, TaskGroup *p_group, TaskGroup *p_depends_on) {
+	ERR_FAIL_COND(!p_callback);
+
+	if (p_group) {
+		p_group->_pool = this;
+		p_group->_pending.increment();
+	}
+
+	if (p_depends_on) {
+		p_depends_on->_mutex.lock();
+
+		if (!p_depends_on->is_done()) {
+			TaskGroup::Continuation c;
+			c.callback = p_callback;
+			c.userdata = p_userdata;
+			c.group = p_group;
+
+			p_depends_on->_continuations.push_back(c);
+			p_depends_on->_mutex.unlock();
+			return;
+		}
+
+		p_depends_on->_mutex.unlock();
+	}
+
+	Task task;
+	task.callback = p_callback;
+	task.userdata = p_userdata;
+	task.group = p_group;
+
+	_push_task(task);
+}
+
+void WorkerPool::parallel_for(uint32_t p_begin, uint32_t p_end, RangeCallback p_callback, void *p_userdata, uint32_t p_grain_size) {
+	ERR_FAIL_COND(!p_callback);
+
+	if (p_end <= p_begin) {
+		return;
+	}
+
+	uint32_t count = p_end - p_begin;
+	uint32_t thread_count = _workers.size();
+
+	if (p_grain_size == 0) {
+		// A few chunks per thread, so faster threads can pick up the slack.
+		p_grain_size = MAX(count / ((thread_count + 1) * 4), 1);
+	}
+
+	uint32_t chunk_count = (count + p_grain_size - 1) / p_grain_size;
+
+	if (thread_count == 0 || chunk_count == 1) {
+		p_callback(p_userdata, p_begin, p_end);
+		return;
+	}
+
+	ParallelForData data;
+	data.callback = p_callback;
+	data.userdata = p_userdata;
+	data.begin = p_begin;
+	data.end = p_end;
+	data.grain_size = p_grain_size;
+	data.chunk_count = chunk_count;
+
+	// Every task grabs chunks until none is left, so only one task per helper thread is needed.
+	uint32_t task_count = MIN(chunk_count - 1, thread_count);
+
+	TaskGroup group;
+
+	for (uint32_t i = 0; i < task_count; ++i) {
+		add_task(_parallel_for_task, &data, &group);
+	}
+
+	_parallel_for_task(&data);
+
+	group.wait();
+}
+
+bool WorkerPool::run_pending_task() {
+	Task task;
+
+	if (!_pop_task(task)) {
+		return false;
+	}
+
+	_execute_task(task);
+
+	return true;
+}
+
+int WorkerPool::get_current_worker_index() const {
+	Worker *w = (Worker *)_current_worker;
+
+	if (w && w->pool == this) {
+		return w->index;
+	}
+
+	return -1;
+}
+
+void WorkerPool::start(int p_thread_count) {
+	ERR_FAIL_COND(_workers.size() > 0);
+
+#if !defined(NO_THREADS)
+	if (p_thread_count < 0) {
+		p_thread_count = MAX(OS::get_processor_count() - 1, 1);
+	}
+
+	_exit.clear();
+
+	_workers.resize(p_thread_count);
+
+	// All of them need to exist before any of the threads start stealing.
+	for (int i = 0; i < p_thread_count; ++i) {
+		Worker *w = memnew(Worker);
+		w->pool = this;
+		w->index = i;
+		_workers[i] = w;
+	}
+
+	for (int i = 0; i < p_thread_count; ++i) {
+		_workers[i]->thread.start(_worker_func, _workers[i]);
+	}
+#endif
+}
+
+void WorkerPool::stop() {
+	if (_workers.size() == 0) {
+		return;
+	}
+
+	_exit.set();
+
+	for (uint32_t i = 0; i < _workers.size(); ++i) {
+		_semaphore.post();
+	}
+
+	for (uint32_t i = 0; i < _workers.size(); ++i) {
+		_workers[i]->thread.wait_to_finish();
+	}
+
+	// Finish whatever is left, so nobody waits on a TaskGroup forever.
+	while (run_pending_task()) {
+		;
+	}
+
+	for (uint32_t i = 0; i < _workers.size(); ++i) {
+		memdelete(_workers[i]);
+	}
+
+	_workers.clear();
+}
+
+WorkerPool *WorkerPool::get_singleton() {
+	WorkerPool *pool = _singleton.get();
+
+	if (pool) {
+		return pool;
+	}
+
+	_singleton_mutex.lock();
+
+	pool = _singleton.get();
+
+	if (!pool) {
+		pool = memnew(WorkerPool);
+		pool->start();
+		// Only published after start(), other threads never see a half set up pool.
+		_singleton.set(pool);
+	}
+
+	_singleton_mutex.unlock();
+
+	return pool;
+}
+
+void WorkerPool::cleanup() {
+	_singleton_mutex.lock();
+
+	WorkerPool *pool = _singleton.get();
+
+	if (pool) {
+		_singleton.set(NULL);
+		memdelete(pool);
+	}
+
+	_singleton_mutex.unlock();
+}
+
+WorkerPool::WorkerPool() {
+}
+
+WorkerPool::~WorkerPool() {
+	stop();
+}
+
+void WorkerPool::_push_task(const Task &p_task) {
+	uint32_t worker_count = _workers.size();
+
+	if (worker_count == 0) {
+		_execute_task(p_task);
+		return;
+	}
+
+	Worker *w = (Worker *)_current_worker;
+
+	if (!w || w->pool != this) {
+		w = _workers[_next_worker.postincrement() % worker_count];
+	}
+
+	w->lock.lock();
+
+	// Thieves only move head forward, reclaim the space before it once it becomes significant.
+	if (w->head >= 64 && w->head * 2 >= w->tasks.size()) {
+		uint32_t remaining = w->tasks.size() - w->head;
+
+		for (uint32_t i = 0; i < remaining; ++i) {
+			w->tasks[i] = w->tasks[w->head + i];
+		}
+
+		w->tasks.resize(remaining);
+		w->head = 0;
+	}
+
+	w->tasks.push_back(p_task);
+	w->lock.unlock();
+
+	_queued_count.increment();
+
+	if (_sleeping_count.get() > 0) {
+		_semaphore.post();
+	}
+}
+
+bool WorkerPool::_pop_task(Task &r_task) {
+	uint32_t worker_count = _workers.size();
+
+	if (worker_count == 0) {
+		return false;
+	}
+
+	Worker *self = (Worker *)_current_worker;
+
+	if (self && self->pool != this) {
+		self = NULL;
+	}
+
+	if (self && _pop_task_from(self, true, r_task)) {
+		return true;
+	}
+
+	if (_queued_count.get() == 0) {
+		return false;
+	}
+
+	// Start from the neighbour, so thieves don't all go after the same queue.
+	uint32_t start = self ? self->index + 1 : 0;
+
+	for (uint32_t i = 0; i < worker_count; ++i) {
+		Worker *w = _workers[(start + i) % worker_count];
+
+		if (w == self) {
+			continue;
+		}
+
+		if (_pop_task_from(w, false, r_task)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool WorkerPool::_pop_task_from(Worker *p_worker, bool p_lifo, Task &r_task) {
+	p_worker->lock.lock();
+
+	uint32_t size = p_worker->tasks.size();
+
+	if (size == p_worker->head) {
+		p_worker->lock.unlock();
+		return false;
+	}
+
+	if (p_lifo) {
+		r_task = p_worker->tasks[size - 1];
+		p_worker->tasks.resize(size - 1);
+	} else {
+		r_task = p_worker->tasks[p_worker->head];
+		++p_worker->head;
+	}
+
+	if (p_worker->head == p_worker->tasks.size()) {
+		p_worker->tasks.clear();
+		p_worker->head = 0;
+	}
+
+	p_worker->lock.unlock();
+
+	_queued_count.decrement();
+
+	return true;
+}
+
+void WorkerPool::_execute_task(const Task &p_task) {
+	p_task.callback(p_task.userdata);
+
+	if (p_task.group) {
+		p_task.group->_task_done();
+	}
+}
+
+void WorkerPool::_worker_func(void *p_userdata) {
+	Worker *w = (Worker *)p_userdata;
+	WorkerPool *pool = w->pool;
+
+	_current_worker = w;
+
+	while (!pool->_exit.is_set()) {
+		Task task;
+
+		if (pool->_pop_task(task)) {
+			pool->_execute_task(task);
+			continue;
+		}
+
+		pool->_sleeping_count.increment();
+
+		if (pool->_queued_count.get() == 0 && !pool->_exit.is_set()) {
+			pool->_semaphore.wait();
+		}
+
+		pool->_sleeping_count.decrement();
+	}
+
+	_current_worker = NULL;
+}
+
+void WorkerPool::_parallel_for_task(void *p_userdata) {
+	ParallelForData *data = (ParallelForData *)p_userdata;
+
+	while (true) {
+		uint32_t chunk = data->next_chunk.postincrement();
+
+		if (chunk >= data->chunk_count) {
+			return;
+		}
+
+		uint32_t from = data->begin + chunk * data->grain_size;
+		uint32_t to = MIN(from + data->grain_size, data->end);
+
+		data->callback(data->userdata, from, to);
+	}
+}
+
+SafePointer<WorkerPool *> WorkerPool::_singleton;
+Mutex WorkerPool::_singleton_mutex;
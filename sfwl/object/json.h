@@ -0,0 +1,98 @@
+//--STRIP
+#ifndef JSON_H
+#define JSON_H
+//--STRIP
+
+//--STRIP
+#include "core/error_list.h"
+#include "core/ustring.h"
+#include "object/variant.h"
+//--STRIP
+
+class StringBuilder;
+
+// JSON reader / writer for Variants.
+//
+// Parsing builds the Dictionary / Array tree directly in a single pass, without tokenizing first.
+// Integers without a fraction or exponent become INT Variants, everything else REAL.
+// Numbers are parsed in place without temporary Strings. strtod() is only used for the values that can't be
+// converted exactly the fast way (more than 19 significant digits, or big exponents).
+//
+// parse_lazy() is the on demand mode: it only returns a cursor into the UTF-8 source, and only the values
+// that are actually accessed get parsed. Skipping over the rest doesn't allocate.
+
+class JSON {
+public:
+	enum ValueType {
+		TYPE_INVALID,
+		TYPE_NULL,
+		TYPE_BOOL,
+		TYPE_NUMBER,
+		TYPE_STRING,
+		TYPE_ARRAY,
+		TYPE_OBJECT,
+	};
+
+	// Cursor returned by parse_lazy(). Cheap to copy, it's just pointers into the source.
+	class Value {
+	public:
+		ValueType get_type() const;
+		_FORCE_INLINE_ bool is_valid() const { return _begin != NULL; }
+
+		// Object member. Invalid if it doesn't exist.
+		Value get(const String &p_key) const;
+		_FORCE_INLINE_ bool has(const String &p_key) const { return get(p_key).is_valid(); }
+		// Array element. Invalid if it doesn't exist.
+		Value get_index(int p_index) const;
+		// Walks every element.
+		int size() const;
+
+		// Iterates the elements of an array or the members of an object:
+		// for (JSON::Value v = value.first(); v.is_valid(); v = v.next()) {}
+		Value first() const;
+		Value next() const;
+		// Key of an object member returned by first(), next() or get().
+		String get_key() const;
+
+		// Parses this value and everything in it. Returns NIL on errors.
+		Variant to_variant() const;
+
+		Value() {
+			_begin = NULL;
+			_end = NULL;
+			_key = NULL;
+		}
+
+	protected:
+		friend class JSON;
+
+		Value(const char *p_begin, const char *p_end, const char *p_key) {
+			_begin = p_begin;
+			_end = p_end;
+			_key = p_key;
+		}
+
+		const char *_begin;
+		const char *_end;
+		// Opening quote of the key, for object members.
+		const char *_key;
+	};
+
+	// Everything is on one line if p_indent is empty. Types JSON doesn't have are written as strings.
+	static String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = false);
+	// Appends to r_builder. The output is handed to it in large chunks, so multi MB documents don't end up
+	// as millions of tiny Strings.
+	static Error stringify(const Variant &p_var, StringBuilder &r_builder, const String &p_indent = "", bool p_sort_keys = false);
+
+	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	// Parses UTF-8 directly (e.g. a file's contents), without converting it to a String first.
+	static Error parse_utf8(const char *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+
+	// On demand mode, see above. p_utf8 has to stay valid while the returned Values are used.
+	// Only the parts that get accessed are validated.
+	static Value parse_lazy(const char *p_utf8, int p_len);
+};
+
+//--STRIP
+#endif
+//--STRIP
@@ -148,7 +148,8 @@ ObjectRC *Object::_use_rc() {
 	ObjectRC *const creating = reinterpret_cast<ObjectRC *>(1);
 
 	if (unlikely(_rc.compare_exchange_strong(rc, creating))) {
-		// Not created yet
+		// Not created yet, it lives as long as the Object, so it can't come from an arena
+		MemoryHeapScope heap_scope;
 		rc = memnew(ObjectRC(this));
 		_rc.set(rc);
 		return rc;
@@ -172,68 +173,184 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
-HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+SafePointer<ObjectDB::Slot *> ObjectDB::pages[ObjectDB::MAX_PAGES];
+SpinLock ObjectDB::page_lock;
+SafeNumeric<uint32_t> ObjectDB::slot_count;
+SafeNumeric<uint64_t> ObjectDB::free_list;
+SafeNumeric<uint32_t> ObjectDB::object_count;
+ObjectDB::ValidateShard ObjectDB::validate_shards[ObjectDB::VALIDATE_SHARD_COUNT];
+
+uint32_t ObjectDB::allocate_slot() {
+	uint64_t head = free_list.get();
+
+	while ((head & 0xFFFFFFFF) != 0) {
+		uint32_t slot_index = (head & 0xFFFFFFFF) - 1;
+		uint64_t next = get_slot(slot_index)->next_free.get();
+		uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+
+		if (free_list.compare_exchange_weak(head, new_head)) {
+			return slot_index;
+		}
+	}
+
+	// Nothing to reuse, take a new one
+	uint32_t slot_index = slot_count.postincrement();
+
+	if (unlikely(slot_index >= MAX_SLOTS)) {
+		// Only failed allocations get here, so the count never goes back below MAX_SLOTS
+		slot_count.decrement();
+		ERR_FAIL_V_MSG(MAX_SLOTS, "ObjectDB is full!");
+	}
+
+	uint32_t page_index = slot_index >> PAGE_BITS;
+
+	if (unlikely(!pages[page_index].get())) {
+		page_lock.lock();
+
+		if (!pages[page_index].get()) {
+			// Pages are never freed
+			MemoryHeapScope heap_scope;
+			Slot *page = memnew_arr(Slot, PAGE_SIZE);
+
+			for (uint32_t i = 0; i < PAGE_SIZE; ++i) {
+				page[i].generation = 0;
+			}
+
+			pages[page_index].set(page);
+		}
+
+		page_lock.unlock();
+	}
+
+	return slot_index;
+}
+
+void ObjectDB::free_slot(uint32_t p_slot) {
+	Slot *slot = get_slot(p_slot);
+	uint64_t head = free_list.get();
+
+	while (true) {
+		slot->next_free.set(head & 0xFFFFFFFF);
+		uint64_t new_head = (((head >> 32) + 1) << 32) | (p_slot + 1);
+
+		if (free_list.compare_exchange_weak(head, new_head)) {
+			return;
+		}
+	}
+}
+
 ObjectID ObjectDB::add_instance(Object *p_object) {
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
-	rw_lock.write_lock();
-	ObjectID instance_id = ++instance_counter;
-	instances[instance_id] = p_object;
-	instance_checks[p_object] = instance_id;
+	uint32_t slot_index = allocate_slot();
 
-	rw_lock.write_unlock();
+	// The object stays usable, but it won't have a valid id
+	if (unlikely(slot_index >= MAX_SLOTS)) {
+		return 0;
+	}
 
-	return instance_id;
-}
+	Slot *slot = get_slot(slot_index);
 
-void ObjectDB::remove_instance(Object *p_object) {
-	rw_lock.write_lock();
+	// Validators need to fit into the upper bits of an ObjectID, and 0 is reserved for free slots
+	slot->generation = (slot->generation + 1) & (UINT64_MAX >> SLOT_BITS);
+	if (slot->generation == 0) {
+		slot->generation = 1;
+	}
 
-	instances.erase(p_object->get_instance_id());
-	instance_checks.erase(p_object);
+	slot->object.set(p_object);
+	slot->validator.set(slot->generation);
 
-	rw_lock.write_unlock();
+	ValidateShard &shard = get_validate_shard(p_object);
+	shard.lock.lock();
+	{
+		// The set can outlive any arena scope
+		MemoryHeapScope heap_scope;
+		shard.objects.insert(p_object);
+	}
+	shard.lock.unlock();
+
+	object_count.increment();
+
+	return (slot->generation << SLOT_BITS) | slot_index;
 }
-Object *ObjectDB::get_instance(ObjectID p_instance_id) {
-	rw_lock.read_lock();
-	Object **obj = instances.getptr(p_instance_id);
-	rw_lock.read_unlock();
 
-	if (!obj) {
-		return nullptr;
+void ObjectDB::remove_instance(Object *p_object) {
+	ObjectID id = p_object->get_instance_id();
+
+	if (id == 0) {
+		return;
 	}
-	return *obj;
+
+	uint32_t slot_index = id & SLOT_MASK;
+	Slot *slot = get_slot(slot_index);
+
+	ERR_FAIL_COND(!slot || slot->validator.get() != (id >> SLOT_BITS));
+
+	slot->validator.set(0);
+	slot->object.set(nullptr);
+
+	ValidateShard &shard = get_validate_shard(p_object);
+	shard.lock.lock();
+	shard.objects.erase(p_object);
+	shard.lock.unlock();
+
+	object_count.decrement();
+
+	free_slot(slot_index);
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
-	rw_lock.read_lock();
+	uint32_t count = MIN(slot_count.get(), (uint32_t)MAX_SLOTS);
 
-	const ObjectID *K = nullptr;
-	while ((K = instances.next(K))) {
-		p_func(instances[*K]);
-	}
+	for (uint32_t i = 0; i < count; ++i) {
+		Slot *slot = get_slot(i);
+
+		if (slot && slot->validator.get() != 0) {
+			Object *obj = slot->object.get();
 
-	rw_lock.read_unlock();
+			if (obj) {
+				p_func(obj);
+			}
+		}
+	}
 }
 
 int ObjectDB::get_object_count() {
-	rw_lock.read_lock();
-	int count = instances.size();
-	rw_lock.read_unlock();
-
-	return count;
+	return object_count.get();
 }
 
-RWLock ObjectDB::rw_lock;
+bool ObjectDB::instance_validate(Object *p_ptr) {
+	if (!p_ptr) {
+		return false;
+	}
+
+	ValidateShard &shard = get_validate_shard(p_ptr);
+	shard.lock.lock();
+	bool exists = shard.objects.has(p_ptr);
+	shard.lock.unlock();
+
+	return exists;
+}
 
 void ObjectDB::cleanup() {
-	rw_lock.write_lock();
-	if (instances.size()) {
+	if (object_count.get()) {
 		LOG_WARN("ObjectDB instances leaked at exit!");
 	}
-	instances.clear();
-	instance_checks.clear();
-	rw_lock.write_unlock();
+
+	for (uint32_t i = 0; i < MAX_PAGES; ++i) {
+		Slot *page = pages[i].get();
+
+		if (page) {
+			memdelete_arr(page);
+			pages[i].set(nullptr);
+		}
+	}
+
+	for (uint32_t i = 0; i < VALIDATE_SHARD_COUNT; ++i) {
+		validate_shards[i].objects.reset();
+	}
+
+	slot_count.set(0);
+	free_list.set(0);
+	object_count.set(0);
 }
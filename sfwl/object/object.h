@@ -5,7 +5,9 @@
 
 //--STRIP
 #include "core/hash_map.h"
-#include "core/rw_lock.h"
+#include "core/hash_set.h"
+#include "core/safe_refcount.h"
+#include "core/spin_lock.h"
 #include "core/string_name.h"
 #include "core/ustring.h"
 #include "core/vector.h"
@@ -239,25 +241,65 @@ bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
 class ObjectDB {
-	struct ObjectPtrHash {
-		static _FORCE_INLINE_ uint32_t hash(const Object *p_obj) {
-			union {
-				const Object *p;
-				unsigned long i;
-			} u;
-			u.p = p_obj;
-			return HashMapHasherDefault::hash((uint64_t)u.i);
-		}
+	// Instances are stored in a paged slot table, and ObjectIDs are (validator << SLOT_BITS) | slot.
+	// Every slot has its own validator that changes every time the slot is reused, so old ids of deleted
+	// objects don't resolve to new ones. Lookups are lock free, slots are recycled through a lock free free list.
+	// Pages are never moved or freed while running, so readers never race with growing the table.
+	enum {
+		SLOT_BITS = 24,
+		SLOT_MASK = (1 << SLOT_BITS) - 1,
+		PAGE_BITS = 12,
+		PAGE_SIZE = 1 << PAGE_BITS,
+		PAGE_MASK = PAGE_SIZE - 1,
+		MAX_PAGES = 1 << (SLOT_BITS - PAGE_BITS),
+		MAX_SLOTS = 1 << SLOT_BITS,
+	};
+
+	struct Slot {
+		// 0 when the slot is free
+		SafeNumeric<uint64_t> validator;
+		SafePointer<Object *> object;
+		// Only touched by the thread that owns the slot
+		uint64_t generation;
+		SafeNumeric<uint32_t> next_free;
+	};
+
+	static SafePointer<Slot *> pages[MAX_PAGES];
+	static SpinLock page_lock;
+	static SafeNumeric<uint32_t> slot_count;
+	// (tag << 32) | (slot + 1), the tag prevents ABA problems
+	static SafeNumeric<uint64_t> free_list;
+	static SafeNumeric<uint32_t> object_count;
+
+	// Live objects by address, only for instance_validate(). Split by the pointer's hash, so threads that
+	// create and delete objects at the same time rarely wait for each other.
+	enum {
+		VALIDATE_SHARD_COUNT = 64,
+	};
+
+	struct ValidateShard {
+		SpinLock lock;
+		HashSet<Object *> objects;
 	};
 
-	static HashMap<ObjectID, Object *> instances;
-	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
+	static ValidateShard validate_shards[VALIDATE_SHARD_COUNT];
+
+	_FORCE_INLINE_ static ValidateShard &get_validate_shard(Object *p_object) {
+		return validate_shards[HashMapHasherDefault::hash(p_object) & (VALIDATE_SHARD_COUNT - 1)];
+	}
+
+	_FORCE_INLINE_ static Slot *get_slot(uint32_t p_slot) {
+		Slot *page = pages[p_slot >> PAGE_BITS].get();
+		return page ? &page[p_slot & PAGE_MASK] : nullptr;
+	}
+
+	// Returns MAX_SLOTS if the table is full
+	static uint32_t allocate_slot();
+	static void free_slot(uint32_t p_slot);
 
-	static ObjectID instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
-	static RWLock rw_lock;
 	static void cleanup();
 	static ObjectID add_instance(Object *p_object);
 	static void remove_instance(Object *p_object);
@@ -266,20 +308,35 @@ class ObjectDB {
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(ObjectID p_instance_id);
-	static void debug_objects(DebugFunc p_func);
-	static int get_object_count();
+	_FORCE_INLINE_ static Object *get_instance(ObjectID p_instance_id) {
+		uint32_t slot_index = p_instance_id & SLOT_MASK;
+		uint64_t validator = p_instance_id >> SLOT_BITS;
 
-	// This one may give false positives because a new object may be allocated at the same memory of a previously freed one
-	_FORCE_INLINE_ static bool instance_validate(Object *p_ptr) {
-		rw_lock.read_lock();
+		Slot *slot = get_slot(slot_index);
+
+		if (unlikely(!slot || validator == 0)) {
+			return nullptr;
+		}
+
+		if (slot->validator.get() != validator) {
+			return nullptr;
+		}
 
-		bool exists = instance_checks.has(p_ptr);
+		Object *obj = slot->object.get();
 
-		rw_lock.read_unlock();
+		// Check again, in case the slot got freed (and maybe reused) in the meantime
+		if (slot->validator.get() != validator) {
+			return nullptr;
+		}
 
-		return exists;
+		return obj;
 	}
+
+	static void debug_objects(DebugFunc p_func);
+	static int get_object_count();
+
+	// This one may give false positives because a new object may be allocated at the same memory of a previously freed one
+	static bool instance_validate(Object *p_ptr);
 };
 
 //--STRIP
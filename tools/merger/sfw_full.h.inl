@@ -106,6 +106,14 @@
 //--STRIP
 {{FILE:sfw/core/memory.h}}
 
+//--STRIP
+//#include "core/memory.h"
+//#include "core/typedefs.h"
+//
+//#include <stddef.h>
+//--STRIP
+{{FILE:sfw/core/memory_arena.h}}
+
 //--STRIP
 //#include "core/error_list.h"
 //#include "core/typedefs.h"
@@ -259,6 +267,21 @@
 //--STRIP
 {{FILE:sfw/core/ustring.h}}
 
+//--STRIP
+//#include "core/safe_refcount.h"
+//#include "core/typedefs.h"
+//#include "core/ustring.h"
+//--STRIP
+{{FILE:sfw/core/utf8_string.h}}
+
+//--STRIP
+//#include "core/safe_refcount.h"
+//#include "core/typedefs.h"
+//#include "core/ustring.h"
+//#include "core/vector.h"
+//--STRIP
+{{FILE:sfw/core/memory_profiler.h}}
+
 //--STRIP
 //#include "core/mutex.h"
 //#include "core/safe_refcount.h"
@@ -428,6 +451,7 @@
 //#include "core/vector4i.h"
 //#include "core/string_name.h"
 //#include "core/ustring.h"
+//#include "core/utf8_string.h"
 //#include "core/typedefs.h"
 //--STRIP
 {{FILE:sfw/core/hashfuncs.h}}
@@ -473,6 +497,20 @@
 //--STRIP
 {{FILE:sfw/core/hash_set.h}}
 
+//--STRIP
+//#include "core/error_macros.h"
+//#include "core/hashfuncs.h"
+//#include "core/memory.h"
+//#include "core/pair.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfw/core/flat_hash_map.h}}
+
+//--STRIP
+//#include "core/flat_hash_map.h"
+//--STRIP
+{{FILE:sfw/core/flat_hash_set.h}}
+
 //--STRIP
 //#include "core/ustring.h"
 //--STRIP
@@ -491,6 +529,11 @@
 //--STRIP
 {{FILE:sfw/core/file_access.h}}
 
+//--STRIP
+//#include "core/file_access.h"
+//--STRIP
+{{FILE:sfw/core/file_access_mapped.h}}
+
 //--STRIP
 //#include "core/error_list.h"
 //#include "core/ustring.h"
@@ -508,6 +551,17 @@
 //--STRIP
 {{FILE:sfw/core/socket.h}}
 
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/hash_map.h"
+//#include "core/int_types.h"
+//#include "core/local_vector.h"
+//#include "core/safe_refcount.h"
+//#include "core/socket.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfw/core/socket_event_loop.h}}
+
 //--STRIP
 //no includes
 //--STRIP
@@ -515,17 +569,28 @@
 
 //--STRIP
 //#include "core/list.h"
+//#include "core/local_vector.h"
 //#include "core/math_defs.h"
 //#include "core/memory.h"
 //#include "core/mutex.h"
 //#include "core/typedefs.h"
 //#include "core/ustring.h"
 //#include <stdio.h>
-//Win Only
-//#include "core/local_vector.h"
 //--STRIP
 {{FILE:sfw/core/sub_process.h}}
 
+//--STRIP
+//#include "core/int_types.h"
+//#include "core/local_vector.h"
+//#include "core/mutex.h"
+//#include "core/safe_refcount.h"
+//#include "core/semaphore.h"
+//#include "core/spin_lock.h"
+//#include "core/thread.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfw/core/worker_pool.h}}
+
 //--STRIP
 //no includes
 //--STRIP
@@ -590,6 +655,20 @@
 //--STRIP
 {{FILE:sfw/object/variant.h}}
 
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/marshalls.h"
+//#include "object/variant.h"
+//--STRIP
+{{FILE:sfw/object/variant_marshalls.h}}
+
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/ustring.h"
+//#include "object/variant.h"
+//--STRIP
+{{FILE:sfw/object/json.h}}
+
 //--STRIP
 //Stuff that needs Variant
 //--STRIP
@@ -604,7 +683,8 @@
 
 //--STRIP
 //#include "core/hash_map.h"
-//#include "core/rw_lock.h"
+//#include "core/safe_refcount.h"
+//#include "core/spin_lock.h"
 //#include "core/string_name.h"
 //#include "core/ustring.h"
 //#include "core/vector.h"
@@ -672,6 +752,15 @@
 //--STRIP
 {{FILE:sfw/render_core/texture.h}}
 
+//--STRIP
+//#include "core/safe_refcount.h"
+//#include "core/vector.h"
+//#include "core/worker_pool.h"
+//#include "render_core/image.h"
+//#include "render_core/texture.h"
+//--STRIP
+{{FILE:sfw/render_core/texture_streamer.h}}
+
 
 //--STRIP
 //#include "core/vector.h"
@@ -793,6 +882,15 @@
 //--STRIP
 {{FILE:sfw/render_core/font.h}}
 
+//--STRIP
+//#include "core/color.h"
+//#include "core/local_vector.h"
+//#include "core/ustring.h"
+//#include "core/vector2.h"
+//#include "object/reference.h"
+//--STRIP
+{{FILE:sfw/render_core/text_layout.h}}
+
 
 //--STRIP
 //#include "object/reference.h"
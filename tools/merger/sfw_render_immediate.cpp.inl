@@ -245,6 +245,27 @@
 //#include "core/safe_refcount.h"
 //--STRIP
 {{FILE:sfw/core/memory.cpp}}
+
+//--STRIP
+//#include "core/memory_arena.h"
+//
+//#include "core/error_macros.h"
+//
+//#include <string.h>
+//--STRIP
+{{FILE:sfw/core/memory_arena.cpp}}
+
+//--STRIP
+//#include "core/memory_profiler.h"
+//
+//#include "core/logger.h"
+//#include "core/mutex.h"
+//#include "core/sfw_time.h"
+//
+//#include <stdlib.h>
+//#include <string.h>
+//--STRIP
+{{FILE:sfw/core/memory_profiler.cpp}}
 //--STRIP
 //{//{//FILE:sfw/core/old/directory.cpp}}
 //--STRIP
@@ -303,6 +324,13 @@
 //--STRIP
 {{FILE:sfw/core/math_funcs.cpp}}
 
+//--STRIP
+//#include "core/hashfuncs.h"
+//
+//#include "core/error_macros.h"
+//--STRIP
+{{FILE:sfw/core/hashfuncs.cpp}}
+
 //--STRIP
 //#include "core/ustring.h"
 //#include "core/color.h"
@@ -312,6 +340,14 @@
 //--STRIP
 {{FILE:sfw/core/ustring.cpp}}
 
+//--STRIP
+//#include "core/utf8_string.h"
+//
+//#include "core/error_macros.h"
+//#include "core/memory.h"
+//--STRIP
+{{FILE:sfw/core/utf8_string.cpp}}
+
 //--STRIP
 //#include "thread.h"
 //#include "core/error_macros.h"
@@ -441,9 +477,24 @@
 
 //--STRIP
 //#include "file_access.h"
+//#include "core/file_access_mapped.h"
 //--STRIP
 {{FILE:sfw/core/file_access.cpp}}
 
+//--STRIP
+//#include "core/error_macros.h"
+//Windows:
+//#include <windows.h>
+//Linux
+//#include <errno.h>
+//#include <fcntl.h>
+//#include <sys/mman.h>
+//#include <sys/stat.h>
+//#include <sys/types.h>
+//#include <unistd.h>
+//--STRIP
+{{FILE:sfw/core/file_access_mapped.cpp}}
+
 //--STRIP
 //#include "dir_access.h"
 //#include "3rd_tinydir.h"
@@ -456,10 +507,19 @@
 {{FILE:sfw/core/inet_address.cpp}}
 //--STRIP
 //#include "core/error_macros.h"
+//#include "core/file_access.h"
 //#include "core/ustring.h"
 //--STRIP
 {{FILE:sfw/core/socket.cpp}}
 
+//--STRIP
+//#include "core/error_macros.h"
+//#include "core/memory.h"
+//#include "core/sfw_time.h"
+//#include "core/sort_array.h"
+//--STRIP
+{{FILE:sfw/core/socket_event_loop.cpp}}
+
 //--STRIP
 //Windows:
 //#include <windows.h>
@@ -481,9 +541,16 @@
 //--STRIP
 {{FILE:sfw/core/sub_process.cpp}}
 
+//--STRIP
+//#include "core/memory.h"
+//#include "core/os.h"
+//--STRIP
+{{FILE:sfw/core/worker_pool.cpp}}
+
 //--STRIP
 //#include "core/pool_vector.h"
 //#include "core/string_name.h"
+//#include "core/worker_pool.h"
 //--STRIP
 {{FILE:sfw/core/sfw_core.cpp}}
 
@@ -545,6 +612,30 @@
 //#include "object/resource.h"
 //--STRIP
 {{FILE:sfw/object/variant.cpp}}
+
+//--STRIP
+//#include "variant_marshalls.h"
+//
+//#include "core/error_macros.h"
+//#include "core/ustring.h"
+//
+//#include "object/object.h"
+//--STRIP
+{{FILE:sfw/object/variant_marshalls.cpp}}
+
+//--STRIP
+//#include "json.h"
+//
+//#include "core/error_macros.h"
+//#include "core/list.h"
+//#include "core/local_vector.h"
+//#include "core/math_funcs.h"
+//#include "core/string_builder.h"
+//
+//#include "object/array.h"
+//#include "object/dictionary.h"
+//--STRIP
+{{FILE:sfw/object/json.cpp}}
 //--STRIP
 //#include "variant.h"
 //#include "object/core_string_names.h"
@@ -572,12 +663,20 @@
 //--STRIP
 {{FILE:sfw/render_core/texture.cpp}}
 
+//--STRIP
+//#include "render_core/texture_streamer.h"
+//#include "core/memory.h"
+//#include "render_core/3rd_glad.h"
+//--STRIP
+{{FILE:sfw/render_core/texture_streamer.cpp}}
+
 //--STRIP
 //#include "render_core/application.h"
 //#include "core/math_defs.h"
 //#include "core/sfw_time.h"
 //#include "render_core/input.h"
 //#include "render_core/input_map.h"
+//#include "render_core/texture_streamer.h"
 //#include "render_core/app_window.h"
 //#include "core/pool_vector.h"
 //#include "core/string_name.h"
@@ -603,6 +702,8 @@
 //--STRIP
 //#include "font.h"
 //#include "app_window.h"
+//#include "core/file_access_mapped.h"
+//#include "core/flat_hash_map.h"
 //#include "3rd_glad.h"
 //#include "3rd_stb_truetype.h"
 //#include "font_data_bm_mini.inc.h"
@@ -612,6 +713,13 @@
 //#include "render_core/texture.h"
 //--STRIP
 {{FILE:sfw/render_core/font.cpp}}
+
+//--STRIP
+//#include "render_core/text_layout.h"
+//#include "render_core/font.h"
+//#include "render_core/mesh.h"
+//--STRIP
+{{FILE:sfw/render_core/text_layout.cpp}}
 //--STRIP
 //#include "render_core/render_state.h"
 //--STRIP
@@ -676,6 +784,7 @@
 //#include "core/vector3.h"
 //#include "3rd_stb_image.h"
 //#include "3rd_stb_image_write.h"
+//#include "core/file_access_mapped.h"
 //--STRIP
 {{FILE:sfw/render_core/image.cpp}}
 //--STRIP
@@ -728,6 +837,7 @@
 //#include "render_core/material.h"
 //#include "render_core/mesh.h"
 //#include "render_core/texture.h"
+//#include "render_core/text_layout.h"
 //#include "render_core/texture_material_2d.h"
 //#include "render_core/app_window.h"
 //#include "render_core/render_state.h"
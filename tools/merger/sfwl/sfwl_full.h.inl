@@ -106,6 +106,14 @@
 //--STRIP
 {{FILE:sfwl/core/memory.h}}
 
+//--STRIP
+//#include "core/memory.h"
+//#include "core/typedefs.h"
+//
+//#include <stddef.h>
+//--STRIP
+{{FILE:sfwl/core/memory_arena.h}}
+
 
 //--STRIP
 //#include "core/error_list.h"
@@ -260,6 +268,21 @@
 //--STRIP
 {{FILE:sfwl/core/ustring.h}}
 
+//--STRIP
+//#include "core/safe_refcount.h"
+//#include "core/typedefs.h"
+//#include "core/ustring.h"
+//--STRIP
+{{FILE:sfwl/core/utf8_string.h}}
+
+//--STRIP
+//#include "core/safe_refcount.h"
+//#include "core/typedefs.h"
+//#include "core/ustring.h"
+//#include "core/vector.h"
+//--STRIP
+{{FILE:sfwl/core/memory_profiler.h}}
+
 //--STRIP
 //#include "core/mutex.h"
 //#include "core/safe_refcount.h"
@@ -342,6 +365,7 @@
 //#include "core/vector4i.h"
 //#include "core/string_name.h"
 //#include "core/ustring.h"
+//#include "core/utf8_string.h"
 //#include "core/typedefs.h"
 //--STRIP
 {{FILE:sfwl/core/hashfuncs.h}}
@@ -387,6 +411,20 @@
 //--STRIP
 {{FILE:sfwl/core/hash_set.h}}
 
+//--STRIP
+//#include "core/error_macros.h"
+//#include "core/hashfuncs.h"
+//#include "core/memory.h"
+//#include "core/pair.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfwl/core/flat_hash_map.h}}
+
+//--STRIP
+//#include "core/flat_hash_map.h"
+//--STRIP
+{{FILE:sfwl/core/flat_hash_set.h}}
+
 //--STRIP
 //#include "core/ustring.h"
 //--STRIP
@@ -405,6 +443,11 @@
 //--STRIP
 {{FILE:sfwl/core/file_access.h}}
 
+//--STRIP
+//#include "core/file_access.h"
+//--STRIP
+{{FILE:sfwl/core/file_access_mapped.h}}
+
 //--STRIP
 //#include "core/error_list.h"
 //#include "core/ustring.h"
@@ -421,6 +464,17 @@
 //--STRIP
 {{FILE:sfwl/core/socket.h}}
 
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/hash_map.h"
+//#include "core/int_types.h"
+//#include "core/local_vector.h"
+//#include "core/safe_refcount.h"
+//#include "core/socket.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfwl/core/socket_event_loop.h}}
+
 //--STRIP
 //no includes
 //--STRIP
@@ -428,17 +482,28 @@
 
 //--STRIP
 //#include "core/list.h"
+//#include "core/local_vector.h"
 //#include "core/math_defs.h"
 //#include "core/memory.h"
 //#include "core/mutex.h"
 //#include "core/typedefs.h"
 //#include "core/ustring.h"
 //#include <stdio.h>
-//Win Only
-//#include "core/local_vector.h"
 //--STRIP
 {{FILE:sfwl/core/sub_process.h}}
 
+//--STRIP
+//#include "core/int_types.h"
+//#include "core/local_vector.h"
+//#include "core/mutex.h"
+//#include "core/safe_refcount.h"
+//#include "core/semaphore.h"
+//#include "core/spin_lock.h"
+//#include "core/thread.h"
+//#include "core/typedefs.h"
+//--STRIP
+{{FILE:sfwl/core/worker_pool.h}}
+
 //--STRIP
 //no includes
 //--STRIP
@@ -503,6 +568,20 @@
 //--STRIP
 {{FILE:sfwl/object/variant.h}}
 
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/marshalls.h"
+//#include "object/variant.h"
+//--STRIP
+{{FILE:sfwl/object/variant_marshalls.h}}
+
+//--STRIP
+//#include "core/error_list.h"
+//#include "core/ustring.h"
+//#include "object/variant.h"
+//--STRIP
+{{FILE:sfwl/object/json.h}}
+
 //--STRIP
 //Stuff that needs Variant
 //--STRIP
@@ -517,7 +596,8 @@
 
 //--STRIP
 //#include "core/hash_map.h"
-//#include "core/rw_lock.h"
+//#include "core/safe_refcount.h"
+//#include "core/spin_lock.h"
 //#include "core/string_name.h"
 //#include "core/ustring.h"
 //#include "core/vector.h"